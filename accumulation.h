@@ -0,0 +1,245 @@
+/*!
+ * \file        accumulation.h
+ * \brief       Summation policies for cash flow streams.
+ * \details     Header-only naive, Neumaier compensated and pairwise
+ * accumulators, used as the accumulation policy of the `pv_stream()`
+ * templates.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_ACCUMULATION_H
+#define PG_FINANCIAL_ACCUMULATION_H
+
+#include <cmath>
+#include <cstddef>
+#include <stdint.h>
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Naive summation policy.
+
+/*!
+ * Adds each value to a single running total. The error of a sum of `n`
+ * values may grow in proportion to `n` times the sum of their
+ * magnitudes, but each addition costs only a single floating point
+ * operation.
+ *
+ * As the accumulation policy of `pv_stream()`, the cash flows are
+ * summed by the vectorized kernels in several interleaved partial sums,
+ * exactly as by the overloads without a policy.
+ */
+
+class NaiveSum {
+    public:
+
+        //! Constructor
+
+        NaiveSum() : m_sum(0) {}
+
+
+        //! Adds a value.
+
+        void add(const double value) {
+            m_sum += value;
+        }
+
+
+        //! Adds an array of values, in order.
+
+        void add(const double * values, const std::size_t count) {
+            for ( std::size_t i = 0; i < count; ++i ) {
+                m_sum += values[i];
+            }
+        }
+
+
+        //! Returns the sum of the values added.
+
+        double result() const {
+            return m_sum;
+        }
+
+
+    private:
+        double m_sum;           /*!< the running total */
+};
+
+
+//! Neumaier compensated summation policy.
+
+/*!
+ * Adds each value to a running total, and accumulates the rounding
+ * error of each addition separately, as in Kahan summation. Neumaier's
+ * variant also captures the error when a value is larger in magnitude
+ * than the running total, as when long streams of mixed sign cash flows
+ * cancel. The result is usually the correctly rounded sum, and its
+ * error does not grow with the number of values, at the cost of four
+ * more floating point operations and a branch for each value.
+ */
+
+class NeumaierSum {
+    public:
+
+        //! Constructor
+
+        NeumaierSum() : m_sum(0), m_compensation(0) {}
+
+
+        //! Adds a value.
+
+        void add(const double value) {
+            const double total = m_sum + value;
+            if ( std::fabs(m_sum) >= std::fabs(value) ) {
+                m_compensation += (m_sum - total) + value;
+            } else {
+                m_compensation += (value - total) + m_sum;
+            }
+            m_sum = total;
+        }
+
+
+        //! Adds an array of values, in order.
+
+        void add(const double * values, const std::size_t count) {
+            for ( std::size_t i = 0; i < count; ++i ) {
+                add(values[i]);
+            }
+        }
+
+
+        //! Returns the sum of the values added.
+
+        double result() const {
+            return m_sum + m_compensation;
+        }
+
+
+    private:
+        double m_sum;           /*!< the running total */
+        double m_compensation;  /*!< the accumulated rounding error */
+};
+
+
+//! Pairwise summation policy.
+
+/*!
+ * Sums blocks of `block_size` values by recursive halving, and combines
+ * the block totals as a binary counter does, so that each is only ever
+ * added to a total of a similar number of values. The error grows with
+ * the logarithm of the number of values rather than the number itself,
+ * while each addition remains a single floating point operation, and
+ * no more than one block is held at a time.
+ */
+
+class PairwiseSum {
+    public:
+
+        //! Constructor
+
+        PairwiseSum() : m_block(), m_block_count(0), m_levels(),
+                        m_occupied(0) {}
+
+
+        //! Adds a value.
+
+        void add(const double value) {
+            m_block[m_block_count++] = value;
+            if ( m_block_count == block_size ) {
+                carry(pairwise(m_block, block_size));
+                m_block_count = 0;
+            }
+        }
+
+
+        //! Adds an array of values, in order.
+
+        /*!
+         * Whole blocks are summed directly from the array, rather than
+         * copied.
+         */
+
+        void add(const double * values, const std::size_t count) {
+            std::size_t i = 0;
+            while ( i < count && m_block_count != 0 ) {
+                add(values[i++]);
+            }
+            for ( ; i + block_size <= count; i += block_size ) {
+                carry(pairwise(values + i, block_size));
+            }
+            while ( i < count ) {
+                add(values[i++]);
+            }
+        }
+
+
+        //! Returns the sum of the values added.
+
+        /*!
+         * The partly filled block is summed first, and the totals of
+         * the full blocks are added to it from the smallest upwards.
+         */
+
+        double result() const {
+            double total = pairwise(m_block, m_block_count);
+            for ( int level = 0; level < max_levels; ++level ) {
+                if ( (m_occupied >> level) & 1 ) {
+                    total = m_levels[level] + total;
+                }
+            }
+            return total;
+        }
+
+
+    private:
+        static const std::size_t block_size = 32;  /*!< values per block */
+        static const int max_levels = 64;          /*!< counter width */
+
+        //! Sums an array of values by recursive halving.
+
+        static double pairwise(const double * values,
+                               const std::size_t count) {
+            if ( count <= 8 ) {
+                double sum = 0;
+                for ( std::size_t i = 0; i < count; ++i ) {
+                    sum += values[i];
+                }
+                return sum;
+            }
+            const std::size_t half = count / 2;
+            return pairwise(values, half) +
+                   pairwise(values + half, count - half);
+        }
+
+        //! Adds a block total to the binary counter of totals.
+
+        /*!
+         * The total of `2^k` blocks is kept at level `k`. A new total
+         * is merged with the total at each occupied level in turn,
+         * from the lowest, until it reaches an empty one.
+         */
+
+        void carry(double total) {
+            int level = 0;
+            while ( (m_occupied >> level) & 1 ) {
+                total = m_levels[level] + total;
+                m_occupied &= ~(static_cast<uint64_t>(1) << level);
+                ++level;
+            }
+            m_levels[level] = total;
+            m_occupied |= static_cast<uint64_t>(1) << level;
+        }
+
+        double m_block[block_size];     /*!< the partly filled block */
+        std::size_t m_block_count;      /*!< values in the block */
+        double m_levels[max_levels];    /*!< block totals, by level */
+        uint64_t m_occupied;            /*!< bit set for each level held */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_ACCUMULATION_H
@@ -0,0 +1,142 @@
+/*!
+ * \file        amortization.cpp
+ * \brief       Loan amortization schedule implementation.
+ * \details     Loan amortization schedule implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include "basic_dcf.h"
+#include "amortization.h"
+
+using namespace financial;
+
+namespace {
+
+//! Returns the level payment of a loan, allowing for a zero rate.
+
+double level_payment(const double loan_amount,
+                     const double interest_rate,
+                     const int num_periods) {
+    if ( num_periods == 0 ) {
+        return 0;
+    } else if ( interest_rate == 0 ) {
+        return loan_amount / num_periods;
+    } else {
+        return loan_repayment(loan_amount, interest_rate, num_periods);
+    }
+}
+
+//  The arrays passed to these functions never overlap, which the
+//  compiler cannot prove with this many of them, so the loops are marked
+//  as free of dependencies between iterations to let it vectorize them.
+
+//! Calculates one period of a batch of loans before the final period.
+
+void level_period(const double * opening,
+                  const double * interest_rates,
+                  const double * level,
+                  const std::size_t num_loans,
+                  double * payments,
+                  double * interest,
+                  double * principal,
+                  double * balances) {
+#pragma GCC ivdep
+    for ( std::size_t i = 0; i < num_loans; ++i ) {
+        const double period_interest = opening[i] * interest_rates[i];
+        const double period_principal = level[i] - period_interest;
+        payments[i] = level[i];
+        interest[i] = period_interest;
+        principal[i] = period_principal;
+        balances[i] = opening[i] - period_principal;
+    }
+}
+
+//! Calculates the final period of a batch of loans.
+
+void final_period(const double * opening,
+                  const double * interest_rates,
+                  const std::size_t num_loans,
+                  double * payments,
+                  double * interest,
+                  double * principal,
+                  double * balances) {
+#pragma GCC ivdep
+    for ( std::size_t i = 0; i < num_loans; ++i ) {
+        const double period_interest = opening[i] * interest_rates[i];
+        payments[i] = period_interest + opening[i];
+        interest[i] = period_interest;
+        principal[i] = opening[i];
+        balances[i] = 0;
+    }
+}
+
+}           //  namespace
+
+LoanAmortization::LoanAmortization(const double loan_amount,
+                                   const double interest_rate,
+                                   const int num_periods) :
+    m_loan_amount(loan_amount),
+    m_interest_rate(interest_rate),
+    m_num_periods(num_periods),
+    m_payment(0) {
+    if ( num_periods < 0 ) {
+        throw std::domain_error("Number of periods cannot be negative");
+    }
+    m_payment = level_payment(loan_amount, interest_rate, num_periods);
+}
+
+AmortizationRow LoanAmortization::first_row() const {
+    AmortizationRow row = {0, 0, 0, 0, m_loan_amount};
+    next_row(row);
+    return row;
+}
+
+std::size_t LoanAmortization::write(AmortizationRow * rows) const {
+    AmortizationRow row = first_row();
+    for ( int i = 0; i < m_num_periods; ++i ) {
+        rows[i] = row;
+        next_row(row);
+    }
+    return size();
+}
+
+void financial::amortize_loans(const double * loan_amounts,
+                               const double * interest_rates,
+                               const std::size_t num_loans,
+                               const int num_periods,
+                               double * payments,
+                               double * interest,
+                               double * principal,
+                               double * balances) {
+    if ( num_periods < 0 ) {
+        throw std::domain_error("Number of periods cannot be negative");
+    }
+
+    //  Each period reads the balances written by the period before, and
+    //  the first period reads the loan amounts. The level payments are
+    //  calculated once, into the first period's payments.
+
+    for ( std::size_t i = 0; num_periods > 1 && i < num_loans; ++i ) {
+        payments[i] = level_payment(loan_amounts[i], interest_rates[i],
+                                    num_periods);
+    }
+
+    const double * opening = loan_amounts;
+    for ( int p = 1; p <= num_periods; ++p ) {
+        const std::size_t offset = (p - 1) * num_loans;
+        if ( p < num_periods ) {
+            level_period(opening, interest_rates, payments, num_loans,
+                         payments + offset, interest + offset,
+                         principal + offset, balances + offset);
+        } else {
+            final_period(opening, interest_rates, num_loans,
+                         payments + offset, interest + offset,
+                         principal + offset, balances + offset);
+        }
+        opening = balances + offset;
+    }
+}
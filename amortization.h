@@ -0,0 +1,281 @@
+/*!
+ * \file        amortization.h
+ * \brief       Loan amortization schedule interface.
+ * \details     Loan amortization schedule interface.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_AMORTIZATION_H
+#define PG_FINANCIAL_AMORTIZATION_H
+
+#include <cstddef>
+#include <iterator>
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Amortization row structure
+
+/*!
+ * The `AmortizationRow` struct describes one periodic repayment of a
+ * level payment loan.
+ */
+
+struct AmortizationRow {
+    int period;         /*!< the period of the repayment, from 1 */
+    double payment;     /*!< the total amount repaid */
+    double interest;    /*!< the part of the payment which is interest */
+    double principal;   /*!< the part of the payment which is principal */
+    double balance;     /*!< the principal outstanding after the payment */
+};
+
+
+//! Loan amortization class.
+
+/*!
+ * Generates the amortization schedule of a level payment loan, one row
+ * per period, without allocating memory. The rows can be written to a
+ * caller-provided buffer, passed to a callback, or read through an
+ * iterator, and are generated as they are needed, so a schedule never
+ * has to be held in memory in full.
+ *
+ * Each period's interest is the outstanding balance multiplied by the
+ * periodic interest rate, and the rest of the level payment repays
+ * principal. In the final period the whole remaining balance is repaid,
+ * so the payment absorbs any rounding and the balance ends at exactly
+ * zero.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * const financial::LoanAmortization loan(250000, 0.0035, 360);
+ * double total_interest = 0;
+ * loan.for_each_row([&](const financial::AmortizationRow& row) {
+ *     total_interest += row.interest;
+ * });
+ * ~~~~
+ */
+
+class LoanAmortization {
+    public:
+
+        //! Amortization row iterator class.
+
+        /*!
+         * An input iterator over the rows of an amortization schedule.
+         * Each row is calculated from the one before when the iterator
+         * is incremented.
+         */
+
+        class const_iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef AmortizationRow value_type;
+                typedef std::ptrdiff_t difference_type;
+                typedef const AmortizationRow * pointer;
+                typedef const AmortizationRow& reference;
+
+                //! Returns the current row.
+                reference operator*() const { return m_row; }
+
+                //! Returns a pointer to the current row.
+                pointer operator->() const { return &m_row; }
+
+                //! Advances to the next row.
+                const_iterator& operator++() {
+                    m_loan->next_row(m_row);
+                    return *this;
+                }
+
+                //! Advances to the next row.
+                const_iterator operator++(int) {
+                    const_iterator previous(*this);
+                    ++*this;
+                    return previous;
+                }
+
+                //! Returns true if both iterators are at the same row.
+                bool operator==(const const_iterator& other) const {
+                    return m_row.period == other.m_row.period;
+                }
+
+                //! Returns true if the iterators are at different rows.
+                bool operator!=(const const_iterator& other) const {
+                    return !(*this == other);
+                }
+
+            private:
+                friend class LoanAmortization;
+
+                const_iterator(const LoanAmortization * loan,
+                               const AmortizationRow& row) :
+                    m_loan(loan), m_row(row) {}
+
+                const LoanAmortization * m_loan;    /*!< the loan */
+                AmortizationRow m_row;              /*!< the current row */
+        };
+
+
+        //! Constructor
+
+        /*!
+         * \param loan_amount the amount of the loan.
+         * \param interest_rate the periodic interest rate.
+         * \param num_periods the number of periodic repayments.
+         * \throws std::domain_error if `num_periods` is negative.
+         */
+
+        explicit LoanAmortization(const double loan_amount,
+                                  const double interest_rate,
+                                  const int num_periods);
+
+
+        //! Returns the amount of the loan.
+
+        double loan_amount() const { return m_loan_amount; }
+
+
+        //! Returns the periodic interest rate.
+
+        double interest_rate() const { return m_interest_rate; }
+
+
+        //! Returns the number of periodic repayments.
+
+        int num_periods() const { return m_num_periods; }
+
+
+        //! Returns the level periodic payment.
+
+        /*!
+         * \return the periodic payment, as returned by `loan_repayment()`,
+         * or the loan amount divided by the number of periods if the
+         * interest rate is zero.
+         */
+
+        double payment() const { return m_payment; }
+
+
+        //! Returns the number of rows in the schedule.
+
+        std::size_t size() const {
+            return static_cast<std::size_t>(m_num_periods);
+        }
+
+
+        //! Returns an iterator to the first row.
+
+        const_iterator begin() const {
+            return const_iterator(this, first_row());
+        }
+
+
+        //! Returns an iterator one past the last row.
+
+        const_iterator end() const {
+            const AmortizationRow row = {m_num_periods + 1, 0, 0, 0, 0};
+            return const_iterator(this, row);
+        }
+
+
+        //! Calls a function for each row in turn.
+
+        /*!
+         * \param function a function or function object taking a
+         * `const AmortizationRow&`.
+         */
+
+        template <class Function>
+        void for_each_row(Function function) const {
+            AmortizationRow row = first_row();
+            const AmortizationRow& current = row;
+            for ( int i = 0; i < m_num_periods; ++i ) {
+                function(current);
+                next_row(row);
+            }
+        }
+
+
+        //! Writes the schedule to a buffer.
+
+        /*!
+         * \param rows a buffer with room for at least `size()` rows.
+         * \return the number of rows written.
+         */
+
+        std::size_t write(AmortizationRow * rows) const;
+
+
+    private:
+
+        //! Returns the first row of the schedule.
+        AmortizationRow first_row() const;
+
+        //! Replaces a row with the row for the following period.
+        void next_row(AmortizationRow& row) const {
+            const double opening_balance = row.balance;
+            ++row.period;
+            row.interest = opening_balance * m_interest_rate;
+            if ( row.period < m_num_periods ) {
+                row.payment = m_payment;
+                row.principal = m_payment - row.interest;
+                row.balance = opening_balance - row.principal;
+            } else {
+                row.principal = opening_balance;
+                row.payment = row.interest + opening_balance;
+                row.balance = 0;
+            }
+        }
+
+        double m_loan_amount;       /*!< the amount of the loan */
+        double m_interest_rate;     /*!< the periodic interest rate */
+        int m_num_periods;          /*!< the number of repayments */
+        double m_payment;           /*!< the level periodic payment */
+};
+
+
+//! Amortizes a batch of loans with the same number of periods.
+
+/*!
+ * Generates the amortization schedules of a batch of level payment
+ * loans, which may have different amounts and interest rates but must
+ * have the same number of periods. Each result is written in
+ * period-major order, so the value for loan `i` in period `p` (from 1)
+ * is at index `(p - 1) * num_loans + i`. Each period is calculated for
+ * all the loans in one pass over contiguous arrays, which the compiler
+ * vectorizes across loans. The results are identical to those of
+ * `LoanAmortization`.
+ *
+ * Loans with different numbers of periods should be grouped into one
+ * batch per number of periods. None of the arrays may overlap.
+ *
+ * \param loan_amounts the amounts of the loans.
+ * \param interest_rates the periodic interest rates of the loans.
+ * \param num_loans the number of loans.
+ * \param num_periods the number of periodic repayments of every loan.
+ * \param payments receives each period's payment, and must have room
+ * for `num_loans * num_periods` values.
+ * \param interest receives each period's interest, and must have room
+ * for `num_loans * num_periods` values.
+ * \param principal receives each period's repayment of principal, and
+ * must have room for `num_loans * num_periods` values.
+ * \param balances receives the balance outstanding after each period's
+ * payment, and must have room for `num_loans * num_periods` values.
+ * \throws std::domain_error if `num_periods` is negative.
+ */
+
+void amortize_loans(const double * loan_amounts,
+                    const double * interest_rates,
+                    const std::size_t num_loans,
+                    const int num_periods,
+                    double * payments,
+                    double * interest,
+                    double * principal,
+                    double * balances);
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_AMORTIZATION_H
@@ -0,0 +1,94 @@
+/*!
+ * \file        arena.cpp
+ * \brief       Monotonic arena allocator implementation.
+ * \details     Monotonic arena allocator implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <new>
+#include "arena.h"
+
+using namespace financial;
+
+MonotonicArena::MonotonicArena(const std::size_t initial_size) :
+    m_head(0), m_current(0), m_end(0),
+    m_next_size(initial_size ? initial_size : 1),
+    m_capacity(0), m_used_before(0) {}
+
+MonotonicArena::~MonotonicArena() {
+    while ( m_head ) {
+        Block * next = m_head->next;
+        ::operator delete(m_head);
+        m_head = next;
+    }
+}
+
+void MonotonicArena::release() {
+    if ( !m_head ) {
+        return;
+    }
+
+    //  If the arena outgrew its first block, replace all the blocks
+    //  with one as large as all of them together, so the same usage
+    //  will fit next time without allocating.
+
+    if ( m_head->next ) {
+        const std::size_t total = m_capacity;
+        while ( m_head ) {
+            Block * next = m_head->next;
+            ::operator delete(m_head);
+            m_head = next;
+        }
+
+        //  Leave the arena empty, rather than pointing into the freed
+        //  blocks, in case the new block cannot be allocated.
+
+        m_current = 0;
+        m_end = 0;
+        m_capacity = 0;
+        m_used_before = 0;
+        m_head = static_cast<Block *>(::operator new(sizeof(Block) + total));
+        m_head->next = 0;
+        m_head->size = total;
+        m_next_size = total * 2;
+    }
+
+    m_current = block_begin(m_head);
+    m_end = m_current + m_head->size;
+    m_capacity = m_head->size;
+    m_used_before = 0;
+}
+
+std::size_t MonotonicArena::bytes_used() const {
+    return m_head ? m_used_before + (m_current - block_begin(m_head)) : 0;
+}
+
+void * MonotonicArena::allocate_from_new_block(const std::size_t size,
+                                               const std::size_t alignment) {
+
+    //  Blocks only grow, so the newest block is always the largest. The
+    //  unused end of the previous block is abandoned.
+
+    std::size_t block_size = size + alignment;
+    if ( block_size < m_next_size ) {
+        block_size = m_next_size;
+    }
+    Block * block = static_cast<Block *>(::operator new(sizeof(Block) +
+                                                        block_size));
+    block->next = m_head;
+    block->size = block_size;
+
+    if ( m_head ) {
+        m_used_before += m_current - block_begin(m_head);
+    }
+    m_head = block;
+    m_current = block_begin(block);
+    m_end = m_current + block_size;
+    m_capacity += block_size;
+    m_next_size = block_size * 2;
+
+    return allocate(size, alignment);
+}
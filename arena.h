@@ -0,0 +1,249 @@
+/*!
+ * \file        arena.h
+ * \brief       Monotonic arena allocator interface.
+ * \details     A monotonic memory arena, and a standard allocator which
+ * draws from one, for building short-lived schedules without a heap
+ * allocation for each.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_ARENA_H
+#define PG_FINANCIAL_ARENA_H
+
+#include <cstddef>
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Monotonic memory arena class.
+
+/*!
+ * Hands out memory from large blocks by advancing a pointer, and never
+ * frees individual allocations. All the memory is released at once by
+ * `release()` or by the destructor. When a block is exhausted, a new
+ * one twice the size is allocated from the heap. `release()` keeps the
+ * memory for reuse, replacing several blocks with a single one as large
+ * as all of them, so an arena which is released after each request
+ * stops allocating from the heap once it has grown to fit the largest
+ * request.
+ *
+ * An arena is not thread safe. Giving each worker thread its own arena
+ * removes heap allocation, and the contention for the heap between
+ * threads which comes with it, from the building of schedules.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::MonotonicArena arena(1 << 20);
+ * for ( const Request& request : requests ) {
+ *     const financial::ArenaAllocator<double> alloc(arena);
+ *     financial::ArenaCashFlowSchedule sched(alloc);
+ *     build_schedule(request, sched);
+ *     respond(request, financial::pv_stream(sched, request.rate));
+ *     arena.release();
+ * }
+ * ~~~~
+ */
+
+class MonotonicArena {
+    public:
+
+        //! Constructor
+
+        /*!
+         * Creates an arena. No memory is allocated until the first
+         * allocation from the arena.
+         *
+         * \param initial_size the size in bytes of the first block.
+         */
+
+        explicit MonotonicArena(const std::size_t initial_size = 4096);
+
+
+        //! Destructor
+
+        /*!
+         * Frees every block.
+         */
+
+        ~MonotonicArena();
+
+
+        //! Allocates memory from the arena.
+
+        /*!
+         * \param size the number of bytes to allocate.
+         * \param alignment the alignment of the memory, which must be a
+         * power of two.
+         * \return a pointer to the memory, which remains valid until the
+         * arena is released or destroyed.
+         * \throws std::bad_alloc if a new block cannot be allocated.
+         */
+
+        void * allocate(const std::size_t size,
+                        const std::size_t alignment = alignof(double)) {
+            const std::size_t offset =
+                (alignment - reinterpret_cast<std::size_t>(m_current)) &
+                (alignment - 1);
+            if ( m_current &&
+                 size + offset <= static_cast<std::size_t>(m_end -
+                                                           m_current) ) {
+                char * ptr = m_current + offset;
+                m_current = ptr + size;
+                return ptr;
+            }
+            return allocate_from_new_block(size, alignment);
+        }
+
+
+        //! Releases all the memory allocated from the arena.
+
+        /*!
+         * Every pointer returned by `allocate()` is invalidated. If the
+         * arena has more than one block, they are replaced by a single
+         * block of their total size, which is kept for reuse.
+         *
+         * \throws std::bad_alloc if the single block cannot be
+         * allocated, in which case the arena is left empty, and may
+         * still be used.
+         */
+
+        void release();
+
+
+        //! Returns the number of bytes allocated from the arena.
+
+        /*!
+         * \return the number of bytes in use, including any padding for
+         * alignment, since the arena was created or last released.
+         */
+
+        std::size_t bytes_used() const;
+
+
+        //! Returns the total size of the arena's blocks.
+
+        std::size_t capacity() const { return m_capacity; }
+
+
+    private:
+
+        //! Header at the start of each block.
+
+        struct Block {
+            Block * next;           /*!< the previously allocated block */
+            std::size_t size;       /*!< the size of the block's memory */
+        };
+
+        MonotonicArena(const MonotonicArena&);
+        MonotonicArena& operator=(const MonotonicArena&);
+
+        //! Allocates from a new block, when the current one is full.
+        void * allocate_from_new_block(const std::size_t size,
+                                       const std::size_t alignment);
+
+        //! Returns the start of a block's memory.
+        static char * block_begin(Block * block) {
+            return reinterpret_cast<char *>(block) + sizeof(Block);
+        }
+
+        Block * m_head;             /*!< the current, largest block */
+        char * m_current;           /*!< the next free byte */
+        char * m_end;               /*!< the end of the current block */
+        std::size_t m_next_size;    /*!< the size of the next block */
+        std::size_t m_capacity;     /*!< the total size of the blocks */
+        std::size_t m_used_before;  /*!< bytes used in earlier blocks */
+};
+
+
+//! Arena allocator class template.
+
+/*!
+ * A standard allocator which draws its memory from a `MonotonicArena`,
+ * for use with standard containers and with `BasicCashFlowSchedule`.
+ * Deallocation does nothing, and the memory is reclaimed when the arena
+ * is released. A container which grows by reallocation leaves its old
+ * storage in the arena until then, so reserving capacity up front makes
+ * the best use of the arena.
+ *
+ * Allocators compare equal if they draw from the same arena. The arena
+ * must outlive every container using it.
+ */
+
+template <class T>
+class ArenaAllocator {
+    public:
+        typedef T value_type;           /*!< the allocated type */
+
+        //! Rebinds the allocator to another type.
+        template <class U>
+        struct rebind {
+            typedef ArenaAllocator<U> other;    /*!< the rebound type */
+        };
+
+
+        //! Constructor
+
+        /*!
+         * \param arena the arena to allocate from.
+         */
+
+        explicit ArenaAllocator(MonotonicArena& arena) : m_arena(&arena) {}
+
+
+        //! Converting constructor
+
+        /*!
+         * \param other an allocator for another type, drawing from the
+         * arena to allocate from.
+         */
+
+        template <class U>
+        ArenaAllocator(const ArenaAllocator<U>& other) :
+            m_arena(&other.arena()) {}
+
+
+        //! Allocates storage for a number of objects.
+
+        T * allocate(const std::size_t n) {
+            return static_cast<T *>(m_arena->allocate(n * sizeof(T),
+                                                      alignof(T)));
+        }
+
+
+        //! Does nothing, as the arena frees its memory all at once.
+
+        void deallocate(T *, const std::size_t) {}
+
+
+        //! Returns the arena allocated from.
+
+        MonotonicArena& arena() const { return *m_arena; }
+
+
+    private:
+        MonotonicArena * m_arena;   /*!< the arena allocated from */
+};
+
+
+//! Returns true if two arena allocators draw from the same arena.
+
+template <class T, class U>
+bool operator==(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return &a.arena() == &b.arena();
+}
+
+
+//! Returns true if two arena allocators draw from different arenas.
+
+template <class T, class U>
+bool operator!=(const ArenaAllocator<T>& a, const ArenaAllocator<U>& b) {
+    return !(a == b);
+}
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_ARENA_H
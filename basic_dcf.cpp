@@ -8,30 +8,148 @@
  */
 
 #include <vector>
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include "basic_dcf.h"
+#include "instrumentation.h"
 
 using namespace financial;
 
-double financial::compound_factor(const double interest_rate,
-                                  const double num_periods,
-                                  const enum disc_type dt) {
-    if ( dt == disc_type::discrete ) {
+namespace {
+
+//! Largest number of periods compounded by repeated multiplication.
+
+/*!
+ * Each multiplication of repeated squaring adds a rounding error which
+ * later squarings amplify, so its error grows by about 0.7 ulp per
+ * period, while that of `exp(n * log1p(r))` grows only with `n *
+ * log1p(r)`. Squaring is faster, and as accurate, only for a few
+ * periods.
+ */
+
+const int max_power_periods = 4;
+
+//! Raises `1 + interest_rate` to an integer power by repeated squaring.
+
+double power_compound_factor(const double interest_rate,
+                             const int num_periods) {
+    const double base = 1 + interest_rate;
+    unsigned int n = ( num_periods < 0 ) ? -num_periods : num_periods;
+    const double abs_periods = n;
+    double factor = 1;
+    double square = base;
+    while ( n ) {
+        if ( n & 1 ) {
+            factor *= square;
+        }
+        square *= square;
+        n >>= 1;
+    }
+
+    //  Correct to first order for the rounding of 1 + interest_rate,
+    //  which would otherwise be multiplied by the number of periods.
+
+    if ( base > 0 ) {
+        const double base_error = (interest_rate - (base - 1)) / base;
+        factor += factor * (abs_periods * base_error);
+    }
+    return ( num_periods < 0 ) ? 1 / factor : factor;
+}
+
+//! Calculates a discrete compounding factor.
+
+double discrete_compound_factor(const double interest_rate,
+                                const double num_periods) {
+    if ( std::fabs(num_periods) <= max_power_periods &&
+         num_periods == static_cast<int>(num_periods) ) {
+        return power_compound_factor(interest_rate,
+                                     static_cast<int>(num_periods));
+    } else if ( interest_rate > -1 ) {
+        return std::exp(num_periods * std::log1p(interest_rate));
+    } else {
         return std::pow(1 + interest_rate, num_periods);
+    }
+}
+
+//! Calculates `compound_factor(interest_rate, num_periods) - 1`.
+
+/*!
+ * Uses `expm1()`, so there is no cancellation when the factor is close
+ * to one, as it is for a small rate or a short time.
+ */
+
+double compound_growth(const double interest_rate,
+                       const double num_periods) {
+    if ( interest_rate > -1 ) {
+        return std::expm1(num_periods * std::log1p(interest_rate));
+    } else {
+        return std::pow(1 + interest_rate, num_periods) - 1;
+    }
+}
+
+//! Calculates a compounding factor.
+
+/*!
+ * The public functions call this, and the other helpers below, rather
+ * than each other, so that each call to a public function records one
+ * instrumentation probe, however it is implemented.
+ */
+
+double compound(const double interest_rate, const double num_periods,
+                const enum disc_type dt) {
+    if ( dt == disc_type::discrete ) {
+        return discrete_compound_factor(interest_rate, num_periods);
     } else if ( dt == disc_type::continuous ) {
-        return std::pow(e, interest_rate * num_periods);
+        return std::exp(interest_rate * num_periods);
     } else {
         assert(false);
         return 0;
     }
 }
 
+//! Calculates the present value of a perpetuity.
+
+double perpetuity(const double cashflow, const double interest_rate,
+                  const enum annuity_type at) {
+    double present_value = cashflow / interest_rate;
+    if ( at == annuity_type::due ) {
+        present_value *= 1 + interest_rate;
+    }
+    return present_value;
+}
+
+//! Adds a stream's discounted cash flows with an accumulator.
+
+template <class Accumulation>
+double discounted_total(const std::vector<TimedCashFlow>& cashflows,
+                        const double interest_rate) {
+    Accumulation pv_total;
+    for ( std::vector<TimedCashFlow>::const_iterator itr = cashflows.begin();
+            itr != cashflows.end(); ++itr ) {
+        const TimedCashFlow& cf = *itr;
+        pv_total.add(cf.amount * compound(interest_rate, -cf.time_period,
+                                          disc_type::discrete));
+    }
+    return pv_total.result();
+}
+
+}           //  namespace
+
+
+double financial::compound_factor(const double interest_rate,
+                                  const double num_periods,
+                                  const enum disc_type dt) {
+    PG_FINANCIAL_PROBE(compound_factor, 1);
+    return compound(interest_rate, num_periods, dt);
+}
+
 
 double financial::discount_factor(const double interest_rate,
                                   const double num_periods,
                                   const enum disc_type dt) {
-    return (1 / compound_factor(interest_rate, num_periods, dt));
+    PG_FINANCIAL_PROBE(discount_factor, 1);
+    return compound(interest_rate, -num_periods, dt);
 }
 
 
@@ -39,58 +157,95 @@ double financial::pv(const double cashflow,
                      const double interest_rate,
                      const double num_periods,
                      const enum disc_type dt) {
-    return cashflow * discount_factor(interest_rate, num_periods, dt);
+    PG_FINANCIAL_PROBE(pv, 1);
+    return cashflow * compound(interest_rate, -num_periods, dt);
 }
 
 double financial::fv(const double cashflow,
                      const double interest_rate,
                      const double num_periods,
                      const enum disc_type dt) {
-    return cashflow * compound_factor(interest_rate, num_periods, dt);
+    PG_FINANCIAL_PROBE(fv, 1);
+    return cashflow * compound(interest_rate, num_periods, dt);
 }
 
 double financial::pv_perpetuity(const double cashflow,
                                 const double interest_rate,
                                 const enum annuity_type at) {
-    double present_value = cashflow / interest_rate;
-    if ( at == annuity_type::due ) {
-        present_value *= compound_factor(interest_rate, 1);
-    }
-    return present_value;
+    PG_FINANCIAL_PROBE(pv_perpetuity, 1);
+    return perpetuity(cashflow, interest_rate, at);
 }
 
 double financial::pv_annuity(const double cashflow,
                              const double interest_rate,
                              const int num_periods,
                              const enum annuity_type at) {
-    const double pvp = pv_perpetuity(cashflow, interest_rate, at);
-    return pvp * (1 - discount_factor(interest_rate, num_periods));
+    PG_FINANCIAL_PROBE(pv_annuity,
+                       static_cast<std::size_t>(std::max(num_periods, 0)));
+    const double pvp = perpetuity(cashflow, interest_rate, at);
+    return pvp * -compound_growth(interest_rate, -num_periods);
 }
 
 double financial::pv_stream(const std::vector<TimedCashFlow>& cashflows,
                             const double interest_rate) {
-    double pv_total = 0;
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return discounted_total<NaiveSum>(cashflows, interest_rate);
+}
+
+template <class Accumulation>
+double financial::pv_stream(const std::vector<TimedCashFlow>& cashflows,
+                            const double interest_rate) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return discounted_total<Accumulation>(cashflows, interest_rate);
+}
+
+template double financial::pv_stream<NaiveSum>(
+        const std::vector<TimedCashFlow>& cashflows,
+        const double interest_rate);
+template double financial::pv_stream<NeumaierSum>(
+        const std::vector<TimedCashFlow>& cashflows,
+        const double interest_rate);
+template double financial::pv_stream<PairwiseSum>(
+        const std::vector<TimedCashFlow>& cashflows,
+        const double interest_rate);
+
+RiskMeasures financial::price_and_risk(const std::vector<TimedCashFlow>&
+                                       cashflows,
+                                       const double interest_rate) {
+    PG_FINANCIAL_PROBE(price_and_risk, cashflows.size());
+    double s0 = 0;
+    double s1 = 0;
+    double s2 = 0;
     for ( std::vector<TimedCashFlow>::const_iterator itr = cashflows.begin();
             itr != cashflows.end(); ++itr ) {
         const TimedCashFlow& cf = *itr;
-        pv_total += pv(cf.amount, interest_rate, cf.time_period);
+        const double dcf = cf.amount * compound(interest_rate,
+                                                -cf.time_period,
+                                                disc_type::discrete);
+        s0 += dcf;
+        s1 += cf.time_period * dcf;
+        s2 += cf.time_period * cf.time_period * dcf;
     }
-    return pv_total;
+
+    const double g = 1 + interest_rate;
+    return RiskMeasures(s0, -s1 / g, (s2 + s1) / (g * g), interest_rate);
 }
 
 double financial::sinking_fund_payment(const double fund_value,
                                        const double interest_rate,
                                        const double num_periods) {
-    const double factor = (compound_factor(interest_rate, num_periods) - 1) /
-                               interest_rate; 
+    PG_FINANCIAL_PROBE(sinking_fund_payment, 1);
+    const double factor = compound_growth(interest_rate, num_periods) /
+                          interest_rate;
     return fund_value / factor;
 }
 
 double financial::loan_repayment(const double loan_amount,
                                  const double interest_rate,
                                  const double num_periods) {
+    PG_FINANCIAL_PROBE(loan_repayment, 1);
     const double factor = interest_rate /
-                        (1 - discount_factor(interest_rate, num_periods));
+                          -compound_growth(interest_rate, -num_periods);
     return loan_amount * factor;
 }
 
@@ -13,6 +13,7 @@
 #define PG_FINANCIAL_FUNCTIONS_H
 
 #include <vector>
+#include "accumulation.h"
 #include "common_financial_types.h"
 
 //! User library namespace
@@ -33,6 +34,12 @@ namespace financial {
  * factor for two periods at 5% per period is therefore 110.25 / 100.0 =
  * 1.1025, since $100 * 1.1025 = $110.25.
  *
+ * Discrete compounding over a few whole periods is calculated by
+ * repeated multiplication, and otherwise as `exp(num_periods *
+ * log1p(interest_rate))`, which avoids magnifying the rounding error of
+ * `1 + interest_rate`. Continuous compounding is calculated as
+ * `exp(interest_rate * num_periods)`.
+ *
  * Sample usage:
  * ~~~~{.cpp}
  * double cf = financial::compound_factor(0.1, 7);
@@ -230,6 +237,56 @@ double pv_stream(const std::vector<TimedCashFlow>& cashflows,
                  const double interest_rate);
 
 
+//! Calculates the present value of a stream with a summation policy.
+
+/*!
+ * As `pv_stream()`, adding the discounted cash flows in order with the
+ * accumulator `Accumulation`, which is one of `NaiveSum`, `NeumaierSum`
+ * or `PairwiseSum`. `pv_stream<NaiveSum>()` is the same as
+ * `pv_stream()`.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * double pval = financial::pv_stream<financial::NeumaierSum>(cfs, 0.05);
+ * ~~~~
+ *
+ * \param cashflows a std::vector of TimedCashFlow structs representing
+ * the stream of cash flows.
+ * \param interest_rate the periodic interest rate
+ * \return the present value of the stream of cash flows.
+ */
+
+template <class Accumulation>
+double pv_stream(const std::vector<TimedCashFlow>& cashflows,
+                 const double interest_rate);
+
+
+//! Calculates the present value and risk of a stream of cash flows.
+
+/*!
+ * Calculates the present value of a stream of cash flows, together with
+ * its Macaulay and modified durations, convexity and DV01, in a single
+ * pass over the cash flows, rather than by revaluing the stream at
+ * bumped interest rates.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::RiskMeasures risk = financial::price_and_risk(cfs, 0.05);
+ * std::cout << "PV: " << risk.pv << ", modified duration: "
+ *           << risk.modified_duration << std::endl;
+ * ~~~~
+ *
+ * \param cashflows a std::vector of TimedCashFlow structs representing
+ * the stream of cash flows.
+ * \param interest_rate the periodic interest rate
+ * \return the present value and risk measures of the stream of cash
+ * flows.
+ */
+
+RiskMeasures price_and_risk(const std::vector<TimedCashFlow>& cashflows,
+                            const double interest_rate);
+
+
 //! Calculates the periodic payment to a sinking fund.
 
 /*!
@@ -0,0 +1,292 @@
+/*!
+ * \file        batch_dcf.cpp
+ * \brief       Batch discounted cash flow functions implementation.
+ * \details     Batch discounted cash flow functions implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include "common_financial_types.h"
+#include "pv_kernels.h"
+#include "thread_pool.h"
+#include "batch_dcf.h"
+
+using namespace financial;
+
+namespace {
+
+//! Number of calculations whose discount factors are taken together.
+
+const std::size_t block_size = 256;
+
+//! Runs a function for each block of calculations.
+
+/*!
+ * The function is called with the index of the first calculation in
+ * the block, and the number of calculations in it. Blocks never span
+ * two chunks, so the blocks, and the results, are the same with or
+ * without a thread pool.
+ */
+
+template <class Function>
+void for_each_block(ThreadPool * pool, const std::size_t count,
+                    const Function& function) {
+    const std::size_t num_chunks = (count + batch_chunk_size - 1) /
+                                   batch_chunk_size;
+    for_each_chunk(pool, num_chunks, [&](const std::size_t chunk) {
+        const std::size_t begin = chunk * batch_chunk_size;
+        const std::size_t end = std::min(begin + batch_chunk_size, count);
+        for ( std::size_t b = begin; b < end; b += block_size ) {
+            function(b, std::min(block_size, end - b));
+        }
+    });
+}
+
+//! Returns the growth factor for payments at the start of each period.
+
+inline double due_factor(const annuity_type * types, const std::size_t i,
+                         const double interest_rate) {
+    return ( types && types[i] == annuity_type::due ) ?
+           1 + interest_rate : 1;
+}
+
+//! Calculates compounding factors, or discount factors if `sign` is -1.
+
+void factor_batch(const double * interest_rates,
+                  const double * num_periods,
+                  const std::size_t count,
+                  double * factors,
+                  const enum disc_type dt,
+                  const double sign,
+                  ThreadPool * pool) {
+    for_each_block(pool, count, [=](const std::size_t b,
+                                    const std::size_t n) {
+        if ( dt == disc_type::discrete && sign < 0 ) {
+            detail::discount_factors(interest_rates + b, num_periods + b,
+                                     n, factors + b);
+            return;
+        }
+
+        double args[block_size];
+        if ( dt == disc_type::discrete ) {
+            for ( std::size_t i = 0; i < n; ++i ) {
+                args[i] = -num_periods[b + i];
+            }
+            detail::discount_factors(interest_rates + b, args, n,
+                                     factors + b);
+        } else {
+            for ( std::size_t i = 0; i < n; ++i ) {
+                args[i] = sign * interest_rates[b + i] * num_periods[b + i];
+            }
+            detail::exponentials(args, n, factors + b);
+        }
+    });
+}
+
+//! Calculates the present values of perpetuities.
+
+void perpetuity_batch(const double * cashflows,
+                      const double * interest_rates,
+                      const annuity_type * types,
+                      const std::size_t count,
+                      double * present_values,
+                      ThreadPool * pool) {
+    for_each_block(pool, count, [=](const std::size_t b,
+                                    const std::size_t n) {
+        for ( std::size_t i = b; i < b + n; ++i ) {
+            const double rate = interest_rates[i];
+            present_values[i] = cashflows[i] / rate *
+                                due_factor(types, i, rate);
+        }
+    });
+}
+
+//! Calculates the present values of annuities.
+
+void annuity_batch(const double * cashflows,
+                   const double * interest_rates,
+                   const int * num_periods,
+                   const annuity_type * types,
+                   const std::size_t count,
+                   double * present_values,
+                   ThreadPool * pool) {
+    for_each_block(pool, count, [=](const std::size_t b,
+                                    const std::size_t n) {
+        double periods[block_size];
+        double growths[block_size];
+        std::copy(num_periods + b, num_periods + b + n, periods);
+        detail::discount_growths(interest_rates + b, periods, n, growths);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            const double rate = interest_rates[b + i];
+            present_values[b + i] = cashflows[b + i] / rate *
+                                    due_factor(types, b + i, rate) *
+                                    -growths[i];
+        }
+    });
+}
+
+//! Calculates the periodic payments to sinking funds.
+
+void sinking_fund_batch(const double * fund_values,
+                        const double * interest_rates,
+                        const double * num_periods,
+                        const std::size_t count,
+                        double * payments,
+                        ThreadPool * pool) {
+    for_each_block(pool, count, [=](const std::size_t b,
+                                    const std::size_t n) {
+        //  The future value of an annuity of one is (cf - 1) / r, and
+        //  cf - 1 is the discount growth over minus the periods. The
+        //  arguments are value-initialized only because GCC cannot see
+        //  that every one the kernel reads is written.
+
+        double args[block_size] = {};
+        double growths[block_size];
+        for ( std::size_t i = 0; i < n; ++i ) {
+            args[i] = -num_periods[b + i];
+        }
+        detail::discount_growths(interest_rates + b, args, n, growths);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            payments[b + i] = fund_values[b + i] /
+                              (growths[i] / interest_rates[b + i]);
+        }
+    });
+}
+
+//! Calculates the periodic repayments of loans.
+
+void loan_batch(const double * loan_amounts,
+                const double * interest_rates,
+                const double * num_periods,
+                const std::size_t count,
+                double * repayments,
+                ThreadPool * pool) {
+    for_each_block(pool, count, [=](const std::size_t b,
+                                    const std::size_t n) {
+        double growths[block_size];
+        detail::discount_growths(interest_rates + b, num_periods + b, n,
+                                 growths);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            repayments[b + i] = loan_amounts[b + i] *
+                                (interest_rates[b + i] / -growths[i]);
+        }
+    });
+}
+
+}           //  namespace
+
+void financial::compound_factor(const double * interest_rates,
+                                const double * num_periods,
+                                const std::size_t count,
+                                double * factors,
+                                const enum disc_type dt) {
+    factor_batch(interest_rates, num_periods, count, factors, dt, 1, 0);
+}
+
+void financial::compound_factor(const double * interest_rates,
+                                const double * num_periods,
+                                const std::size_t count,
+                                double * factors,
+                                ThreadPool& pool,
+                                const enum disc_type dt) {
+    factor_batch(interest_rates, num_periods, count, factors, dt, 1, &pool);
+}
+
+void financial::discount_factor(const double * interest_rates,
+                                const double * num_periods,
+                                const std::size_t count,
+                                double * factors,
+                                const enum disc_type dt) {
+    factor_batch(interest_rates, num_periods, count, factors, dt, -1, 0);
+}
+
+void financial::discount_factor(const double * interest_rates,
+                                const double * num_periods,
+                                const std::size_t count,
+                                double * factors,
+                                ThreadPool& pool,
+                                const enum disc_type dt) {
+    factor_batch(interest_rates, num_periods, count, factors, dt, -1,
+                 &pool);
+}
+
+void financial::pv_perpetuity(const double * cashflows,
+                              const double * interest_rates,
+                              const annuity_type * types,
+                              const std::size_t count,
+                              double * present_values) {
+    perpetuity_batch(cashflows, interest_rates, types, count,
+                     present_values, 0);
+}
+
+void financial::pv_perpetuity(const double * cashflows,
+                              const double * interest_rates,
+                              const annuity_type * types,
+                              const std::size_t count,
+                              double * present_values,
+                              ThreadPool& pool) {
+    perpetuity_batch(cashflows, interest_rates, types, count,
+                     present_values, &pool);
+}
+
+void financial::pv_annuity(const double * cashflows,
+                           const double * interest_rates,
+                           const int * num_periods,
+                           const annuity_type * types,
+                           const std::size_t count,
+                           double * present_values) {
+    annuity_batch(cashflows, interest_rates, num_periods, types, count,
+                  present_values, 0);
+}
+
+void financial::pv_annuity(const double * cashflows,
+                           const double * interest_rates,
+                           const int * num_periods,
+                           const annuity_type * types,
+                           const std::size_t count,
+                           double * present_values,
+                           ThreadPool& pool) {
+    annuity_batch(cashflows, interest_rates, num_periods, types, count,
+                  present_values, &pool);
+}
+
+void financial::sinking_fund_payment(const double * fund_values,
+                                     const double * interest_rates,
+                                     const double * num_periods,
+                                     const std::size_t count,
+                                     double * payments) {
+    sinking_fund_batch(fund_values, interest_rates, num_periods, count,
+                       payments, 0);
+}
+
+void financial::sinking_fund_payment(const double * fund_values,
+                                     const double * interest_rates,
+                                     const double * num_periods,
+                                     const std::size_t count,
+                                     double * payments,
+                                     ThreadPool& pool) {
+    sinking_fund_batch(fund_values, interest_rates, num_periods, count,
+                       payments, &pool);
+}
+
+void financial::loan_repayment(const double * loan_amounts,
+                               const double * interest_rates,
+                               const double * num_periods,
+                               const std::size_t count,
+                               double * repayments) {
+    loan_batch(loan_amounts, interest_rates, num_periods, count,
+               repayments, 0);
+}
+
+void financial::loan_repayment(const double * loan_amounts,
+                               const double * interest_rates,
+                               const double * num_periods,
+                               const std::size_t count,
+                               double * repayments,
+                               ThreadPool& pool) {
+    loan_batch(loan_amounts, interest_rates, num_periods, count,
+               repayments, &pool);
+}
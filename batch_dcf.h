@@ -0,0 +1,293 @@
+/*!
+ * \file        batch_dcf.h
+ * \brief       Batch discounted cash flow functions interface.
+ * \details     Columnar batch versions of the compounding, discounting,
+ * perpetuity, annuity, sinking fund and loan repayment functions, which
+ * evaluate many calculations at once with the SIMD discounting kernels,
+ * optionally on a thread pool.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_BATCH_DCF_H
+#define PG_FINANCIAL_BATCH_DCF_H
+
+#include <cstddef>
+#include "common_financial_types.h"
+#include "thread_pool.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Number of calculations in each chunk of work on a thread pool.
+
+const std::size_t batch_chunk_size = 16384;
+
+
+//! Calculates many compounding factors.
+
+/*!
+ * Calculates `factors[i] = compound_factor(interest_rates[i],
+ * num_periods[i], dt)` for each `i`, as `exp(num_periods[i] *
+ * log1p(interest_rates[i]))` or `exp(num_periods[i] *
+ * interest_rates[i])`, with the SIMD kernel for the active instruction
+ * set. Every input class takes the same vectorized path, and the
+ * results agree with the scalar function to within a few units in the
+ * last place. The output array may be the same array as either input.
+ *
+ * \param interest_rates an array of `count` periodic interest rates,
+ * each greater than -1 for discrete compounding.
+ * \param num_periods an array of `count` numbers of periods.
+ * \param count the number of factors.
+ * \param factors an array of `count` doubles to receive the factors.
+ * \param dt the type of compounding to use.
+ */
+
+void compound_factor(const double * interest_rates,
+                     const double * num_periods,
+                     const std::size_t count,
+                     double * factors,
+                     const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates many compounding factors in parallel.
+
+/*!
+ * As the batch `compound_factor()`, sharing the calculations among the
+ * threads of a `ThreadPool` in chunks of `batch_chunk_size`. The results
+ * are identical to those of the single threaded overload.
+ */
+
+void compound_factor(const double * interest_rates,
+                     const double * num_periods,
+                     const std::size_t count,
+                     double * factors,
+                     ThreadPool& pool,
+                     const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates many discount factors.
+
+/*!
+ * As the batch `compound_factor()`, calculating `factors[i] =
+ * discount_factor(interest_rates[i], num_periods[i], dt)`.
+ *
+ * \param interest_rates an array of `count` periodic interest rates,
+ * each greater than -1 for discrete discounting.
+ * \param num_periods an array of `count` numbers of periods.
+ * \param count the number of factors.
+ * \param factors an array of `count` doubles to receive the factors.
+ * \param dt the type of discounting to use.
+ */
+
+void discount_factor(const double * interest_rates,
+                     const double * num_periods,
+                     const std::size_t count,
+                     double * factors,
+                     const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates many discount factors in parallel.
+
+/*!
+ * As the batch `discount_factor()`, sharing the calculations among the
+ * threads of a `ThreadPool` in chunks of `batch_chunk_size`. The results
+ * are identical to those of the single threaded overload.
+ */
+
+void discount_factor(const double * interest_rates,
+                     const double * num_periods,
+                     const std::size_t count,
+                     double * factors,
+                     ThreadPool& pool,
+                     const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the present values of many perpetuities.
+
+/*!
+ * Calculates `present_values[i] = pv_perpetuity(cashflows[i],
+ * interest_rates[i], types[i])` for each `i`. The arguments are
+ * parallel arrays, one element for each calculation, and the output
+ * array may be the same array as any of the inputs.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * std::vector<double> pvs(quotes.size());
+ * financial::pv_perpetuity(quotes.cashflows(), quotes.rates(),
+ *                          quotes.types(), quotes.size(), pvs.data());
+ * ~~~~
+ *
+ * \param cashflows an array of `count` periodic cash flow amounts.
+ * \param interest_rates an array of `count` periodic interest rates.
+ * \param types an array of `count` perpetuity types, which may be
+ * mixed, or null if every perpetuity is immediate.
+ * \param count the number of perpetuities.
+ * \param present_values an array of `count` doubles to receive the
+ * present values.
+ */
+
+void pv_perpetuity(const double * cashflows,
+                   const double * interest_rates,
+                   const annuity_type * types,
+                   const std::size_t count,
+                   double * present_values);
+
+
+//! Calculates the present values of many perpetuities in parallel.
+
+/*!
+ * As the batch `pv_perpetuity()`, sharing the calculations among the
+ * threads of a `ThreadPool` in chunks of `batch_chunk_size`. The results
+ * are identical to those of the single threaded overload.
+ */
+
+void pv_perpetuity(const double * cashflows,
+                   const double * interest_rates,
+                   const annuity_type * types,
+                   const std::size_t count,
+                   double * present_values,
+                   ThreadPool& pool);
+
+
+//! Calculates the present values of many annuities.
+
+/*!
+ * Calculates `present_values[i] = pv_annuity(cashflows[i],
+ * interest_rates[i], num_periods[i], types[i])` for each `i`. The
+ * annuity factors are evaluated by the SIMD kernel for the active
+ * instruction set as `-expm1(-n * log1p(r))`, as by the scalar
+ * function, so there is no cancellation for small rates or few
+ * periods, and the results agree with the scalar function to within a
+ * few units in the last place. The output array may be the same array
+ * as `cashflows` or `interest_rates`.
+ *
+ * \param cashflows an array of `count` periodic cash flow amounts.
+ * \param interest_rates an array of `count` periodic interest rates,
+ * each greater than -1.
+ * \param num_periods an array of `count` numbers of periodic cash
+ * flows.
+ * \param types an array of `count` annuity types, which may be mixed,
+ * or null if every annuity is immediate.
+ * \param count the number of annuities.
+ * \param present_values an array of `count` doubles to receive the
+ * present values.
+ */
+
+void pv_annuity(const double * cashflows,
+                const double * interest_rates,
+                const int * num_periods,
+                const annuity_type * types,
+                const std::size_t count,
+                double * present_values);
+
+
+//! Calculates the present values of many annuities in parallel.
+
+/*!
+ * As the batch `pv_annuity()`, sharing the calculations among the
+ * threads of a `ThreadPool` in chunks of `batch_chunk_size`. The results
+ * are identical to those of the single threaded overload.
+ */
+
+void pv_annuity(const double * cashflows,
+                const double * interest_rates,
+                const int * num_periods,
+                const annuity_type * types,
+                const std::size_t count,
+                double * present_values,
+                ThreadPool& pool);
+
+
+//! Calculates the periodic payments to many sinking funds.
+
+/*!
+ * Calculates `payments[i] = sinking_fund_payment(fund_values[i],
+ * interest_rates[i], num_periods[i])` for each `i`, with the growth
+ * factors evaluated by the SIMD kernel for the active instruction set
+ * as `expm1(n * log1p(r))`. As for the batch `pv_annuity()`, the
+ * results agree with the scalar function to within a few units in the
+ * last place. The output array may be the same array as any of the
+ * inputs.
+ *
+ * \param fund_values an array of `count` terminal fund values.
+ * \param interest_rates an array of `count` periodic interest rates,
+ * each greater than -1.
+ * \param num_periods an array of `count` numbers of periodic payments.
+ * \param count the number of sinking funds.
+ * \param payments an array of `count` doubles to receive the periodic
+ * payments.
+ */
+
+void sinking_fund_payment(const double * fund_values,
+                          const double * interest_rates,
+                          const double * num_periods,
+                          const std::size_t count,
+                          double * payments);
+
+
+//! Calculates the periodic payments to many sinking funds in parallel.
+
+/*!
+ * As the batch `sinking_fund_payment()`, sharing the calculations among
+ * the threads of a `ThreadPool` in chunks of `batch_chunk_size`. The
+ * results are identical to those of the single threaded overload.
+ */
+
+void sinking_fund_payment(const double * fund_values,
+                          const double * interest_rates,
+                          const double * num_periods,
+                          const std::size_t count,
+                          double * payments,
+                          ThreadPool& pool);
+
+
+//! Calculates the periodic repayments of many loans.
+
+/*!
+ * Calculates `repayments[i] = loan_repayment(loan_amounts[i],
+ * interest_rates[i], num_periods[i])` for each `i`, with the annuity
+ * factors evaluated by the SIMD kernel for the active instruction set
+ * as `-expm1(-n * log1p(r))`. As for the batch `pv_annuity()`, the
+ * results agree with the scalar function to within a few units in the
+ * last place. The output array may be the same array as any of the
+ * inputs.
+ *
+ * \param loan_amounts an array of `count` loan amounts.
+ * \param interest_rates an array of `count` periodic interest rates,
+ * each greater than -1.
+ * \param num_periods an array of `count` numbers of periodic
+ * repayments.
+ * \param count the number of loans.
+ * \param repayments an array of `count` doubles to receive the
+ * periodic repayments.
+ */
+
+void loan_repayment(const double * loan_amounts,
+                    const double * interest_rates,
+                    const double * num_periods,
+                    const std::size_t count,
+                    double * repayments);
+
+
+//! Calculates the periodic repayments of many loans in parallel.
+
+/*!
+ * As the batch `loan_repayment()`, sharing the calculations among the
+ * threads of a `ThreadPool` in chunks of `batch_chunk_size`. The results
+ * are identical to those of the single threaded overload.
+ */
+
+void loan_repayment(const double * loan_amounts,
+                    const double * interest_rates,
+                    const double * num_periods,
+                    const std::size_t count,
+                    double * repayments,
+                    ThreadPool& pool);
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_BATCH_DCF_H
@@ -0,0 +1,73 @@
+/*
+ *  bench_amortization.cpp
+ *  ======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for loan amortization schedules.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../amortization.h"
+#include "bench_util.h"
+
+namespace {
+
+const int num_periods = 360;
+
+//  Amortizes 1 to 10^4 loans one at a time, summing interest through
+//  the callback form.
+
+void BM_LoanAmortization_for_each_row(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<double> rates = bench::make_rates(n);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        double total_interest = 0;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            const financial::LoanAmortization loan(250000, rates[i] / 12,
+                                                   num_periods);
+            loan.for_each_row([&](const financial::AmortizationRow& row) {
+                total_interest += row.interest;
+            });
+        }
+        benchmark::DoNotOptimize(total_interest);
+    }
+    state.SetItemsProcessed(state.iterations() * n * num_periods);
+}
+BENCHMARK(BM_LoanAmortization_for_each_row)->RangeMultiplier(10)->
+    Range(1, 10000);
+
+//  Amortizes 1 to 10^4 loans as a batch.
+
+void BM_amortize_loans(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    std::vector<double> rates = bench::make_rates(n);
+    for ( std::size_t i = 0; i < n; ++i ) {
+        rates[i] /= 12;
+    }
+    const std::vector<double> amounts(n, 250000);
+    std::vector<double> payments(n * num_periods);
+    std::vector<double> interest(n * num_periods);
+    std::vector<double> principal(n * num_periods);
+    std::vector<double> balances(n * num_periods);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        financial::amortize_loans(amounts.data(), rates.data(), n,
+                                  num_periods, payments.data(),
+                                  interest.data(), principal.data(),
+                                  balances.data());
+        benchmark::DoNotOptimize(balances.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n * num_periods);
+}
+BENCHMARK(BM_amortize_loans)->RangeMultiplier(10)->Range(1, 10000);
+
+}           //  namespace
@@ -0,0 +1,77 @@
+/*
+ *  bench_arena.cpp
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for the arena allocator.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../arena.h"
+#include "../bond.h"
+#include "../cashflow_schedule.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Returns bonds with 10 to 30 year maturities and monthly to annual
+//  coupons.
+
+std::vector<financial::SimpleBond> make_bonds() {
+    const int frequencies[] = {1, 2, 4, 12};
+    std::vector<financial::SimpleBond> bonds;
+    for ( int i = 0; i < 64; ++i ) {
+        bonds.push_back(financial::SimpleBond(1000, 0.05, frequencies[i % 4],
+                                              10 + i % 21));
+    }
+    return bonds;
+}
+
+//  Builds, values and discards a schedule for each bond per request,
+//  on the heap; compare with BM_schedule_arena.
+
+void BM_schedule_heap(benchmark::State& state) {
+    const std::vector<financial::SimpleBond> bonds = make_bonds();
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        double total = 0;
+        for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+            financial::CashFlowSchedule sched(
+                    bonds[i].schedule(std::allocator<double>()));
+            total += financial::pv_stream(sched, 0.05);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * bonds.size());
+}
+BENCHMARK(BM_schedule_heap);
+
+void BM_schedule_arena(benchmark::State& state) {
+    const std::vector<financial::SimpleBond> bonds = make_bonds();
+    financial::MonotonicArena arena;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        const financial::ArenaAllocator<double> alloc(arena);
+        double total = 0;
+        for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+            const financial::ArenaCashFlowSchedule sched =
+                bonds[i].schedule(alloc);
+            total += financial::pv_stream(sched, 0.05);
+        }
+        benchmark::DoNotOptimize(total);
+        arena.release();
+    }
+    state.SetItemsProcessed(state.iterations() * bonds.size());
+}
+BENCHMARK(BM_schedule_arena);
+
+}           //  namespace
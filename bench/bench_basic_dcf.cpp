@@ -0,0 +1,295 @@
+/*
+ *  bench_basic_dcf.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for basic discounted cash flow functions.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../basic_dcf.h"
+#include "../batch_dcf.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Single-call functions. Each iteration makes one call, cycling
+//  through a set of interest rates and numbers of periods.
+
+const financial::disc_type disc_types[] = {
+    financial::disc_type::discrete, financial::disc_type::continuous
+};
+
+const financial::annuity_type annuity_types[] = {
+    financial::annuity_type::immediate, financial::annuity_type::due
+};
+
+void BM_compound_factor(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    const financial::disc_type dt = disc_types[state.range(0)];
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::compound_factor(rates[i],
+                                 1 + i % 30, dt));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_compound_factor)->Arg(0)->Arg(1);
+
+void BM_discount_factor(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    const financial::disc_type dt = disc_types[state.range(0)];
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::discount_factor(rates[i],
+                                 1 + i % 30, dt));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_discount_factor)->Arg(0)->Arg(1);
+
+//  Compounding factors by class of input - a few whole periods, up to
+//  360 whole periods, fractional periods, and continuous compounding -
+//  for the previous implementation with pow(), the current one, and
+//  the batch function. Each reports the largest and mean errors in
+//  ulps over its inputs, against a long double reference.
+
+const std::size_t num_compound_inputs = 1024;
+
+struct CompoundInputs {
+    explicit CompoundInputs(const int input_class) :
+        rates(bench::make_rates(num_compound_inputs)),
+        periods(num_compound_inputs),
+        dt(( input_class == 3 ) ? financial::disc_type::continuous :
+                                  financial::disc_type::discrete) {
+        for ( std::size_t i = 0; i < num_compound_inputs; ++i ) {
+            if ( input_class == 0 ) {
+                periods[i] = 1 + i % 4;
+            } else if ( input_class == 1 ) {
+                periods[i] = 1 + i % 360;
+            } else {
+                periods[i] = 0.37 * (1 + i % 97);
+            }
+        }
+    }
+
+    std::vector<double> rates;
+    std::vector<double> periods;
+    financial::disc_type dt;
+};
+
+double pow_compound_factor(const double interest_rate,
+                           const double num_periods,
+                           const financial::disc_type dt) {
+    if ( dt == financial::disc_type::discrete ) {
+        return std::pow(1 + interest_rate, num_periods);
+    } else {
+        return std::pow(financial::e, interest_rate * num_periods);
+    }
+}
+
+void report_ulps(benchmark::State& state, const CompoundInputs& in,
+                 const std::vector<double>& factors) {
+    double max_ulps = 0;
+    double total_ulps = 0;
+    for ( std::size_t i = 0; i < num_compound_inputs; ++i ) {
+        const long double rate = in.rates[i];
+        const long double log_growth =
+            ( in.dt == financial::disc_type::discrete ) ?
+            std::log1p(rate) : rate;
+        const double expected = static_cast<double>(
+                std::exp(in.periods[i] * log_growth));
+        const double ulp = std::nextafter(expected, 1e300) - expected;
+        const double ulps = std::fabs(factors[i] - expected) / ulp;
+        max_ulps = std::max(max_ulps, ulps);
+        total_ulps += ulps;
+    }
+    state.counters["max_ulps"] = max_ulps;
+    state.counters["mean_ulps"] = total_ulps / num_compound_inputs;
+}
+
+void BM_compound_factor_pow(benchmark::State& state) {
+    const CompoundInputs in(static_cast<int>(state.range(0)));
+    std::vector<double> factors(num_compound_inputs);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < num_compound_inputs; ++i ) {
+            factors[i] = pow_compound_factor(in.rates[i], in.periods[i],
+                                             in.dt);
+        }
+        benchmark::DoNotOptimize(factors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_compound_inputs);
+    report_ulps(state, in, factors);
+}
+BENCHMARK(BM_compound_factor_pow)->DenseRange(0, 3);
+
+void BM_compound_factor_class(benchmark::State& state) {
+    const CompoundInputs in(static_cast<int>(state.range(0)));
+    std::vector<double> factors(num_compound_inputs);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < num_compound_inputs; ++i ) {
+            factors[i] = financial::compound_factor(in.rates[i],
+                                                    in.periods[i], in.dt);
+        }
+        benchmark::DoNotOptimize(factors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_compound_inputs);
+    report_ulps(state, in, factors);
+}
+BENCHMARK(BM_compound_factor_class)->DenseRange(0, 3);
+
+void BM_compound_factor_batch(benchmark::State& state) {
+    const CompoundInputs in(static_cast<int>(state.range(0)));
+    std::vector<double> factors(num_compound_inputs);
+    for ( auto _ : state ) {
+        financial::compound_factor(in.rates.data(), in.periods.data(),
+                                   num_compound_inputs, factors.data(),
+                                   in.dt);
+        benchmark::DoNotOptimize(factors.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_compound_inputs);
+    report_ulps(state, in, factors);
+}
+BENCHMARK(BM_compound_factor_batch)->DenseRange(0, 3);
+
+void BM_pv(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    const financial::disc_type dt = disc_types[state.range(0)];
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv(100, rates[i],
+                                 1 + i % 30, dt));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_pv)->Arg(0)->Arg(1);
+
+void BM_fv(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    const financial::disc_type dt = disc_types[state.range(0)];
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::fv(100, rates[i],
+                                 1 + i % 30, dt));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_fv)->Arg(0)->Arg(1);
+
+void BM_pv_perpetuity(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    const financial::annuity_type at = annuity_types[state.range(0)];
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_perpetuity(100, rates[i], at));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_pv_perpetuity)->Arg(0)->Arg(1);
+
+void BM_pv_annuity(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    const financial::annuity_type at = annuity_types[state.range(0)];
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_annuity(100, rates[i],
+                                 1 + i % 30, at));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_pv_annuity)->Arg(0)->Arg(1);
+
+void BM_sinking_fund_payment(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::sinking_fund_payment(10000,
+                                 rates[i], 1 + i % 30));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_sinking_fund_payment);
+
+void BM_loan_repayment(benchmark::State& state) {
+    const std::vector<double> rates = bench::make_rates(bench::num_inputs);
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::loan_repayment(80000,
+                                 rates[i] / 12, 1 + i % 360));
+        i = (i + 1) % bench::num_inputs;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_loan_repayment);
+
+//  Stream functions, over 1 to 10^7 cash flows.
+
+void BM_pv_stream(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<financial::TimedCashFlow> cashflows =
+        bench::make_cashflows(n);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_stream(cashflows, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_pv_stream)->RangeMultiplier(10)->Range(1, 10000000);
+
+//  Values 10^6 cash flows with each summation policy; compare with
+//  BM_pv_stream/1000000.
+
+template <class Accumulation>
+void BM_pv_stream_accumulation(benchmark::State& state) {
+    const std::size_t n = 1000000;
+    const std::vector<financial::TimedCashFlow> cashflows =
+        bench::make_cashflows(n);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(
+                financial::pv_stream<Accumulation>(cashflows, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_pv_stream_accumulation, financial::NaiveSum);
+BENCHMARK_TEMPLATE(BM_pv_stream_accumulation, financial::NeumaierSum);
+BENCHMARK_TEMPLATE(BM_pv_stream_accumulation, financial::PairwiseSum);
+
+void BM_price_and_risk(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<financial::TimedCashFlow> cashflows =
+        bench::make_cashflows(n);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::price_and_risk(cashflows, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_price_and_risk)->RangeMultiplier(10)->Range(1, 10000000);
+
+}           //  namespace
@@ -0,0 +1,150 @@
+/*
+ *  bench_batch_dcf.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmarks for batch discounted cash flow functions, against loops
+ *  over the scalar functions.
+ *
+ *  Uses Google benchmark library.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../basic_dcf.h"
+#include "../thread_pool.h"
+#include "../batch_dcf.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Number of quotes in each batch.
+
+const std::size_t num_quotes = 1 << 16;
+
+//  Columnar quotes: 30 year monthly loans and annuities at rates from
+//  1% to 10%, half of the annuities due.
+
+struct Quotes {
+    Quotes() : amounts(num_quotes), rates(bench::make_rates(num_quotes)),
+               periods(num_quotes), int_periods(num_quotes),
+               types(num_quotes) {
+        for ( std::size_t i = 0; i < num_quotes; ++i ) {
+            amounts[i] = 100000 + 100 * (i % 997);
+            rates[i] /= 12;
+            int_periods[i] = static_cast<int>(12 + i % 349);
+            periods[i] = int_periods[i];
+            types[i] = ( i % 2 ) ? financial::annuity_type::due :
+                                   financial::annuity_type::immediate;
+        }
+    }
+
+    std::vector<double> amounts;
+    std::vector<double> rates;
+    std::vector<double> periods;
+    std::vector<int> int_periods;
+    std::vector<financial::annuity_type> types;
+};
+
+//  Values the annuities one at a time with the scalar function.
+
+void BM_pv_annuity_loop(benchmark::State& state) {
+    const Quotes q;
+    std::vector<double> results(num_quotes);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < num_quotes; ++i ) {
+            results[i] = financial::pv_annuity(q.amounts[i], q.rates[i],
+                                               q.int_periods[i], q.types[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_quotes);
+}
+BENCHMARK(BM_pv_annuity_loop);
+
+//  Values the annuities as a batch.
+
+void BM_pv_annuity_batch(benchmark::State& state) {
+    const Quotes q;
+    std::vector<double> results(num_quotes);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        financial::pv_annuity(q.amounts.data(), q.rates.data(),
+                              q.int_periods.data(), q.types.data(),
+                              num_quotes, results.data());
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_quotes);
+}
+BENCHMARK(BM_pv_annuity_batch);
+
+//  Values the annuities as a batch on a pool of the given number of
+//  threads.
+
+void BM_pv_annuity_batch_pool(benchmark::State& state) {
+    const Quotes q;
+    std::vector<double> results(num_quotes);
+    financial::ThreadPool pool(static_cast<unsigned>(state.range(0)));
+    for ( auto _ : state ) {
+        financial::pv_annuity(q.amounts.data(), q.rates.data(),
+                              q.int_periods.data(), q.types.data(),
+                              num_quotes, results.data(), pool);
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_quotes);
+}
+BENCHMARK(BM_pv_annuity_batch_pool)->Arg(1)->Arg(2)->Arg(4);
+
+//  Calculates the loan repayments one at a time with the scalar
+//  function.
+
+void BM_loan_repayment_loop(benchmark::State& state) {
+    const Quotes q;
+    std::vector<double> results(num_quotes);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < num_quotes; ++i ) {
+            results[i] = financial::loan_repayment(q.amounts[i], q.rates[i],
+                                                   q.periods[i]);
+        }
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_quotes);
+}
+BENCHMARK(BM_loan_repayment_loop);
+
+//  Calculates the loan repayments as a batch.
+
+void BM_loan_repayment_batch(benchmark::State& state) {
+    const Quotes q;
+    std::vector<double> results(num_quotes);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        financial::loan_repayment(q.amounts.data(), q.rates.data(),
+                                  q.periods.data(), num_quotes,
+                                  results.data());
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_quotes);
+}
+BENCHMARK(BM_loan_repayment_batch);
+
+//  Values the perpetuities as a batch.
+
+void BM_pv_perpetuity_batch(benchmark::State& state) {
+    const Quotes q;
+    std::vector<double> results(num_quotes);
+    for ( auto _ : state ) {
+        financial::pv_perpetuity(q.amounts.data(), q.rates.data(),
+                                 q.types.data(), num_quotes, results.data());
+        benchmark::DoNotOptimize(results.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_quotes);
+}
+BENCHMARK(BM_pv_perpetuity_batch);
+
+}           //  namespace
@@ -0,0 +1,118 @@
+/*
+ *  bench_bond.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for bond valuation.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../bond.h"
+#include "../portfolio.h"
+#include "../thread_pool.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Returns a set of bonds with a spread of coupons, frequencies and
+//  maturities.
+
+std::vector<financial::SimpleBond> make_bonds(const std::size_t n) {
+    const int frequencies[] = {1, 2, 4, 12};
+    std::vector<financial::SimpleBond> bonds;
+    bonds.reserve(n);
+    for ( std::size_t i = 0; i < n; ++i ) {
+        bonds.push_back(financial::SimpleBond(1000, 0.02 + 0.001 * (i % 50),
+                                              frequencies[i % 4],
+                                              1 + i % 30));
+    }
+    return bonds;
+}
+
+//  Values 1 to 10^6 bonds one at a time.
+
+void BM_SimpleBond_value(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<financial::SimpleBond> bonds = make_bonds(n);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        double total = 0;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            total += bonds[i].value(0.045);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_SimpleBond_value)->RangeMultiplier(10)->Range(1, 1000000);
+
+//  Values 1 to 10^6 bonds held in a portfolio.
+
+void BM_Portfolio_value(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<financial::SimpleBond> bonds = make_bonds(n);
+    financial::Portfolio book;
+    for ( std::size_t i = 0; i < n; ++i ) {
+        book.add(bonds[i], 10);
+    }
+    financial::ThreadPool pool;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(book.value(0.045, pool).total);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_Portfolio_value)->RangeMultiplier(10)->Range(1, 1000000);
+
+void BM_SimpleBond_price_and_risk(benchmark::State& state) {
+    const financial::SimpleBond bond(1000, 0.05, 2, 10);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(bond.price_and_risk(0.045));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimpleBond_price_and_risk);
+
+void BM_SimpleBond_yield_to_maturity(benchmark::State& state) {
+    const financial::SimpleBond bond(1000, 0.05, 2, 10);
+    const double price = bond.value(0.045);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(bond.yield_to_maturity(price));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimpleBond_yield_to_maturity);
+
+//  Revalues a book of seasoned bonds at a settlement time, from their
+//  cached schedules.
+
+void BM_SimpleBond_clean_price(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<financial::SimpleBond> bonds = make_bonds(n);
+    for ( std::size_t i = 0; i < n; ++i ) {
+        bonds[i].schedule();
+    }
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        double total = 0;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            const double settlement = 0.37 * (i % 3) * bonds[i].maturity();
+            total += bonds[i].clean_price(0.045, settlement);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_SimpleBond_clean_price)->RangeMultiplier(100)->Range(1, 10000);
+
+}           //  namespace
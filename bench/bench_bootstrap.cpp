@@ -0,0 +1,65 @@
+/*
+ *  bench_bootstrap.cpp
+ *  ===================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for yield curve bootstrapping.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../bond.h"
+#include "../bootstrap.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Returns semi-annual par bonds maturing in one to thirty years.
+
+std::vector<financial::SimpleBond> make_bonds() {
+    std::vector<financial::SimpleBond> bonds;
+    for ( int m = 1; m <= 30; ++m ) {
+        bonds.push_back(financial::SimpleBond(100, 0.03 + 0.0005 * m,
+                                              2, m));
+    }
+    return bonds;
+}
+
+void BM_CurveBootstrapper_build(benchmark::State& state) {
+    const std::vector<financial::SimpleBond> bonds = make_bonds();
+    const std::vector<double> prices(bonds.size(), 100);
+    for ( auto _ : state ) {
+        financial::CurveBootstrapper bootstrapper(bonds, prices);
+        benchmark::DoNotOptimize(bootstrapper.curve().size());
+    }
+    state.SetItemsProcessed(state.iterations() * bonds.size());
+}
+BENCHMARK(BM_CurveBootstrapper_build);
+
+//  Updates the price of the bond with the given index, re-solving it
+//  and every pillar after it.
+
+void BM_CurveBootstrapper_set_price(benchmark::State& state) {
+    const std::vector<financial::SimpleBond> bonds = make_bonds();
+    const std::vector<double> prices(bonds.size(), 100);
+    financial::CurveBootstrapper bootstrapper(bonds, prices);
+    const std::size_t index = static_cast<std::size_t>(state.range(0));
+    double bump = 0.01;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(bootstrapper.set_price(index,
+                                                        100 + bump));
+        bump = -bump;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_CurveBootstrapper_set_price)->Arg(0)->Arg(14)->Arg(29);
+
+}           //  namespace
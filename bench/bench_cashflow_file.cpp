@@ -0,0 +1,50 @@
+/*
+ *  bench_cashflow_file.cpp
+ *  =======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for binary cash flow files.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <benchmark/benchmark.h>
+#include "../cashflow_schedule.h"
+#include "../cashflow_file.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Maps and values a file of 10^3 to 10^7 cash flows. The file is in
+//  the page cache, so this measures mapping and memory bandwidth rather
+//  than disk speed; compare with BM_pv_stream_schedule.
+
+void BM_MappedCashFlowFile_pv_stream(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::string filename = "/tmp/financial_bench_" +
+                                 std::to_string(getpid());
+    financial::write_cashflow_file(filename, financial::CashFlowSchedule(
+                                   bench::make_cashflows(n)));
+    {
+        bench::AllocationReporter allocs(state);
+        for ( auto _ : state ) {
+            const financial::MappedCashFlowFile file(filename);
+            benchmark::DoNotOptimize(financial::pv_stream(file.view(), 0.05));
+        }
+    }
+    std::remove(filename.c_str());
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * 2 * sizeof(double));
+}
+BENCHMARK(BM_MappedCashFlowFile_pv_stream)->RangeMultiplier(10)->
+    Range(1000, 10000000);
+
+}           //  namespace
@@ -0,0 +1,183 @@
+/*
+ *  bench_cashflow_schedule.cpp
+ *  ===========================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for cash flow schedules and discount tables.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../basic_dcf.h"
+#include "../cashflow_schedule.h"
+#include "../cashflow_range.h"
+#include "../discount_table.h"
+#include "../thread_pool.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Values 1 to 10^7 cash flows held in a schedule; compare with
+//  BM_pv_stream for the same flows held as TimedCashFlow structs.
+
+void BM_pv_stream_schedule(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const financial::CashFlowSchedule schedule(bench::make_cashflows(n));
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_stream(schedule, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_pv_stream_schedule)->RangeMultiplier(10)->Range(1, 10000000);
+
+//  Values 10^6 cash flows in a schedule with each summation policy;
+//  compare with BM_pv_stream_schedule/1000000.
+
+template <class Accumulation>
+void BM_pv_stream_schedule_accumulation(benchmark::State& state) {
+    const std::size_t n = 1000000;
+    const financial::CashFlowSchedule schedule(bench::make_cashflows(n));
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(
+                financial::pv_stream<Accumulation>(schedule, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK_TEMPLATE(BM_pv_stream_schedule_accumulation, financial::NaiveSum);
+BENCHMARK_TEMPLATE(BM_pv_stream_schedule_accumulation,
+                   financial::NeumaierSum);
+BENCHMARK_TEMPLATE(BM_pv_stream_schedule_accumulation,
+                   financial::PairwiseSum);
+
+//  Values 10^7 cash flows in chunks on pools of 1, 2, 4 and 8
+//  threads; compare with BM_pv_stream_schedule/10000000.
+
+void BM_pv_stream_schedule_parallel(benchmark::State& state) {
+    const std::size_t n = 10000000;
+    const financial::CashFlowSchedule schedule(bench::make_cashflows(n));
+    financial::ThreadPool pool(static_cast<unsigned>(state.range(0)));
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_stream(schedule, 0.05,
+                                                      pool));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_pv_stream_schedule_parallel)->Arg(1)->Arg(2)->Arg(4)->Arg(8)
+    ->UseRealTime();
+
+//  Values a schedule at 32 rates in one call, and in 32 calls.
+
+const std::size_t num_scenarios = 32;
+
+void BM_pv_stream_schedule_multi(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const financial::CashFlowSchedule schedule(bench::make_cashflows(n));
+    const std::vector<double> rates = bench::make_rates(num_scenarios);
+    std::vector<double> values(num_scenarios);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        financial::pv_stream(schedule, rates.data(), rates.size(),
+                             values.data());
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n * num_scenarios);
+}
+BENCHMARK(BM_pv_stream_schedule_multi)->RangeMultiplier(10)->
+    Range(1, 1000000);
+
+void BM_pv_stream_schedule_loop(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const financial::CashFlowSchedule schedule(bench::make_cashflows(n));
+    const std::vector<double> rates = bench::make_rates(num_scenarios);
+    std::vector<double> values(num_scenarios);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < rates.size(); ++i ) {
+            values[i] = financial::pv_stream(schedule, rates[i]);
+        }
+        benchmark::DoNotOptimize(values.data());
+    }
+    state.SetItemsProcessed(state.iterations() * n * num_scenarios);
+}
+BENCHMARK(BM_pv_stream_schedule_loop)->RangeMultiplier(10)->
+    Range(1, 1000000);
+
+//  Values 1 to 10^7 cash flows held in records with other fields,
+//  through a strided view and by copying them into a vector first.
+
+struct Position {
+    int id;
+    double amount;
+    double time;
+    char desk[16];
+};
+
+std::vector<Position> make_positions(const std::size_t n) {
+    const std::vector<financial::TimedCashFlow> cashflows =
+        bench::make_cashflows(n);
+    std::vector<Position> positions(n);
+    for ( std::size_t i = 0; i < n; ++i ) {
+        positions[i].id = static_cast<int>(i);
+        positions[i].amount = cashflows[i].amount;
+        positions[i].time = cashflows[i].time_period;
+    }
+    return positions;
+}
+
+void BM_pv_stream_strided(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<Position> positions = make_positions(n);
+    const financial::StridedCashFlowView view =
+        financial::make_strided_view(positions.data(), n,
+                                     &Position::amount, &Position::time);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_stream(view, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_pv_stream_strided)->RangeMultiplier(10)->Range(1, 10000000);
+
+void BM_pv_stream_copied(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const std::vector<Position> positions = make_positions(n);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        std::vector<financial::TimedCashFlow> cashflows;
+        cashflows.reserve(n);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            cashflows.push_back(financial::TimedCashFlow(
+                                positions[i].amount, positions[i].time));
+        }
+        benchmark::DoNotOptimize(financial::pv_stream(cashflows, 0.05));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_pv_stream_copied)->RangeMultiplier(10)->Range(1, 10000000);
+
+//  Looks up monthly discount factors in a table; compare with
+//  BM_discount_factor.
+
+void BM_DiscountTable_discount_factor(benchmark::State& state) {
+    const financial::DiscountTable table(0.0035, 360);
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(table.discount_factor(1 + i));
+        i = (i + 1) % 360;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DiscountTable_discount_factor);
+
+}           //  namespace
@@ -0,0 +1,129 @@
+/*
+ *  bench_dates.cpp
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmarks for day count conversions and holiday calendars, against
+ *  converting dates with calendar arithmetic.
+ *
+ *  Uses Google benchmark library.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../calendar.h"
+#include "../dates.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Number of dates in each batch.
+
+const std::size_t num_dates = 1 << 20;
+
+//  Returns payment dates spread over the thirty years after the start
+//  date.
+
+std::vector<financial::Date> make_dates(const financial::Date start) {
+    std::vector<financial::Date> dates(num_dates);
+    for ( std::size_t i = 0; i < num_dates; ++i ) {
+        dates[i] = start.add_days(static_cast<int>((i * 7919) % 10957));
+    }
+    return dates;
+}
+
+//  Converts a serial date to its calendar fields arithmetically, as
+//  a date library without tables would.
+
+void civil_from_serial(const int serial, int& year, int& month, int& day) {
+    const int z = serial + 693901;
+    const int era = z / 146097;
+    const int doe = z - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+//  Converts the dates to 30/360 year fractions with calendar
+//  arithmetic.
+
+void BM_year_fractions_arithmetic(benchmark::State& state) {
+    const financial::Date start(2013, 6, 28);
+    const std::vector<financial::Date> dates = make_dates(start);
+    std::vector<double> fractions(num_dates);
+    int y1, m1, d1;
+    civil_from_serial(start.serial(), y1, m1, d1);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < num_dates; ++i ) {
+            int y2, m2, d2;
+            civil_from_serial(dates[i].serial(), y2, m2, d2);
+            const int start_day = d1 == 31 ? 30 : d1;
+            const int end_day = (d2 == 31 && start_day == 30) ? 30 : d2;
+            fractions[i] = (360 * (y2 - y1) + 30 * (m2 - m1) +
+                            (end_day - start_day)) / 360.0;
+        }
+        benchmark::DoNotOptimize(fractions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_dates);
+}
+BENCHMARK(BM_year_fractions_arithmetic);
+
+//  Converts the dates to year fractions under each convention, from
+//  the date table.
+
+void BM_year_fractions(benchmark::State& state) {
+    const financial::day_count conventions[] = {
+        financial::day_count::act_360,
+        financial::day_count::act_365_fixed,
+        financial::day_count::act_act_isda,
+        financial::day_count::thirty_360,
+        financial::day_count::thirty_e_360
+    };
+    const financial::day_count dc = conventions[state.range(0)];
+    const financial::Date start(2013, 6, 28);
+    const std::vector<financial::Date> dates = make_dates(start);
+    std::vector<double> fractions(num_dates);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        financial::year_fractions(start, dates.data(), num_dates, dc,
+                                  fractions.data());
+        benchmark::DoNotOptimize(fractions.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_dates);
+}
+BENCHMARK(BM_year_fractions)->DenseRange(0, 4);
+
+//  Adjusts the dates to business days.
+
+void BM_HolidayCalendar_adjust(benchmark::State& state) {
+    const financial::Date start(2013, 6, 28);
+    const std::vector<financial::Date> dates = make_dates(start);
+    std::vector<financial::Date> holidays;
+    for ( int year = 2013; year <= 2043; ++year ) {
+        holidays.push_back(financial::Date(year, 1, 1));
+        holidays.push_back(financial::Date(year, 7, 4));
+        holidays.push_back(financial::Date(year, 12, 25));
+    }
+    const financial::HolidayCalendar cal(holidays);
+    std::vector<financial::Date> adjusted(num_dates);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        for ( std::size_t i = 0; i < num_dates; ++i ) {
+            adjusted[i] = cal.adjust(dates[i],
+                financial::business_day::modified_following);
+        }
+        benchmark::DoNotOptimize(adjusted.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_dates);
+}
+BENCHMARK(BM_HolidayCalendar_adjust);
+
+}           //  namespace
@@ -0,0 +1,143 @@
+/*
+ *  bench_instruments.cpp
+ *  =====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Benchmarks for valuing a mixed book of coupon bonds by type, against
+ *  valuing it through a virtual function for each bond.
+ *
+ *  Uses Google benchmark library.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../instruments.h"
+#include "../thread_pool.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Number of positions in the book.
+
+const std::size_t num_bonds = 100000;
+
+//  A bond valued through a virtual function, as a conventional class
+//  hierarchy would value it.
+
+class VirtualBond {
+    public:
+        virtual ~VirtualBond() {}
+        virtual double value(const double discount_rate) const = 0;
+};
+
+template <class Bond>
+class VirtualBondOf : public VirtualBond {
+    public:
+        explicit VirtualBondOf(const Bond& bond) : m_bond(bond) {}
+        double value(const double discount_rate) const {
+            return m_bond.value(discount_rate);
+        }
+
+    private:
+        Bond m_bond;
+};
+
+//  Calls a function with each bond of a mixed book, with the types
+//  in a scrambled order.
+
+template <class Function>
+void make_bonds(const Function& function) {
+    const int frequencies[] = {1, 2, 4, 12};
+    std::vector<double> coupons;
+    coupons.push_back(0.02);
+    coupons.push_back(0.03);
+    coupons.push_back(0.045);
+    for ( std::size_t i = 0; i < num_bonds; ++i ) {
+        const std::size_t k = (i * 7919) % num_bonds;
+        const int frequency = frequencies[k % 4];
+        const int maturity = 1 + static_cast<int>(k % 10);
+        switch ( (k / 4) % 4 ) {
+            case 0:
+                function(financial::FixedRateBond(1000, 0.04, frequency,
+                                                  maturity));
+                break;
+            case 1:
+                function(financial::FloatingRateNote(1000, 0.002, frequency,
+                                                     maturity));
+                break;
+            case 2:
+                function(financial::StepUpBond(1000, coupons, frequency,
+                                               maturity));
+                break;
+            default:
+                function(financial::AmortizingBond(1000, 0.05, frequency,
+                                                   maturity));
+                break;
+        }
+    }
+}
+
+//  Collects bonds into a vector of virtual bonds.
+
+struct VirtualCollector {
+    explicit VirtualCollector(std::vector<std::unique_ptr<VirtualBond> >&
+                              bonds) : bonds(bonds) {}
+    template <class Bond>
+    void operator()(const Bond& bond) const {
+        bonds.push_back(std::unique_ptr<VirtualBond>(
+                new VirtualBondOf<Bond>(bond)));
+    }
+    std::vector<std::unique_ptr<VirtualBond> >& bonds;
+};
+
+//  Collects bonds into a book.
+
+struct BookCollector {
+    explicit BookCollector(financial::InstrumentBook& book) : book(book) {}
+    template <class Bond>
+    void operator()(const Bond& bond) const {
+        book.add(bond, 10);
+    }
+    financial::InstrumentBook& book;
+};
+
+//  Values the book one bond at a time through a virtual function.
+
+void BM_virtual_bonds_value(benchmark::State& state) {
+    std::vector<std::unique_ptr<VirtualBond> > bonds;
+    make_bonds(VirtualCollector(bonds));
+    std::vector<double> values(bonds.size());
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        double total = 0;
+        for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+            values[i] = 10 * bonds[i]->value(0.045);
+            total += values[i];
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * num_bonds);
+}
+BENCHMARK(BM_virtual_bonds_value);
+
+//  Values the book by type, on pools of 1, 2 and 4 threads.
+
+void BM_InstrumentBook_value(benchmark::State& state) {
+    financial::InstrumentBook book;
+    make_bonds(BookCollector(book));
+    financial::ThreadPool pool(static_cast<unsigned>(state.range(0)));
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(book.value(0.045, pool).total);
+    }
+    state.SetItemsProcessed(state.iterations() * num_bonds);
+}
+BENCHMARK(BM_InstrumentBook_value)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+
+}           //  namespace
@@ -0,0 +1,63 @@
+/*
+ *  bench_irr.cpp
+ *  =============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for internal rate of return functions.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../cashflow_schedule.h"
+#include "../thread_pool.h"
+#include "../irr.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Returns an investment of 1000 followed by n returns.
+
+std::vector<financial::TimedCashFlow> make_project(const std::size_t n) {
+    std::vector<financial::TimedCashFlow> cashflows;
+    cashflows.push_back(financial::TimedCashFlow(-1000, 0));
+    for ( std::size_t i = 1; i <= n; ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(150 + i % 11, i));
+    }
+    return cashflows;
+}
+
+//  Solves the IRR of a stream of 10 to 10^5 cash flows.
+
+void BM_irr(benchmark::State& state) {
+    const std::vector<financial::TimedCashFlow> cashflows =
+        make_project(static_cast<std::size_t>(state.range(0)));
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::irr(cashflows));
+    }
+    state.SetItemsProcessed(state.iterations() * cashflows.size());
+}
+BENCHMARK(BM_irr)->RangeMultiplier(10)->Range(10, 100000);
+
+//  Solves the IRRs of 10 to 10^4 streams of 40 cash flows on a pool
+//  of the given number of threads.
+
+void BM_irr_batch(benchmark::State& state) {
+    const std::vector<std::vector<financial::TimedCashFlow> > streams(
+            static_cast<std::size_t>(state.range(0)), make_project(40));
+    financial::ThreadPool pool(static_cast<unsigned>(state.range(1)));
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::irr(streams, pool));
+    }
+    state.SetItemsProcessed(state.iterations() * streams.size());
+}
+BENCHMARK(BM_irr_batch)->RangeMultiplier(10)->Ranges({{10, 10000}, {1, 4}});
+
+}           //  namespace
@@ -0,0 +1,19 @@
+/*
+ *  bench_main.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Main function for benchmarks.
+ *
+ *  Uses Google benchmark library. Run with --benchmark_filter=<regex>
+ *  to select benchmarks, and --benchmark_out=<file> with
+ *  --benchmark_out_format=json for machine-readable results.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <benchmark/benchmark.h>
+
+BENCHMARK_MAIN();
@@ -0,0 +1,49 @@
+/*
+ *  bench_rate_simulation.cpp
+ *  =========================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for Monte Carlo interest rate simulation.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../cashflow_schedule.h"
+#include "../thread_pool.h"
+#include "../yield_curve.h"
+#include "../rate_simulation.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Values a 30 year semi-annual bond on 10^4 monthly paths, on a pool
+//  of the given number of threads. Paths per second should scale with
+//  the number of cores.
+
+void BM_RateSimulation_pv_stream(benchmark::State& state) {
+    const std::vector<double> times = {1, 2, 5, 10, 30};
+    const std::vector<double> zeros = {0.033, 0.036, 0.041, 0.044, 0.045};
+    const financial::ShortRateModel model(
+            financial::YieldCurve::from_zero_rates(times, zeros), 0.1, 0.01);
+    const financial::RateSimulation sim(model, 30, 12, 10000, 42);
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i <= 60; ++i ) {
+        sched.add(i == 60 ? 1025 : 25, 0.5 * i);
+    }
+    financial::ThreadPool pool(static_cast<unsigned>(state.range(0)));
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(sim.pv_stream(sched, pool).mean);
+    }
+    state.SetItemsProcessed(state.iterations() * sim.num_paths());
+}
+BENCHMARK(BM_RateSimulation_pv_stream)->Arg(1)->Arg(2)->Arg(4)
+    ->UseRealTime();
+
+}           //  namespace
@@ -0,0 +1,78 @@
+/*
+ *  bench_util.h
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Shared helpers for benchmarks.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#ifndef PG_FINANCIAL_BENCH_BENCH_UTIL_H
+#define PG_FINANCIAL_BENCH_BENCH_UTIL_H
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../tests/alloc_counter.h"
+#include "../common_financial_types.h"
+
+namespace bench {
+
+//  Reports heap allocations per iteration as the "allocs/op" counter.
+//  Construct immediately before the timing loop, after any setup.
+
+class AllocationReporter {
+    public:
+        explicit AllocationReporter(benchmark::State& state) :
+            m_state(state), m_start(alloc_counter::allocations()) {}
+
+        ~AllocationReporter() {
+            const double allocs = static_cast<double>(
+                    alloc_counter::allocations() - m_start);
+            m_state.counters["allocs/op"] =
+                benchmark::Counter(allocs,
+                                   benchmark::Counter::kAvgIterations);
+        }
+
+    private:
+        AllocationReporter(const AllocationReporter&);
+        AllocationReporter& operator=(const AllocationReporter&);
+
+        benchmark::State& m_state;
+        std::size_t m_start;
+};
+
+//  Number of distinct inputs cycled through by single-call benchmarks,
+//  so that the compiler cannot hoist the call out of the loop.
+
+const std::size_t num_inputs = 64;
+
+//  Returns a spread of interest rates between 1% and 10%.
+
+inline std::vector<double> make_rates(const std::size_t n) {
+    std::vector<double> rates(n);
+    for ( std::size_t i = 0; i < n; ++i ) {
+        rates[i] = 0.01 + 0.09 * static_cast<double>(i) / n;
+    }
+    return rates;
+}
+
+//  Returns a stream of cash flows spread over thirty years.
+
+inline std::vector<financial::TimedCashFlow> make_cashflows(const
+                                                            std::size_t n) {
+    std::vector<financial::TimedCashFlow> cashflows;
+    cashflows.reserve(n);
+    for ( std::size_t i = 0; i < n; ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(100 + i % 7,
+                                                     0.5 * (1 + i % 60)));
+    }
+    return cashflows;
+}
+
+}               //  namespace bench
+
+#endif          //  PG_FINANCIAL_BENCH_BENCH_UTIL_H
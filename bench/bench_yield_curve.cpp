@@ -0,0 +1,82 @@
+/*
+ *  bench_yield_curve.cpp
+ *  =====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Benchmarks for yield curves.
+ *
+ *  Uses Google benchmark library.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include "../bond.h"
+#include "../cashflow_schedule.h"
+#include "../yield_curve.h"
+#include "bench_util.h"
+
+namespace {
+
+//  Returns a curve with pillars from three months to thirty years.
+
+financial::YieldCurve make_curve(const financial::curve_interpolation
+                                 interpolation) {
+    const std::vector<double> times = {0.25, 0.5, 1, 2, 3, 5, 7, 10, 20, 30};
+    const std::vector<double> zeros = {0.030, 0.031, 0.033, 0.036, 0.038,
+                                       0.041, 0.043, 0.044, 0.046, 0.045};
+    return financial::YieldCurve::from_zero_rates(times, zeros,
+                                                  interpolation);
+}
+
+const financial::curve_interpolation interpolations[] = {
+    financial::curve_interpolation::log_linear,
+    financial::curve_interpolation::monotone_cubic
+};
+
+void BM_YieldCurve_discount_factor(benchmark::State& state) {
+    const financial::YieldCurve curve = make_curve(
+            interpolations[state.range(0)]);
+    std::size_t i = 0;
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(curve.discount_factor(0.125 * (1 + i)));
+        i = (i + 1) % 240;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_YieldCurve_discount_factor)->Arg(0)->Arg(1);
+
+//  Values 1 to 10^7 cash flows against a curve; compare with
+//  BM_pv_stream_schedule at a flat rate.
+
+void BM_pv_stream_curve(benchmark::State& state) {
+    const std::size_t n = static_cast<std::size_t>(state.range(0));
+    const financial::CashFlowSchedule schedule(bench::make_cashflows(n));
+    const financial::YieldCurve curve = make_curve(
+            financial::curve_interpolation::monotone_cubic);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(financial::pv_stream(schedule, curve));
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_pv_stream_curve)->RangeMultiplier(10)->Range(1, 10000000);
+
+void BM_SimpleBond_value_curve(benchmark::State& state) {
+    const financial::SimpleBond bond(1000, 0.05, 2, 30);
+    const financial::YieldCurve curve = make_curve(
+            financial::curve_interpolation::monotone_cubic);
+    bench::AllocationReporter allocs(state);
+    for ( auto _ : state ) {
+        benchmark::DoNotOptimize(bond.value(curve));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SimpleBond_value_curve);
+
+}           //  namespace
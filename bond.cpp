@@ -8,32 +8,275 @@
  */
 
 #include <cmath>
+#include <mutex>
+#include <limits>
+#include <stdexcept>
 #include "common_financial_types.h"
 #include "basic_dcf.h"
 #include "bond.h"
+#include "instrumentation.h"
 
 using namespace financial;
 
-double SimpleBond::value(const double discount_rate) const {
-    double ret_value = 0;
+void financial::detail::check_bond_terms(const int coupon_frequency,
+                                         const int maturity) {
+    if ( coupon_frequency < 0 ) {
+        throw std::domain_error("coupon frequency must not be negative");
+    }
+    if ( maturity < 1 ) {
+        throw std::domain_error("maturity must be at least one period");
+    }
+}
 
-    if ( m_coupon_frequency ) {
-        std::vector<TimedCashFlow> tcf;
-        const double cpymt = m_principal * m_coupon / m_coupon_frequency;
-        const double periods = num_payments();
+SimpleBond::SimpleBond(const SimpleBond& other) :
+    m_principal(other.m_principal),
+    m_coupon(other.m_coupon),
+    m_coupon_frequency(other.m_coupon_frequency),
+    m_maturity(other.m_maturity),
+    m_schedule(),
+    m_schedule_built(false),
+    m_schedule_mutex() {}
+
+SimpleBond& SimpleBond::operator=(const SimpleBond& other) {
+    if ( this != &other ) {
+        m_principal = other.m_principal;
+        m_coupon = other.m_coupon;
+        m_coupon_frequency = other.m_coupon_frequency;
+        m_maturity = other.m_maturity;
+        m_schedule.clear();
+        m_schedule_built.store(false);
+    }
+    return *this;
+}
+
+BondFactors financial::bond_factors(const double discount_rate,
+                                    const int coupon_frequency,
+                                    const int maturity) {
+    BondFactors factors;
+    factors.principal_factor = discount_factor(discount_rate, maturity);
+
+    if ( coupon_frequency ) {
+        const double periods = static_cast<double>(maturity) *
+                               coupon_frequency;
+        const double pdr = std::expm1(std::log1p(discount_rate) /
+                                      coupon_frequency);
+        const double annuity = ( pdr == 0 ) ? periods :
+                               (1 - factors.principal_factor) / pdr;
+        factors.coupon_factor = annuity / coupon_frequency;
+    } else {
+        factors.coupon_factor = 0;
+    }
+
+    return factors;
+}
+
+BondFactors financial::bond_factors(const YieldCurve& curve,
+                                    const int coupon_frequency,
+                                    const int maturity) {
+    BondFactors factors;
+    factors.principal_factor = curve.discount_factor(maturity);
+
+    double annuity = 0;
+    if ( coupon_frequency ) {
+        const int periods = maturity * coupon_frequency;
+        for ( int cp = 1; cp < periods; ++cp ) {
+            annuity += curve.discount_factor(static_cast<double>(cp) /
+                                             coupon_frequency);
+        }
+        if ( periods > 0 ) {
+            annuity += factors.principal_factor;
+        }
+        annuity /= coupon_frequency;
+    }
+    factors.coupon_factor = annuity;
+
+    return factors;
+}
+
+BondRiskFactors financial::bond_risk_factors(const double discount_rate,
+                                             const int coupon_frequency,
+                                             const int maturity) {
+    const double g = 1 + discount_rate;
+    const double lg = std::log1p(discount_rate);
+
+    BondRiskFactors factors;
+    const double pf = std::exp(-maturity * lg);
+    factors.principal_factor.pv = pf;
+    factors.principal_factor.first = -maturity * pf / g;
+    factors.principal_factor.second = maturity * (maturity + 1.0) * pf /
+                                      (g * g);
+
+    double s0 = 0;
+    double s1 = 0;
+    double s2 = 0;
+    if ( coupon_frequency ) {
+        const int periods = maturity * coupon_frequency;
         for ( int cp = 1; cp <= periods; ++cp ) {
-            tcf.push_back(TimedCashFlow(cpymt, cp));
+            const double t = static_cast<double>(cp) / coupon_frequency;
+            const double dcf = std::exp(-t * lg) / coupon_frequency;
+            s0 += dcf;
+            s1 += t * dcf;
+            s2 += t * t * dcf;
         }
-        tcf.push_back(TimedCashFlow(m_principal, periods));
+    }
+    factors.coupon_factor.pv = s0;
+    factors.coupon_factor.first = -s1 / g;
+    factors.coupon_factor.second = (s2 + s1) / (g * g);
 
-        const double pdr = std::pow(1 + discount_rate,
-                                    1.0 / m_coupon_frequency) - 1;
-        ret_value = pv_stream(tcf, pdr);
-    } else {
-        ret_value = pv(m_principal, discount_rate, m_maturity);
+    return factors;
+}
+
+double SimpleBond::value(const double discount_rate) const {
+    PG_FINANCIAL_PROBE(bond_value, static_cast<std::size_t>(num_payments()));
+    const BondFactors factors = bond_factors(discount_rate,
+                                             m_coupon_frequency,
+                                             m_maturity);
+    return m_principal * (m_coupon * factors.coupon_factor +
+                          factors.principal_factor);
+}
+
+double SimpleBond::value(const YieldCurve& curve) const {
+    PG_FINANCIAL_PROBE(bond_value, static_cast<std::size_t>(num_payments()));
+    const BondFactors factors = bond_factors(curve, m_coupon_frequency,
+                                             m_maturity);
+    return m_principal * (m_coupon * factors.coupon_factor +
+                          factors.principal_factor);
+}
+
+double SimpleBond::dirty_price(const double discount_rate,
+                               const double settlement) const {
+    check_settlement(settlement);
+    PG_FINANCIAL_PROBE(bond_value,
+                       CashFlowView(schedule()).after(settlement).size());
+    return pv_stream_at(schedule(), discount_rate, settlement);
+}
+
+double SimpleBond::dirty_price(const YieldCurve& curve,
+                               const double settlement) const {
+    check_settlement(settlement);
+    PG_FINANCIAL_PROBE(bond_value,
+                       CashFlowView(schedule()).after(settlement).size());
+    return pv_stream_at(schedule(), curve, settlement);
+}
+
+double SimpleBond::clean_price(const double discount_rate,
+                               const double settlement) const {
+    return dirty_price(discount_rate, settlement) -
+           accrued_interest(settlement);
+}
+
+double SimpleBond::clean_price(const YieldCurve& curve,
+                               const double settlement) const {
+    return dirty_price(curve, settlement) - accrued_interest(settlement);
+}
+
+double SimpleBond::accrued_interest(const double settlement) const {
+    check_settlement(settlement);
+    if ( !m_coupon_frequency ) {
+        return 0;
+    }
+
+    const double coupon_periods = settlement * m_coupon_frequency;
+    const double accrued_fraction = coupon_periods -
+                                    std::floor(coupon_periods);
+    return m_principal * m_coupon / m_coupon_frequency * accrued_fraction;
+}
+
+RiskMeasures SimpleBond::price_and_risk(const double discount_rate) const {
+    const BondRiskFactors factors = bond_risk_factors(discount_rate,
+                                                      m_coupon_frequency,
+                                                      m_maturity);
+    const PvDerivatives& cf = factors.coupon_factor;
+    const PvDerivatives& pf = factors.principal_factor;
+    return RiskMeasures(m_principal * (m_coupon * cf.pv + pf.pv),
+                        m_principal * (m_coupon * cf.first + pf.first),
+                        m_principal * (m_coupon * cf.second + pf.second),
+                        discount_rate);
+}
+
+double SimpleBond::yield_to_maturity(const double price) const {
+    if ( !(price > 0) ) {
+        throw std::domain_error("bond price must be positive");
     }
 
-    return ret_value;
+    if ( !m_coupon_frequency ) {
+        return std::pow(m_principal / price, 1.0 / m_maturity) - 1;
+    }
+
+    //  Bracket the yield. The present value falls as the yield
+    //  rises, and becomes arbitrarily large as the yield
+    //  approaches -1.
+
+    double lo = -0.5;
+    while ( value(lo) < price && lo > -1 + 1e-12 ) {
+        lo = (lo - 1) / 2;
+    }
+    double hi = 1;
+    while ( value(hi) > price ) {
+        lo = hi;
+        hi *= 2;
+    }
+
+    const double annual_coupon = m_principal * m_coupon;
+    double ytm = (annual_coupon + (m_principal - price) / m_maturity) /
+                 ((m_principal + price) / 2);
+    if ( !(ytm > lo && ytm < hi) ) {
+        ytm = (lo + hi) / 2;
+    }
+
+    const CashFlowSchedule& sched = schedule();
+    const int max_iterations = 100;
+    for ( int i = 0; i < max_iterations; ++i ) {
+        const PvDerivatives pvd = pv_stream_derivatives(sched, ytm);
+        const double f = pvd.pv - price;
+        if ( f == 0 ) {
+            break;
+        } else if ( f > 0 ) {
+            lo = ytm;
+        } else {
+            hi = ytm;
+        }
+
+        const double denom = 2 * pvd.first * pvd.first - f * pvd.second;
+        double next = ytm - 2 * f * pvd.first / denom;
+        if ( !(next > lo && next < hi) ) {
+            next = (lo + hi) / 2;
+        }
+
+        const double step = next - ytm;
+        ytm = next;
+        if ( std::fabs(step) <= 4 * std::numeric_limits<double>::epsilon() *
+                                 (1 + std::fabs(ytm)) ) {
+            break;
+        }
+    }
+
+    return ytm;
+}
+
+const CashFlowSchedule& SimpleBond::schedule() const {
+    if ( !m_schedule_built.load(std::memory_order_acquire) ) {
+        std::lock_guard<std::mutex> lock(m_schedule_mutex);
+        if ( !m_schedule_built.load(std::memory_order_relaxed) ) {
+            build_schedule();
+            m_schedule_built.store(true, std::memory_order_release);
+        }
+    }
+    return m_schedule;
+}
+
+void SimpleBond::check_settlement(const double settlement) const {
+    if ( !(settlement >= 0 && settlement <= m_maturity) ) {
+        throw std::domain_error("settlement must be between issuance "
+                                "and maturity");
+    }
+}
+
+void SimpleBond::build_schedule() const {
+    PG_FINANCIAL_PROBE(schedule_build,
+                       static_cast<std::size_t>(num_payments()));
+    m_schedule.clear();
+    fill_schedule(m_schedule);
 }
 
 double SimpleBond::num_payments() const {
@@ -11,18 +11,124 @@
 #define PG_FINANCIAL_BOND_H
 
 #include <vector>
+#include <atomic>
+#include <mutex>
+#include "cashflow_schedule.h"
+#include "yield_curve.h"
 
 //! User library namespace
 
 namespace financial {
 
 
+//! Valuation factors for a level coupon bond.
+
+/*!
+ * The present value of a level coupon bond is linear in its principal
+ * and coupon rate, and can be expressed as `principal * (coupon *
+ * coupon_factor + principal_factor)`, where the factors depend only on
+ * the discount rate, the coupon frequency and the maturity. Bonds which
+ * share a coupon frequency and maturity can therefore all be valued
+ * from a single pair of factors.
+ */
+
+struct BondFactors {
+    double coupon_factor;       /*!< value of a unit annual coupon rate */
+    double principal_factor;    /*!< value of the principal repayment */
+};
+
+
+//! Calculates the valuation factors for a level coupon bond.
+
+/*!
+ * \param discount_rate the discount rate to use.
+ * \param coupon_frequency the number of coupon payments each period,
+ * or zero for a zero coupon bond.
+ * \param maturity the number of periods to maturity.
+ * \return the valuation factors for a unit principal.
+ */
+
+BondFactors bond_factors(const double discount_rate,
+                         const int coupon_frequency,
+                         const int maturity);
+
+
+//! Calculates the valuation factors for a bond against a yield curve.
+
+/*!
+ * As the flat rate overload, but discounts each coupon date at the
+ * curve's discount factor for that date, in a single pass.
+ *
+ * \param curve the yield curve to discount against.
+ * \param coupon_frequency the number of coupon payments each period,
+ * or zero for a zero coupon bond.
+ * \param maturity the number of periods to maturity.
+ * \return the valuation factors for a unit principal.
+ */
+
+BondFactors bond_factors(const YieldCurve& curve,
+                         const int coupon_frequency,
+                         const int maturity);
+
+
+//! Valuation factors for a level coupon bond, with derivatives.
+
+/*!
+ * As `BondFactors`, but each factor is accompanied by its first and
+ * second derivatives with respect to the discount rate. Since the
+ * present value is linear in the factors, so are its derivatives.
+ */
+
+struct BondRiskFactors {
+    PvDerivatives coupon_factor;    /*!< value of a unit annual coupon */
+    PvDerivatives principal_factor; /*!< value of the principal */
+};
+
+
+//! Calculates the valuation factors and derivatives for a bond.
+
+/*!
+ * The factors are calculated in a single pass over the coupon dates,
+ * without building a cash flow schedule.
+ *
+ * \param discount_rate the discount rate to use.
+ * \param coupon_frequency the number of coupon payments each period,
+ * or zero for a zero coupon bond.
+ * \param maturity the number of periods to maturity.
+ * \return the valuation factors and their derivatives for a unit
+ * principal.
+ */
+
+BondRiskFactors bond_risk_factors(const double discount_rate,
+                                  const int coupon_frequency,
+                                  const int maturity);
+
+
+//! Library implementation details namespace
+
+namespace detail {
+
+//! Checks the terms of a coupon bond.
+
+/*!
+ * \param coupon_frequency the number of coupon payments each period.
+ * \param maturity the number of periods to maturity.
+ * \throws std::domain_error if `coupon_frequency` is negative, or
+ * `maturity` is less than one.
+ */
+
+void check_bond_terms(const int coupon_frequency, const int maturity);
+
+}               //  namespace detail
+
+
 //! Simple bond class.
 
 /*!
- * Models a simple bond. Valuation is only possible at issuance.
- * Accrued interest cannot be calculated. Maturity can only be
- * expressed in whole periods.
+ * Models a simple bond, issued at time zero with a maturity of a whole
+ * number of periods. The bond can be valued at issuance, or at any
+ * settlement time during its life, with accrued interest, from its
+ * cash flow schedule.
  */
 
 class SimpleBond {
@@ -37,6 +143,8 @@ class SimpleBond {
          * \param coupon the periodic coupon rate
          * \param coupon_frequency the number of coupon payments each period
          * \param maturity the number of periods to maturity
+         * \throws std::domain_error if `coupon_frequency` is negative,
+         * or `maturity` is less than one.
          */
 
         explicit SimpleBond(const double principal,
@@ -46,7 +154,37 @@ class SimpleBond {
         m_principal(principal),
         m_coupon(coupon),
         m_coupon_frequency(coupon_frequency),
-        m_maturity(maturity) {};
+        m_maturity(maturity),
+        m_schedule(),
+        m_schedule_built(false),
+        m_schedule_mutex() {
+            detail::check_bond_terms(coupon_frequency, maturity);
+        }
+
+
+        //! Copy constructor
+
+        /*!
+         * Copies the terms of the bond. The cash flow schedule is not
+         * copied, and will be rebuilt if it is needed.
+         *
+         * \param other the bond to copy.
+         */
+
+        SimpleBond(const SimpleBond& other);
+
+
+        //! Assignment operator
+
+        /*!
+         * Assigns the terms of the bond. The cash flow schedule is not
+         * copied, and will be rebuilt if it is needed.
+         *
+         * \param other the bond to assign from.
+         * \return a reference to this bond.
+         */
+
+        SimpleBond& operator=(const SimpleBond& other);
 
 
         //! Destructor
@@ -59,6 +197,11 @@ class SimpleBond {
         /*!
          * Values a simple bond with discounted cash flows.
          *
+         * Since the coupons are level, the bond is valued in closed form
+         * as an annuity of coupons plus the discounted principal, which
+         * is equal to the present value of its cash flow schedule but
+         * requires neither the schedule nor any heap allocation.
+         *
          * \param discount_rate the discount rate to use.
          * \return the present value of the bond
          */
@@ -66,12 +209,263 @@ class SimpleBond {
         double value(const double discount_rate) const;
 
 
+        //! DCF valuation against a yield curve
+
+        /*!
+         * Values a simple bond by discounting each of its cash flows at
+         * the yield curve's discount factor for its date, in a single
+         * pass over the coupon dates and without any heap allocation.
+         *
+         * \param curve the yield curve to discount against.
+         * \return the present value of the bond
+         */
+
+        double value(const YieldCurve& curve) const;
+
+
+        //! Dirty price at a settlement time
+
+        /*!
+         * Values the bond at a settlement time during its life, which
+         * need not fall on a coupon date, as the value at settlement of
+         * the cash flows after it. A coupon due at exactly the
+         * settlement time is excluded, as it belongs to the seller.
+         *
+         * The bond's cached schedule, built once, is discounted by
+         * `pv_stream_at()` with the settlement time as an offset, so
+         * revaluing the bond at a new settlement time allocates no
+         * memory once the schedule has been built.
+         *
+         * \param discount_rate the discount rate to use.
+         * \param settlement the settlement time, in periods since
+         * issuance.
+         * \return the dirty price of the bond, including accrued
+         * interest.
+         * \throws std::domain_error if `settlement` is not between zero
+         * and the maturity.
+         */
+
+        double dirty_price(const double discount_rate,
+                           const double settlement) const;
+
+
+        //! Dirty price at a settlement time against a yield curve
+
+        /*!
+         * As the flat rate overload, discounting each remaining cash
+         * flow at the curve's discount factor for its time after
+         * settlement.
+         *
+         * \param curve the yield curve at the settlement time.
+         * \param settlement the settlement time, in periods since
+         * issuance.
+         * \return the dirty price of the bond, including accrued
+         * interest.
+         * \throws std::domain_error if `settlement` is not between zero
+         * and the maturity.
+         */
+
+        double dirty_price(const YieldCurve& curve,
+                           const double settlement) const;
+
+
+        //! Clean price at a settlement time
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \param settlement the settlement time, in periods since
+         * issuance.
+         * \return the dirty price less the accrued interest.
+         * \throws std::domain_error if `settlement` is not between zero
+         * and the maturity.
+         */
+
+        double clean_price(const double discount_rate,
+                           const double settlement) const;
+
+
+        //! Clean price at a settlement time against a yield curve
+
+        /*!
+         * \param curve the yield curve at the settlement time.
+         * \param settlement the settlement time, in periods since
+         * issuance.
+         * \return the dirty price less the accrued interest.
+         * \throws std::domain_error if `settlement` is not between zero
+         * and the maturity.
+         */
+
+        double clean_price(const YieldCurve& curve,
+                           const double settlement) const;
+
+
+        //! Accrued interest at a settlement time
+
+        /*!
+         * Calculates the coupon accrued since the last coupon date,
+         * linearly in time, which is zero on a coupon date and for a
+         * zero coupon bond.
+         *
+         * \param settlement the settlement time, in periods since
+         * issuance.
+         * \return the accrued interest.
+         * \throws std::domain_error if `settlement` is not between zero
+         * and the maturity.
+         */
+
+        double accrued_interest(const double settlement) const;
+
+
+        //! Returns the principal amount.
+
+        double principal() const { return m_principal; }
+
+
+        //! Returns the periodic coupon rate.
+
+        double coupon() const { return m_coupon; }
+
+
+        //! Returns the number of coupon payments each period.
+
+        int coupon_frequency() const { return m_coupon_frequency; }
+
+
+        //! Returns the number of periods to maturity.
+
+        int maturity() const { return m_maturity; }
+
+
+        //! Calculates the bond's present value and risk measures.
+
+        /*!
+         * Calculates the present value of the bond, together with its
+         * Macaulay and modified durations, convexity and DV01, in a
+         * single pass over the coupon dates and without any heap
+         * allocation.
+         *
+         * \param discount_rate the discount rate to use.
+         * \return the present value and risk measures of the bond.
+         */
+
+        RiskMeasures price_and_risk(const double discount_rate) const;
+
+
+        //! Calculates the bond's yield to maturity.
+
+        /*!
+         * Calculates the discount rate at which the present value of the
+         * bond is equal to a given price, such that
+         * `bond.value(bond.yield_to_maturity(price))` is equal to `price`.
+         *
+         * The yield is found with Halley's method, starting from the
+         * usual approximation to the yield, using the present value and
+         * its first two derivatives calculated together in a single
+         * pass over the bond's cash flow schedule. Every iterate is kept
+         * within a bracket known to contain the yield, and any step
+         * which would leave the bracket is replaced with a bisection
+         * step, so convergence is guaranteed. A typical solve requires
+         * three to five passes over the schedule.
+         *
+         * \param price the price of the bond.
+         * \return the bond's yield to maturity.
+         * \throws std::domain_error if `price` is not positive.
+         */
+
+        double yield_to_maturity(const double price) const;
+
+
+        //! Returns the bond's cash flow schedule.
+
+        /*!
+         * The schedule is built on the first call and cached, so later
+         * calls return the same schedule without rebuilding it. This
+         * is safe to call concurrently from several threads. The time of
+         * each cash flow is measured in periods, rather than in coupon
+         * payments, so the schedule can be discounted directly at the
+         * periodic discount rate:
+         *
+         * ~~~~{.cpp}
+         * financial::SimpleBond bond(2500, 0.075, 2, 20);
+         * double pval = financial::pv_stream(bond.schedule(), 0.06);
+         * ~~~~
+         *
+         * \return a reference to the bond's cash flow schedule.
+         */
+
+        const CashFlowSchedule& schedule() const;
+
+
+        //! Builds a copy of the bond's cash flow schedule.
+
+        /*!
+         * Builds a new schedule, as returned by `schedule()`, using an
+         * allocator, without caching it. With an `ArenaAllocator`, the
+         * schedule is drawn from an arena, and building schedules for
+         * many bonds requires no heap allocation:
+         *
+         * ~~~~{.cpp}
+         * const financial::ArenaCashFlowSchedule sched =
+         *     bond.schedule(financial::ArenaAllocator<double>(arena));
+         * ~~~~
+         *
+         * \param alloc the allocator for the schedule's arrays.
+         * \return the bond's cash flow schedule.
+         */
+
+        template <class Allocator>
+        BasicCashFlowSchedule<Allocator> schedule(const Allocator& alloc)
+        const {
+            BasicCashFlowSchedule<Allocator> sched(alloc);
+            fill_schedule(sched);
+            return sched;
+        }
+
+
     private:
         double m_principal;     /*!< principal amount */
         double m_coupon;        /*!< periodic coupon */
         int m_coupon_frequency; /*!< coupon payments per period */
         int m_maturity;         /*!< periods to maturity */
 
+        mutable CashFlowSchedule m_schedule;    /*!< cached schedule */
+        mutable std::atomic<bool> m_schedule_built; /*!< schedule built */
+        mutable std::mutex m_schedule_mutex;    /*!< guards building */
+
+
+        //! Checks that a settlement time falls within the bond's life.
+
+        void check_settlement(const double settlement) const;
+
+
+        //! Builds the cash flow schedule.
+
+        void build_schedule() const;
+
+
+        //! Appends the bond's cash flows to an empty schedule.
+
+        template <class Schedule>
+        void fill_schedule(Schedule& sched) const {
+            if ( m_coupon_frequency ) {
+                const double cpymt = m_principal * m_coupon /
+                                     m_coupon_frequency;
+                //  The constructor accepts only terms with at least one
+                //  coupon period, so the final coupon, paid with the
+                //  principal at maturity, is always the last of them.
+
+                const int periods = static_cast<int>(num_payments());
+                sched.reserve(periods);
+                for ( int cp = 1; cp < periods; ++cp ) {
+                    sched.add(cpymt, static_cast<double>(cp) /
+                                     m_coupon_frequency);
+                }
+                sched.add(cpymt + m_principal, m_maturity);
+            } else {
+                sched.add(m_principal, m_maturity);
+            }
+        }
+
 
         //! Returns the number of payments over the bond's lifetime.
 
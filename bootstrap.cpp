@@ -0,0 +1,203 @@
+/*!
+ * \file        bootstrap.cpp
+ * \brief       Yield curve bootstrapping implementation.
+ * \details     Yield curve bootstrapping implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "bond.h"
+#include "yield_curve.h"
+#include "bootstrap.h"
+
+using namespace financial;
+
+namespace {
+
+//! Maximum number of Newton iterations for each pillar.
+
+const int max_iterations = 100;
+
+//! Convergence tolerance for each pillar's log discount.
+
+const double tolerance = 1e-14;
+
+//! Orders bond indices by maturity.
+
+class ByMaturity {
+    public:
+        explicit ByMaturity(const std::vector<SimpleBond>& bonds) :
+            m_bonds(bonds) {}
+        bool operator()(const std::size_t a, const std::size_t b) const {
+            return m_bonds[a].maturity() < m_bonds[b].maturity();
+        }
+
+    private:
+        const std::vector<SimpleBond>& m_bonds;
+};
+
+}           //  namespace
+
+CurveBootstrapper::CurveBootstrapper(const std::vector<SimpleBond>& bonds,
+                                     const std::vector<double>& prices) :
+    m_bonds(),
+    m_prices(),
+    m_times(),
+    m_log_discounts(bonds.size()),
+    m_trial(bonds.size()),
+    m_dfs(bonds.size()),
+    m_pillar_of(bonds.size()),
+    m_curve(std::vector<double>(1, 1.0), std::vector<double>(1, 1.0)) {
+    if ( bonds.empty() ) {
+        throw std::domain_error("Bootstrap must have at least one bond");
+    }
+    if ( bonds.size() != prices.size() ) {
+        throw std::domain_error("Bootstrap bond and price vectors differ "
+                                "in size");
+    }
+
+    std::vector<std::size_t> order(bonds.size());
+    for ( std::size_t i = 0; i < order.size(); ++i ) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), ByMaturity(bonds));
+
+    int previous = 0;
+    for ( std::size_t p = 0; p < order.size(); ++p ) {
+        const SimpleBond& bond = bonds[order[p]];
+        if ( bond.maturity() <= previous ) {
+            throw std::domain_error("Bootstrap bonds must have positive "
+                                    "and different maturities");
+        }
+        previous = bond.maturity();
+
+        m_bonds.push_back(bond);
+        m_prices.push_back(prices[order[p]]);
+        m_times.push_back(bond.maturity());
+        m_pillar_of[order[p]] = p;
+    }
+
+    solve_from(0, m_prices[0], m_log_discounts);
+    rebuild_curve();
+}
+
+std::size_t CurveBootstrapper::set_price(const std::size_t index,
+                                         const double price) {
+    const std::size_t first = m_pillar_of[index];
+
+    //  The pillars before the bond's maturity do not depend on it, so
+    //  solve from its pillar onward into a copy, and only commit the
+    //  result once every pillar has been solved.
+
+    m_trial = m_log_discounts;
+    solve_from(first, price, m_trial);
+    m_trial.swap(m_log_discounts);
+    m_prices[first] = price;
+    rebuild_curve();
+
+    return m_bonds.size() - first;
+}
+
+void CurveBootstrapper::solve_from(const std::size_t first,
+                                   const double first_price,
+                                   std::vector<double>& log_discounts) const {
+    log_discounts[first] = solve_pillar(first, first_price, log_discounts);
+    for ( std::size_t p = first + 1; p < m_bonds.size(); ++p ) {
+        log_discounts[p] = solve_pillar(p, m_prices[p], log_discounts);
+    }
+}
+
+double CurveBootstrapper::solve_pillar(const std::size_t pillar,
+                                       const double price,
+                                       const std::vector<double>&
+                                       log_discounts) const {
+    if ( !(price > 0) ) {
+        throw std::domain_error("Bootstrap bond prices must be positive");
+    }
+
+    const SimpleBond& bond = m_bonds[pillar];
+    const double maturity = m_times[pillar];
+    const int frequency = bond.coupon_frequency();
+    if ( !frequency ) {
+        return -std::log(price / bond.principal());
+    }
+
+    const double prev_time = pillar ? m_times[pillar - 1] : 0;
+    const double prev_log = pillar ? log_discounts[pillar - 1] : 0;
+    const double coupon = bond.principal() * bond.coupon() / frequency;
+    const int periods = bond.maturity() * frequency;
+
+    //  Discount the cash flows up to the previous pillar against the
+    //  pillars already solved, walking the segments alongside the
+    //  coupon dates.
+
+    double known = 0;
+    double seg_start = 0;
+    double seg_log = 0;
+    std::size_t seg = 0;
+    int cp = 1;
+    for ( ; cp <= periods; ++cp ) {
+        const double t = static_cast<double>(cp) / frequency;
+        if ( t > prev_time ) {
+            break;
+        }
+        while ( t > m_times[seg] ) {
+            seg_start = m_times[seg];
+            seg_log = log_discounts[seg];
+            ++seg;
+        }
+        const double w = (t - seg_start) / (m_times[seg] - seg_start);
+        known += coupon * std::exp(-(seg_log +
+                                     w * (log_discounts[seg] - seg_log)));
+    }
+
+    const double target = price - known;
+    if ( !(target > 0) ) {
+        throw std::domain_error("Bootstrap bond price is below the value "
+                                "of its earlier cash flows");
+    }
+
+    //  The remaining cash flows fall in the new segment, where the log
+    //  discount is linear in the pillar's log discount `x`. Their value
+    //  is decreasing and convex in `x`, so Newton's method converges
+    //  from any starting point, approaching from the left after at most
+    //  one step. Start from a flat extension of the previous zero rate.
+
+    const int first_new = cp;
+    const double span = maturity - prev_time;
+    double x = pillar ? prev_log * maturity / prev_time : 0;
+    for ( int iteration = 0; iteration < max_iterations; ++iteration ) {
+        double value = 0;
+        double slope = 0;
+        for ( cp = first_new; cp <= periods; ++cp ) {
+            const double w = (static_cast<double>(cp) / frequency -
+                              prev_time) / span;
+            const double amount = ( cp == periods ) ?
+                                  coupon + bond.principal() : coupon;
+            const double pv = amount * std::exp(-(prev_log +
+                                                  w * (x - prev_log)));
+            value += pv;
+            slope -= w * pv;
+        }
+        const double step = (value - target) / slope;
+        x -= step;
+        if ( std::fabs(step) <= tolerance * (1 + std::fabs(x)) ) {
+            return x;
+        }
+    }
+
+    throw std::domain_error("Bootstrap failed to converge");
+}
+
+void CurveBootstrapper::rebuild_curve() {
+    for ( std::size_t p = 0; p < m_bonds.size(); ++p ) {
+        m_dfs[p] = std::exp(-m_log_discounts[p]);
+    }
+    m_curve = YieldCurve(m_times, m_dfs);
+}
@@ -0,0 +1,143 @@
+/*!
+ * \file        bootstrap.h
+ * \brief       Yield curve bootstrapping interface.
+ * \details     Yield curve bootstrapping interface.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_BOOTSTRAP_H
+#define PG_FINANCIAL_BOOTSTRAP_H
+
+#include <cstddef>
+#include <vector>
+#include "bond.h"
+#include "yield_curve.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Yield curve bootstrapper class.
+
+/*!
+ * Builds a yield curve which reprices a set of bonds, with one pillar
+ * at the maturity of each bond, and keeps it up to date as the bond
+ * prices change.
+ *
+ * The curve is log-linear, so the discount factors of the cash flows
+ * of each bond depend only on the pillars up to its own maturity.
+ * Taking the bonds in order of maturity, each pillar is therefore
+ * solved from the known pillars before it, by Newton's method on the
+ * log of its discount factor. The bond's cash flows before the previous
+ * pillar are discounted once per solve, and only those after it are
+ * revisited in each iteration.
+ *
+ * When a price changes, the pillars before the bond's maturity are
+ * unaffected, so only the bond's own pillar and those after it are
+ * solved again. Updating the price of the longest bond re-solves a
+ * single pillar.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * std::vector<financial::SimpleBond> bonds;
+ * std::vector<double> prices;
+ * for ( int m = 1; m <= 30; ++m ) {
+ *     bonds.push_back(financial::SimpleBond(100, par_coupons[m], 2, m));
+ *     prices.push_back(100);
+ * }
+ * financial::CurveBootstrapper bootstrapper(bonds, prices);
+ * bootstrapper.set_price(9, 100.25);
+ * double df = bootstrapper.curve().discount_factor(12.5);
+ * ~~~~
+ */
+
+class CurveBootstrapper {
+    public:
+
+        //! Constructor
+
+        /*!
+         * Bootstraps the curve from a set of bonds and their prices.
+         *
+         * \param bonds the bonds, in any order, which must all have
+         * different maturities.
+         * \param prices the price of each bond.
+         * \throws std::domain_error if there are no bonds, the vectors
+         * differ in length, two bonds share a maturity, or the curve
+         * cannot reprice a bond with a positive discount factor.
+         */
+
+        explicit CurveBootstrapper(const std::vector<SimpleBond>& bonds,
+                                   const std::vector<double>& prices);
+
+
+        //! Returns the number of bonds.
+
+        std::size_t size() const { return m_bonds.size(); }
+
+
+        //! Returns the current price of a bond.
+
+        /*!
+         * \param index the index of the bond, in the order given to the
+         * constructor.
+         * \return the bond's price.
+         */
+
+        double price(const std::size_t index) const {
+            return m_prices[m_pillar_of[index]];
+        }
+
+
+        //! Changes the price of a bond and updates the curve.
+
+        /*!
+         * Re-solves the pillar at the bond's maturity and those after
+         * it. If the new price cannot be repriced, the curve and prices
+         * are left unchanged.
+         *
+         * \param index the index of the bond, in the order given to the
+         * constructor.
+         * \param price the new price of the bond.
+         * \return the number of pillars re-solved.
+         * \throws std::domain_error if the curve cannot reprice a bond
+         * with a positive discount factor.
+         */
+
+        std::size_t set_price(const std::size_t index, const double price);
+
+
+        //! Returns the bootstrapped curve.
+
+        const YieldCurve& curve() const { return m_curve; }
+
+
+    private:
+
+        //! Solves the pillars from one onward into a set of log discounts.
+        void solve_from(const std::size_t first, const double first_price,
+                        std::vector<double>& log_discounts) const;
+
+        //! Solves one pillar's log discount from the pillars before it.
+        double solve_pillar(const std::size_t pillar, const double price,
+                            const std::vector<double>& log_discounts) const;
+
+        //! Rebuilds the curve from the pillar log discounts.
+        void rebuild_curve();
+
+        std::vector<SimpleBond> m_bonds;        /*!< bonds, by maturity */
+        std::vector<double> m_prices;           /*!< prices, by maturity */
+        std::vector<double> m_times;            /*!< pillar times */
+        std::vector<double> m_log_discounts;    /*!< pillar -log(DF) */
+        std::vector<double> m_trial;            /*!< scratch log discounts */
+        std::vector<double> m_dfs;              /*!< scratch DFs */
+        std::vector<std::size_t> m_pillar_of;   /*!< pillar of each bond */
+        YieldCurve m_curve;                     /*!< bootstrapped curve */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_BOOTSTRAP_H
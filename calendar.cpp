@@ -0,0 +1,124 @@
+/*!
+ * \file        calendar.cpp
+ * \brief       Holiday calendar implementation.
+ * \details     Holiday calendar implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "cashflow_schedule.h"
+#include "dates.h"
+#include "calendar.h"
+
+using namespace financial;
+
+namespace {
+
+//! Returns the number of dates in the range.
+
+int num_dates() {
+    return Date(last_year, 12, 31).serial() + 1;
+}
+
+}           //  namespace
+
+HolidayCalendar::HolidayCalendar(const std::vector<Date>& holidays,
+                                 const unsigned weekend) :
+    m_count(num_dates() + 1), m_business_days() {
+    const int days = num_dates();
+    std::vector<bool> is_holiday(days, false);
+    for ( std::size_t i = 0; i < holidays.size(); ++i ) {
+        is_holiday[holidays[i].serial()] = true;
+    }
+
+    m_business_days.reserve(days);
+    for ( int serial = 0; serial < days; ++serial ) {
+        m_count[serial] = static_cast<int>(m_business_days.size());
+        const bool is_weekend = (weekend >> (serial % 7)) & 1u;
+        if ( !is_weekend && !is_holiday[serial] ) {
+            m_business_days.push_back(serial);
+        }
+    }
+    m_count[days] = static_cast<int>(m_business_days.size());
+}
+
+Date HolidayCalendar::adjust(const Date date, const business_day bdc) const {
+    if ( bdc == business_day::unadjusted || is_business_day(date) ) {
+        return date;
+    }
+
+    //  The next business day is the first counted after the date, and
+    //  the previous one is the last counted before it.
+
+    const int next = m_count[date.serial()];
+    const int previous = next - 1;
+    switch ( bdc ) {
+        case business_day::following:
+            return business_day_at(next);
+
+        case business_day::preceding:
+            return business_day_at(previous);
+
+        case business_day::modified_following: {
+            const Date adjusted = business_day_at(next);
+            return ( adjusted.month() == date.month() ) ?
+                   adjusted : business_day_at(previous);
+        }
+
+        case business_day::modified_preceding: {
+            const Date adjusted = business_day_at(previous);
+            return ( adjusted.month() == date.month() ) ?
+                   adjusted : business_day_at(next);
+        }
+
+        default:
+            assert(false);
+            return date;
+    }
+}
+
+Date HolidayCalendar::add_business_days(const Date date,
+                                        const int days) const {
+    if ( days > 0 ) {
+        return business_day_at(m_count[date.serial() + 1] + days - 1);
+    } else if ( days < 0 ) {
+        return business_day_at(m_count[date.serial()] + days);
+    } else {
+        return date;
+    }
+}
+
+Date HolidayCalendar::business_day_at(const int index) const {
+    if ( index < 0 || index >= static_cast<int>(m_business_days.size()) ) {
+        throw std::domain_error("Business day is outside the range of "
+                                "dates");
+    }
+    return Date::from_serial(m_business_days[index]);
+}
+
+CashFlowSchedule financial::dated_schedule(const std::vector<DatedCashFlow>&
+                                           cashflows,
+                                           const Date valuation_date,
+                                           const day_count dc,
+                                           const HolidayCalendar& calendar,
+                                           const business_day bdc) {
+    std::vector<Date> dates(cashflows.size());
+    for ( std::size_t i = 0; i < cashflows.size(); ++i ) {
+        dates[i] = calendar.adjust(cashflows[i].date, bdc);
+    }
+    std::vector<double> times(cashflows.size());
+    year_fractions(valuation_date, dates.data(), dates.size(), dc,
+                   times.data());
+
+    CashFlowSchedule sched;
+    sched.reserve(cashflows.size());
+    for ( std::size_t i = 0; i < cashflows.size(); ++i ) {
+        sched.add(cashflows[i].amount, times[i]);
+    }
+    return sched;
+}
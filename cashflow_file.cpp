@@ -0,0 +1,178 @@
+/*!
+ * \file        cashflow_file.cpp
+ * \brief       Binary cash flow file implementation.
+ * \details     Binary cash flow file implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "cashflow_schedule.h"
+#include "cashflow_file.h"
+
+using namespace financial;
+
+namespace {
+
+//! Alignment of each column, and size of the header.
+
+const uint64_t alignment = 64;
+
+//! Magic number identifying a cash flow file.
+
+const char magic[8] = {'P', 'G', 'C', 'F', 'L', 'O', 'W', '\0'};
+
+//! Current file format version.
+
+const uint32_t format_version = 1;
+
+//! Byte order mark, stored in native byte order.
+
+const uint32_t byte_order_mark = 0x01020304;
+
+//! File header, padded to the column alignment.
+
+struct FileHeader {
+    char magic[8];              /*!< identifies the file type */
+    uint32_t version;           /*!< the file format version */
+    uint32_t byte_order;        /*!< byte_order_mark, in native order */
+    uint64_t num_cashflows;     /*!< the number of cash flows */
+    uint64_t amounts_offset;    /*!< offset of the amounts column */
+    uint64_t times_offset;      /*!< offset of the time periods column */
+    char padding[24];           /*!< reserved, zero */
+};
+
+static_assert(sizeof(FileHeader) == alignment,
+              "cash flow file header must fill one aligned block");
+
+//! Rounds a size up to a multiple of the column alignment.
+
+uint64_t aligned(const uint64_t size) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+//! Writes bytes to a stream, throwing on failure.
+
+void write_bytes(std::ofstream& out, const void * data,
+                 const std::size_t size, const std::string& filename) {
+    out.write(static_cast<const char *>(data), size);
+    if ( !out ) {
+        throw std::runtime_error("Couldn't write cash flow file " +
+                                 filename);
+    }
+}
+
+}           //  namespace
+
+void financial::write_cashflow_file(const std::string& filename,
+                                    const CashFlowView& cashflows) {
+    const uint64_t column_size = cashflows.size() * sizeof(double);
+
+    FileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = format_version;
+    header.byte_order = byte_order_mark;
+    header.num_cashflows = cashflows.size();
+    header.amounts_offset = alignment;
+    header.times_offset = header.amounts_offset + aligned(column_size);
+
+    std::ofstream out(filename.c_str(),
+                      std::ios::out | std::ios::binary | std::ios::trunc);
+    if ( !out ) {
+        throw std::runtime_error("Couldn't create cash flow file " +
+                                 filename);
+    }
+
+    const std::vector<char> padding(aligned(column_size) - column_size, 0);
+    write_bytes(out, &header, sizeof(header), filename);
+    write_bytes(out, cashflows.amounts(), column_size, filename);
+    write_bytes(out, padding.data(), padding.size(), filename);
+    write_bytes(out, cashflows.times(), column_size, filename);
+
+    out.close();
+    if ( !out ) {
+        throw std::runtime_error("Couldn't write cash flow file " +
+                                 filename);
+    }
+}
+
+MappedCashFlowFile::MappedCashFlowFile(const std::string& filename) :
+    m_address(MAP_FAILED), m_length(0), m_view() {
+    const int fd = open(filename.c_str(), O_RDONLY);
+    if ( fd == -1 ) {
+        throw std::runtime_error("Couldn't open cash flow file " + filename);
+    }
+
+    struct stat file_stat;
+    if ( fstat(fd, &file_stat) == -1 ) {
+        close(fd);
+        throw std::runtime_error("Couldn't read cash flow file " + filename);
+    }
+    m_length = static_cast<std::size_t>(file_stat.st_size);
+    if ( m_length < sizeof(FileHeader) ) {
+        close(fd);
+        throw std::runtime_error("Cash flow file " + filename +
+                                 " is too short");
+    }
+
+    m_address = mmap(0, m_length, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if ( m_address == MAP_FAILED ) {
+        throw std::runtime_error("Couldn't map cash flow file " + filename);
+    }
+
+    //  Check the header before trusting any of its offsets. The mapping
+    //  is page aligned, so aligned offsets give aligned columns.
+
+    FileHeader header;
+    std::memcpy(&header, m_address, sizeof(header));
+    const char * error = 0;
+    if ( std::memcmp(header.magic, magic, sizeof(magic)) != 0 ) {
+        error = " is not a cash flow file";
+    } else if ( header.version != format_version ) {
+        error = " has an unsupported version";
+    } else if ( header.byte_order != byte_order_mark ) {
+        error = " has the wrong byte order";
+    } else {
+        const uint64_t max_cashflows = m_length / sizeof(double);
+        const uint64_t column_size = header.num_cashflows * sizeof(double);
+        if ( header.num_cashflows > max_cashflows ||
+             header.amounts_offset > m_length ||
+             header.amounts_offset % alignment != 0 ||
+             header.times_offset % alignment != 0 ||
+             header.amounts_offset < sizeof(FileHeader) ||
+             header.times_offset < header.amounts_offset + column_size ||
+             header.times_offset > m_length ||
+             m_length - header.times_offset < column_size ) {
+            error = " is truncated or corrupt";
+        }
+    }
+    if ( error ) {
+        munmap(m_address, m_length);
+        throw std::runtime_error("Cash flow file " + filename + error);
+    }
+
+    madvise(m_address, m_length, MADV_SEQUENTIAL);
+
+    const char * base = static_cast<const char *>(m_address);
+    m_view = CashFlowView(
+        reinterpret_cast<const double *>(base + header.amounts_offset),
+        reinterpret_cast<const double *>(base + header.times_offset),
+        header.num_cashflows);
+}
+
+MappedCashFlowFile::~MappedCashFlowFile() {
+    munmap(m_address, m_length);
+}
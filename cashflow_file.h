@@ -0,0 +1,110 @@
+/*!
+ * \file        cashflow_file.h
+ * \brief       Binary cash flow file interface.
+ * \details     Interface for writing cash flows to a compact columnar
+ * binary file, and for reading them back through a memory mapping.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_CASHFLOW_FILE_H
+#define PG_FINANCIAL_CASHFLOW_FILE_H
+
+#include <cstddef>
+#include <string>
+#include "cashflow_schedule.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Writes cash flows to a binary cash flow file.
+
+/*!
+ * The file consists of a 64-byte header followed by two columns, the
+ * amounts and then the time periods, each stored as native doubles and
+ * starting on a 64-byte boundary. The header holds a magic number, a
+ * format version, a byte order mark, the number of cash flows and the
+ * offset of each column. The file can be read on any machine with the
+ * same double format and byte order, which the reader checks.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::CashFlowSchedule sched(projected_cashflows);
+ * financial::write_cashflow_file("projections.cfl", sched);
+ * ~~~~
+ *
+ * \param filename the name of the file to create or overwrite.
+ * \param cashflows the cash flows to write, as a schedule or a view.
+ * \throws std::runtime_error if the file cannot be written.
+ */
+
+void write_cashflow_file(const std::string& filename,
+                         const CashFlowView& cashflows);
+
+
+//! Memory-mapped binary cash flow file class.
+
+/*!
+ * Maps a file written by `write_cashflow_file()` into memory read-only,
+ * and exposes its columns as a `CashFlowView` without copying or
+ * parsing them. Pages are read from disk as the view is traversed, so
+ * valuing a file with `pv_stream()` is limited by I/O and memory
+ * bandwidth. The view is valid for the lifetime of the object.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * const financial::MappedCashFlowFile file("projections.cfl");
+ * double pval = financial::pv_stream(file.view(), 0.05);
+ * ~~~~
+ */
+
+class MappedCashFlowFile {
+    public:
+
+        //! Constructor
+
+        /*!
+         * Opens and maps a file, and checks its header.
+         *
+         * \param filename the name of the file to map.
+         * \throws std::runtime_error if the file cannot be opened or
+         * mapped, or is not a valid cash flow file for this machine.
+         */
+
+        explicit MappedCashFlowFile(const std::string& filename);
+
+
+        //! Destructor
+
+        /*!
+         * Unmaps the file.
+         */
+
+        ~MappedCashFlowFile();
+
+
+        //! Returns the number of cash flows in the file.
+
+        std::size_t size() const { return m_view.size(); }
+
+
+        //! Returns a view of the cash flows in the file.
+
+        const CashFlowView& view() const { return m_view; }
+
+
+    private:
+        MappedCashFlowFile(const MappedCashFlowFile&);
+        MappedCashFlowFile& operator=(const MappedCashFlowFile&);
+
+        void * m_address;           /*!< start of the mapping */
+        std::size_t m_length;       /*!< length of the mapping */
+        CashFlowView m_view;        /*!< view of the mapped columns */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_CASHFLOW_FILE_H
@@ -0,0 +1,280 @@
+/*!
+ * \file        cashflow_range.h
+ * \brief       Cash flow range and strided view functions.
+ * \details     Header-only `pv_stream()` overloads for cash flows held
+ * in arbitrary records, reached through iterator ranges with accessors
+ * for the amount and time period, or through strided views.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_CASHFLOW_RANGE_H
+#define PG_FINANCIAL_CASHFLOW_RANGE_H
+
+#include <cstddef>
+#include <iterator>
+#include "common_financial_types.h"
+#include "cashflow_schedule.h"
+#include "instrumentation.h"
+#include "pv_kernels.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Number of cash flows gathered from a range for each kernel call.
+
+const std::size_t pv_stream_gather_size = 256;
+
+
+//! Strided cash flow view class.
+
+/*!
+ * A non-owning view of a stream of cash flows whose amounts and time
+ * periods are each spaced a fixed number of bytes apart, such as the
+ * fields of an array of records. The records must outlive the view.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * struct Position {
+ *     int id;
+ *     double amount;
+ *     double time;
+ *     char desk[16];
+ * };
+ * std::vector<Position> book = load_positions();
+ * const financial::StridedCashFlowView view =
+ *     financial::make_strided_view(book.data(), book.size(),
+ *                                  &Position::amount, &Position::time);
+ * double pval = financial::pv_stream(view, 0.05);
+ * ~~~~
+ */
+
+class StridedCashFlowView {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param amounts a pointer to the first amount.
+         * \param times a pointer to the first time period.
+         * \param size the number of cash flows.
+         * \param stride the distance in bytes from each amount, and
+         * each time period, to the next.
+         */
+
+        StridedCashFlowView(const double * amounts, const double * times,
+                            const std::size_t size, const std::size_t stride) :
+            m_amounts(reinterpret_cast<const char *>(amounts)),
+            m_times(reinterpret_cast<const char *>(times)),
+            m_size(size), m_stride(stride) {}
+
+
+        //! Returns the number of cash flows in the view.
+
+        std::size_t size() const { return m_size; }
+
+
+        //! Returns true if the view contains no cash flows.
+
+        bool empty() const { return m_size == 0; }
+
+
+        //! Returns the distance in bytes between successive cash flows.
+
+        std::size_t stride() const { return m_stride; }
+
+
+        //! Returns the amount of a specified cash flow.
+
+        double amount(const std::size_t index) const {
+            return *reinterpret_cast<const double *>(m_amounts +
+                                                     index * m_stride);
+        }
+
+
+        //! Returns the time period of a specified cash flow.
+
+        double time_period(const std::size_t index) const {
+            return *reinterpret_cast<const double *>(m_times +
+                                                     index * m_stride);
+        }
+
+
+        //! Returns a specified cash flow.
+
+        TimedCashFlow operator[](const std::size_t index) const {
+            return TimedCashFlow(amount(index), time_period(index));
+        }
+
+
+    private:
+        const char * m_amounts;     /*!< the first amount */
+        const char * m_times;       /*!< the first time period */
+        std::size_t m_size;         /*!< the number of cash flows */
+        std::size_t m_stride;       /*!< bytes between cash flows */
+};
+
+
+//! Creates a strided view of the fields of an array of records.
+
+/*!
+ * \param records an array of `num_records` records.
+ * \param num_records the number of records.
+ * \param amount a pointer to the member holding each amount.
+ * \param time_period a pointer to the member holding each time period.
+ * \return a view of the amounts and time periods of the records.
+ */
+
+template <class Record>
+StridedCashFlowView make_strided_view(const Record * records,
+                                      const std::size_t num_records,
+                                      double Record::* amount,
+                                      double Record::* time_period) {
+    return StridedCashFlowView(&(records->*amount),
+                               &(records->*time_period),
+                               num_records, sizeof(Record));
+}
+
+
+//! Calculates the present value of a range of cash flow records.
+
+/*!
+ * Values any range of records from which an amount and a time period
+ * can be extracted, without copying them into a `std::vector`. The
+ * cash flows are gathered into fixed-size blocks on the stack, and each
+ * block is discounted by the same kernel as a `CashFlowView`, so the
+ * accuracy is as for that overload of `pv_stream()`, and nothing is
+ * allocated. Each call records a single instrumentation probe.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * double pval = financial::pv_stream(book.begin(), book.end(), 0.05,
+ *     [](const Position& p) { return p.amount; },
+ *     [](const Position& p) { return p.time; });
+ * ~~~~
+ *
+ * \param first an input iterator to the first record.
+ * \param last an input iterator one past the last record.
+ * \param interest_rate the periodic interest rate.
+ * \param amount a function or function object returning the amount of
+ * the cash flow described by a record.
+ * \param time_period a function or function object returning the time
+ * period of the cash flow described by a record.
+ * \param dt the type of discounting to use.
+ * \return the present value of the cash flows.
+ */
+
+template <class InputIterator, class AmountAccessor, class TimeAccessor>
+double pv_stream(InputIterator first, InputIterator last,
+                 const double interest_rate,
+                 AmountAccessor amount, TimeAccessor time_period,
+                 const enum disc_type dt = disc_type::discrete) {
+    PG_FINANCIAL_PROBE(pv_stream, 0);
+    const double lg = detail::log_growth(interest_rate, dt);
+    double amounts[pv_stream_gather_size];
+    double times[pv_stream_gather_size];
+    double pv_total = 0;
+    while ( first != last ) {
+        std::size_t n = 0;
+        for ( ; n < pv_stream_gather_size && first != last; ++first, ++n ) {
+            typename std::iterator_traits<InputIterator>::reference
+                record = *first;
+            amounts[n] = amount(record);
+            times[n] = time_period(record);
+        }
+        PG_FINANCIAL_PROBE_CASHFLOWS(n);
+        pv_total += detail::pv_sum(amounts, times, n, lg);
+    }
+    return pv_total;
+}
+
+
+//! Calculates the present value of a range of cash flow records.
+
+/*!
+ * As the overload taking accessor functions, but takes pointers to the
+ * members of the records holding the amount and time period.
+ *
+ * \param first an input iterator to the first record.
+ * \param last an input iterator one past the last record.
+ * \param interest_rate the periodic interest rate.
+ * \param amount a pointer to the member holding each amount.
+ * \param time_period a pointer to the member holding each time period.
+ * \param dt the type of discounting to use.
+ * \return the present value of the cash flows.
+ */
+
+template <class InputIterator, class Record>
+double pv_stream(InputIterator first, InputIterator last,
+                 const double interest_rate,
+                 double Record::* amount, double Record::* time_period,
+                 const enum disc_type dt = disc_type::discrete) {
+    return pv_stream(first, last, interest_rate,
+                     [amount](const Record& record) {
+                         return record.*amount;
+                     },
+                     [time_period](const Record& record) {
+                         return record.*time_period;
+                     }, dt);
+}
+
+
+//! Calculates the present value of a range of TimedCashFlow structs.
+
+/*!
+ * \param first an input iterator to the first cash flow.
+ * \param last an input iterator one past the last cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \param dt the type of discounting to use.
+ * \return the present value of the cash flows.
+ */
+
+template <class InputIterator>
+double pv_stream(InputIterator first, InputIterator last,
+                 const double interest_rate,
+                 const enum disc_type dt = disc_type::discrete) {
+    return pv_stream(first, last, interest_rate, &TimedCashFlow::amount,
+                     &TimedCashFlow::time_period, dt);
+}
+
+
+//! Calculates the present value of a strided view of cash flows.
+
+/*!
+ * As the iterator range overloads, gathering the cash flows into
+ * fixed-size blocks on the stack.
+ *
+ * \param cashflows the view of the cash flows.
+ * \param interest_rate the periodic interest rate.
+ * \param dt the type of discounting to use.
+ * \return the present value of the cash flows.
+ */
+
+inline double pv_stream(const StridedCashFlowView& cashflows,
+                        const double interest_rate,
+                        const enum disc_type dt = disc_type::discrete) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    const double lg = detail::log_growth(interest_rate, dt);
+    double amounts[pv_stream_gather_size];
+    double times[pv_stream_gather_size];
+    double pv_total = 0;
+    for ( std::size_t begin = 0; begin < cashflows.size();
+          begin += pv_stream_gather_size ) {
+        const std::size_t remaining = cashflows.size() - begin;
+        const std::size_t n = remaining < pv_stream_gather_size ?
+                              remaining : pv_stream_gather_size;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            amounts[i] = cashflows.amount(begin + i);
+            times[i] = cashflows.time_period(begin + i);
+        }
+        pv_total += detail::pv_sum(amounts, times, n, lg);
+    }
+    return pv_total;
+}
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_CASHFLOW_RANGE_H
@@ -0,0 +1,237 @@
+/*!
+ * \file        cashflow_schedule.cpp
+ * \brief       Structure-of-arrays cash flow schedule implementation.
+ * \details     Structure-of-arrays cash flow schedule implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <vector>
+#include <cassert>
+#include <cmath>
+#include "cashflow_schedule.h"
+#include "pv_kernels.h"
+#include "instrumentation.h"
+#include "thread_pool.h"
+
+using namespace financial;
+using financial::detail::log_growth;
+
+namespace {
+
+//! Number of cash flows discounted together by an accumulating sum.
+
+const std::size_t accumulation_block_size = 256;
+
+//! Sums discounted cash flows with an accumulator.
+
+/*!
+ * The discount factors of each block of cash flows are calculated by
+ * the vectorized exponential kernel, and the discounted cash flows are
+ * then passed to the accumulator in order.
+ */
+
+template <class Accumulation>
+double discounted_total(const double * amounts, const double * times,
+                        const std::size_t count, const double lg) {
+    Accumulation total;
+    double values[accumulation_block_size];
+    for ( std::size_t b = 0; b < count; b += accumulation_block_size ) {
+        const std::size_t n = std::min(accumulation_block_size, count - b);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            values[i] = -times[b + i] * lg;
+        }
+        detail::exponentials(values, n, values);
+        for ( std::size_t i = 0; i < n; ++i ) {
+            values[i] *= amounts[b + i];
+        }
+        total.add(values, n);
+    }
+    return total.result();
+}
+
+//! Sums discounted cash flows with the fused vectorized kernel.
+
+template <>
+double discounted_total<NaiveSum>(const double * amounts,
+                                  const double * times,
+                                  const std::size_t count,
+                                  const double lg) {
+    return detail::pv_sum(amounts, times, count, lg);
+}
+
+//! Sums discounted cash flows in chunks on a thread pool.
+
+/*!
+ * Each chunk's total goes to its own slot, so the totals can be added
+ * in the same order however the chunks were scheduled.
+ */
+
+template <class Accumulation>
+double chunked_total(const CashFlowView& cashflows, const double lg,
+                     ThreadPool& pool) {
+    const std::size_t count = cashflows.size();
+    if ( count <= pv_stream_chunk_size ) {
+        return discounted_total<Accumulation>(cashflows.amounts(),
+                                              cashflows.times(), count, lg);
+    }
+
+    const std::size_t num_chunks = (count + pv_stream_chunk_size - 1) /
+                                   pv_stream_chunk_size;
+    std::vector<double> totals(num_chunks);
+    auto value_chunk = [&](const std::size_t chunk) {
+        const std::size_t begin = chunk * pv_stream_chunk_size;
+        const std::size_t n = std::min(pv_stream_chunk_size, count - begin);
+        totals[chunk] = discounted_total<Accumulation>(
+                cashflows.amounts() + begin, cashflows.times() + begin,
+                n, lg);
+    };
+    for_each_chunk(&pool, num_chunks, value_chunk);
+
+    NeumaierSum total;
+    total.add(totals.data(), num_chunks);
+    return total.result();
+}
+
+}           //  namespace
+
+double detail::log_growth(const double interest_rate,
+                          const enum disc_type dt) {
+    if ( dt == disc_type::discrete ) {
+        return std::log1p(interest_rate);
+    } else if ( dt == disc_type::continuous ) {
+        return interest_rate;
+    } else {
+        assert(false);
+        return 0;
+    }
+}
+
+double financial::pv_stream(const CashFlowView& cashflows,
+                            const double interest_rate,
+                            const enum disc_type dt) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return detail::pv_sum(cashflows.amounts(), cashflows.times(),
+                          cashflows.size(), log_growth(interest_rate, dt));
+}
+
+double financial::pv_stream(const CashFlowView& cashflows,
+                            const double interest_rate,
+                            ThreadPool& pool,
+                            const enum disc_type dt) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return chunked_total<NaiveSum>(cashflows, log_growth(interest_rate, dt),
+                                   pool);
+}
+
+template <class Accumulation>
+double financial::pv_stream(const CashFlowView& cashflows,
+                            const double interest_rate,
+                            const enum disc_type dt) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return discounted_total<Accumulation>(cashflows.amounts(),
+                                          cashflows.times(),
+                                          cashflows.size(),
+                                          log_growth(interest_rate, dt));
+}
+
+template <class Accumulation>
+double financial::pv_stream(const CashFlowView& cashflows,
+                            const double interest_rate,
+                            ThreadPool& pool,
+                            const enum disc_type dt) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return chunked_total<Accumulation>(cashflows,
+                                       log_growth(interest_rate, dt), pool);
+}
+
+template double financial::pv_stream<NaiveSum>(
+        const CashFlowView& cashflows, const double interest_rate,
+        const enum disc_type dt);
+template double financial::pv_stream<NeumaierSum>(
+        const CashFlowView& cashflows, const double interest_rate,
+        const enum disc_type dt);
+template double financial::pv_stream<PairwiseSum>(
+        const CashFlowView& cashflows, const double interest_rate,
+        const enum disc_type dt);
+template double financial::pv_stream<NaiveSum>(
+        const CashFlowView& cashflows, const double interest_rate,
+        ThreadPool& pool, const enum disc_type dt);
+template double financial::pv_stream<NeumaierSum>(
+        const CashFlowView& cashflows, const double interest_rate,
+        ThreadPool& pool, const enum disc_type dt);
+template double financial::pv_stream<PairwiseSum>(
+        const CashFlowView& cashflows, const double interest_rate,
+        ThreadPool& pool, const enum disc_type dt);
+
+double financial::pv_stream_at(const CashFlowView& cashflows,
+                               const double interest_rate,
+                               const double valuation_time,
+                               const enum disc_type dt) {
+    const CashFlowView remaining = cashflows.after(valuation_time);
+    PG_FINANCIAL_PROBE(pv_stream, remaining.size());
+    const double lg = log_growth(interest_rate, dt);
+    return detail::pv_sum(remaining.amounts(), remaining.times(),
+                          remaining.size(), lg) *
+           std::exp(valuation_time * lg);
+}
+
+void financial::pv_stream(const CashFlowView& cashflows,
+                          const double * interest_rates,
+                          const std::size_t num_rates,
+                          double * present_values,
+                          const enum disc_type dt) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size() * num_rates);
+    std::vector<double> log_growths(num_rates);
+    for ( std::size_t j = 0; j < num_rates; ++j ) {
+        log_growths[j] = log_growth(interest_rates[j], dt);
+    }
+    detail::pv_sum_multi(cashflows.amounts(), cashflows.times(),
+                         cashflows.size(), log_growths.data(), num_rates,
+                         present_values);
+}
+
+std::vector<double> financial::pv_stream(const CashFlowView& cashflows,
+                                  const std::vector<double>& interest_rates,
+                                  const enum disc_type dt) {
+    std::vector<double> present_values(interest_rates.size());
+    pv_stream(cashflows, interest_rates.data(), interest_rates.size(),
+              present_values.data(), dt);
+    return present_values;
+}
+
+PvDerivatives financial::pv_stream_derivatives(const CashFlowView&
+                                               cashflows,
+                                               const double interest_rate) {
+    const double * amounts = cashflows.amounts();
+    const double * times = cashflows.times();
+    const std::size_t num_cashflows = cashflows.size();
+    const double lg = std::log1p(interest_rate);
+
+    double s0 = 0;
+    double s1 = 0;
+    double s2 = 0;
+    for ( std::size_t i = 0; i < num_cashflows; ++i ) {
+        const double t = times[i];
+        const double dcf = amounts[i] * std::exp(-t * lg);
+        s0 += dcf;
+        s1 += t * dcf;
+        s2 += t * t * dcf;
+    }
+
+    const double g = 1 + interest_rate;
+    PvDerivatives ret_value;
+    ret_value.pv = s0;
+    ret_value.first = -s1 / g;
+    ret_value.second = (s2 + s1) / (g * g);
+    return ret_value;
+}
+
+RiskMeasures financial::price_and_risk(const CashFlowView& cashflows,
+                                       const double interest_rate) {
+    PG_FINANCIAL_PROBE(price_and_risk, cashflows.size());
+    const PvDerivatives pvd = pv_stream_derivatives(cashflows, interest_rate);
+    return RiskMeasures(pvd.pv, pvd.first, pvd.second, interest_rate);
+}
@@ -0,0 +1,578 @@
+/*!
+ * \file        cashflow_schedule.h
+ * \brief       Structure-of-arrays cash flow schedule interface.
+ * \details     Structure-of-arrays cash flow schedule interface, and
+ * functions for valuing schedules with vectorized discounting kernels.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_CASHFLOW_SCHEDULE_H
+#define PG_FINANCIAL_CASHFLOW_SCHEDULE_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "accumulation.h"
+#include "arena.h"
+#include "common_financial_types.h"
+#include "thread_pool.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Number of cash flows in each chunk of a parallel `pv_stream()`.
+
+const std::size_t pv_stream_chunk_size = 65536;
+
+
+//! Cash flow schedule class template.
+
+/*!
+ * Holds a stream of timed cash flows as two separate contiguous arrays,
+ * one of amounts and one of time periods, rather than as an array of
+ * `TimedCashFlow` structs. This layout allows the discounting kernels
+ * to load several amounts and time periods at once, and is the
+ * preferred representation for long cash flow streams.
+ *
+ * The arrays are allocated with `Allocator`. `CashFlowSchedule` uses
+ * the standard allocator, and `ArenaCashFlowSchedule` draws from a
+ * `MonotonicArena`, so that short-lived schedules can be built without
+ * any heap allocation. Every function which values a schedule takes a
+ * `CashFlowView`, and so accepts either.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::CashFlowSchedule sched;
+ * for ( int i = 1; i <= 10; ++i ) {
+ *     sched.add(100, i);
+ * }
+ * double pval = financial::pv_stream(sched, 0.05);
+ * ~~~~
+ */
+
+template <class Allocator>
+class BasicCashFlowSchedule {
+    public:
+        typedef Allocator allocator_type;   /*!< the allocator type */
+
+
+        //! Default constructor
+
+        /*!
+         * Creates an empty schedule.
+         */
+
+        BasicCashFlowSchedule() : m_amounts(), m_times() {}
+
+
+        //! Constructor
+
+        /*!
+         * Creates an empty schedule using an allocator.
+         *
+         * \param alloc the allocator for the schedule's arrays.
+         */
+
+        explicit BasicCashFlowSchedule(const Allocator& alloc) :
+            m_amounts(alloc), m_times(alloc) {}
+
+
+        //! Constructor
+
+        /*!
+         * Creates a schedule from a std::vector of TimedCashFlow structs.
+         *
+         * \param cashflows the stream of cash flows to copy.
+         * \param alloc the allocator for the schedule's arrays.
+         */
+
+        explicit BasicCashFlowSchedule(const std::vector<TimedCashFlow>&
+                                       cashflows,
+                                       const Allocator& alloc =
+                                       Allocator()) :
+            m_amounts(alloc), m_times(alloc) {
+            reserve(cashflows.size());
+            for ( std::size_t i = 0; i < cashflows.size(); ++i ) {
+                add(cashflows[i].amount, cashflows[i].time_period);
+            }
+        }
+
+
+        //! Reserves storage for a number of cash flows.
+
+        /*!
+         * \param num_cashflows the number of cash flows to reserve
+         * storage for.
+         */
+
+        void reserve(const std::size_t num_cashflows) {
+            m_amounts.reserve(num_cashflows);
+            m_times.reserve(num_cashflows);
+        }
+
+
+        //! Appends a cash flow to the schedule.
+
+        /*!
+         * \param amount the amount of the cash flow.
+         * \param time_period the period at which the cash flow will occur.
+         */
+
+        void add(const double amount, const double time_period) {
+            m_amounts.push_back(amount);
+            m_times.push_back(time_period);
+        }
+
+
+        //! Removes all cash flows from the schedule.
+
+        void clear() {
+            m_amounts.clear();
+            m_times.clear();
+        }
+
+
+        //! Returns the number of cash flows in the schedule.
+
+        std::size_t size() const { return m_amounts.size(); }
+
+
+        //! Returns true if the schedule contains no cash flows.
+
+        bool empty() const { return m_amounts.empty(); }
+
+
+        //! Returns a pointer to the contiguous array of amounts.
+
+        const double * amounts() const { return m_amounts.data(); }
+
+
+        //! Returns a pointer to the contiguous array of time periods.
+
+        const double * times() const { return m_times.data(); }
+
+
+        //! Returns the allocator used by the schedule.
+
+        Allocator get_allocator() const { return m_amounts.get_allocator(); }
+
+
+        //! Returns a specified cash flow.
+
+        /*!
+         * \param index the index of the cash flow.
+         * \return the cash flow at position `index`.
+         */
+
+        TimedCashFlow operator[](const std::size_t index) const {
+            return TimedCashFlow(m_amounts[index], m_times[index]);
+        }
+
+
+    private:
+        std::vector<double, Allocator> m_amounts;   /*!< amounts */
+        std::vector<double, Allocator> m_times;     /*!< time periods */
+};
+
+
+//! Cash flow schedule using the standard allocator.
+
+typedef BasicCashFlowSchedule<std::allocator<double> > CashFlowSchedule;
+
+
+//! Cash flow schedule drawing from a `MonotonicArena`.
+
+typedef BasicCashFlowSchedule<ArenaAllocator<double> > ArenaCashFlowSchedule;
+
+
+//! Cash flow view class.
+
+/*!
+ * A non-owning view of a stream of cash flows held as two separate
+ * contiguous arrays, one of amounts and one of time periods, in the
+ * same layout as a `CashFlowSchedule`. The arrays may belong to a
+ * schedule, to a memory-mapped file (see `MappedCashFlowFile`), or to
+ * any other storage, which must outlive the view. The functions which
+ * value schedules take views, so they can value any of these without
+ * copying.
+ */
+
+class CashFlowView {
+    public:
+
+        //! Default constructor
+
+        /*!
+         * Creates an empty view.
+         */
+
+        CashFlowView() : m_amounts(0), m_times(0), m_size(0) {}
+
+
+        //! Constructor
+
+        /*!
+         * Creates a view of a pair of arrays.
+         *
+         * \param amounts an array of `size` cash flow amounts.
+         * \param times an array of `size` cash flow time periods.
+         * \param size the number of cash flows.
+         */
+
+        CashFlowView(const double * amounts, const double * times,
+                     const std::size_t size) :
+            m_amounts(amounts), m_times(times), m_size(size) {}
+
+
+        //! Constructor
+
+        /*!
+         * Creates a view of a schedule. The view is invalidated by any
+         * change to the schedule.
+         *
+         * \param cashflows the schedule to view.
+         */
+
+        template <class Allocator>
+        CashFlowView(const BasicCashFlowSchedule<Allocator>& cashflows) :
+            m_amounts(cashflows.amounts()), m_times(cashflows.times()),
+            m_size(cashflows.size()) {}
+
+
+        //! Returns the number of cash flows in the view.
+
+        std::size_t size() const { return m_size; }
+
+
+        //! Returns true if the view contains no cash flows.
+
+        bool empty() const { return m_size == 0; }
+
+
+        //! Returns a pointer to the contiguous array of amounts.
+
+        const double * amounts() const { return m_amounts; }
+
+
+        //! Returns a pointer to the contiguous array of time periods.
+
+        const double * times() const { return m_times; }
+
+
+        //! Returns a specified cash flow.
+
+        /*!
+         * \param index the index of the cash flow.
+         * \return the cash flow at position `index`.
+         */
+
+        TimedCashFlow operator[](const std::size_t index) const {
+            return TimedCashFlow(m_amounts[index], m_times[index]);
+        }
+
+
+        //! Returns a view of the cash flows after a time.
+
+        /*!
+         * Finds the first cash flow after `time_period` by binary
+         * search, so the view's cash flows must be in order of time, as
+         * those of a bond's schedule are. A cash flow at exactly
+         * `time_period` is excluded.
+         *
+         * \param time_period the time after which to view cash flows.
+         * \return a view of the cash flows after `time_period`.
+         */
+
+        CashFlowView after(const double time_period) const {
+            const double * first = std::upper_bound(m_times,
+                                                    m_times + m_size,
+                                                    time_period);
+            const std::size_t skipped = first - m_times;
+            return CashFlowView(m_amounts + skipped, first,
+                                m_size - skipped);
+        }
+
+
+    private:
+        const double * m_amounts;   /*!< cash flow amounts */
+        const double * m_times;     /*!< cash flow time periods */
+        std::size_t m_size;         /*!< number of cash flows */
+};
+
+
+//! Calculates the present value of a schedule of cash flows.
+
+/*!
+ * Equivalent to the `std::vector<TimedCashFlow>` overload of
+ * `pv_stream()`, but discounts the cash flows in batches using the
+ * widest SIMD instruction set available on the running processor
+ * (AVX-512, AVX2, or a portable scalar fallback, selected at runtime).
+ *
+ * Each discount factor is computed as `exp(-t * log1p(r))` for discrete
+ * discounting, or `exp(-t * r)` for continuous discounting. Wherever
+ * it is a normal number, each discount factor is within `2 + 2 * |t *
+ * log1p(r)|` ulp of the exact value. The scalar `discount_factor(r, t)`
+ * is within `3 + 2 * |t * log1p(r)|` ulp of it, so the two differ by at
+ * most `5 + 4 * |t * log1p(r)|` ulp. Discount factors which overflow or
+ * underflow do so as the scalar function's do. The total may further
+ * differ from the scalar `pv_stream()` by the usual reassociation
+ * error, as the cash flows are summed in several interleaved partial
+ * sums.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \param dt the type of discounting to use.
+ * \return the present value of the schedule of cash flows.
+ */
+
+double pv_stream(const CashFlowView& cashflows,
+                 const double interest_rate,
+                 const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the present value of a schedule on a thread pool.
+
+/*!
+ * As the single threaded `pv_stream()`, for very long schedules. The
+ * schedule is divided into chunks of `pv_stream_chunk_size` cash flows,
+ * whatever the number of threads, and the chunks are shared among the
+ * threads of `pool`. The present value of each chunk is calculated by
+ * the same SIMD kernel as the single threaded overload, and the chunk
+ * totals are added in order with Neumaier's compensated summation.
+ * Since neither the chunks nor the order in which their totals are
+ * added depend on the threads, the result is bit-identical for pools of
+ * any size, including a pool of one thread, and for repeated calls.
+ *
+ * A schedule of no more than `pv_stream_chunk_size` cash flows is a
+ * single chunk, and its present value is exactly that returned by the
+ * single threaded overload. For longer schedules the two differ by the
+ * reassociation error only, and the compensated addition of the chunk
+ * totals usually makes this result the more accurate of the two.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::ThreadPool pool;
+ * double pval = financial::pv_stream(liabilities, 0.04, pool);
+ * ~~~~
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \param pool the thread pool on which to value the chunks.
+ * \param dt the type of discounting to use.
+ * \return the present value of the schedule of cash flows.
+ */
+
+double pv_stream(const CashFlowView& cashflows,
+                 const double interest_rate,
+                 ThreadPool& pool,
+                 const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the present value of a schedule with a summation policy.
+
+/*!
+ * As `pv_stream()`, adding the discounted cash flows in order with the
+ * accumulator `Accumulation`, which is one of `NaiveSum`, `NeumaierSum`
+ * or `PairwiseSum`, to trade speed for accuracy on long streams whose
+ * cash flows cancel.
+ *
+ * `pv_stream<NaiveSum>()` is the same as `pv_stream()`, and sums the
+ * discounted cash flows in the vectorized kernel. For the other
+ * policies, the discount factors of each block of cash flows are
+ * calculated by the same vectorized exponential, and the discounted
+ * cash flows are passed to the accumulator in order, so the results
+ * differ from `pv_stream()` only by the summation error each removes.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * double pval = financial::pv_stream<financial::PairwiseSum>(sched, 0.05);
+ * ~~~~
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \param dt the type of discounting to use.
+ * \return the present value of the schedule of cash flows.
+ */
+
+template <class Accumulation>
+double pv_stream(const CashFlowView& cashflows,
+                 const double interest_rate,
+                 const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the present value of a schedule with a summation policy.
+
+/*!
+ * As the thread pool overload of `pv_stream()`, summing each chunk with
+ * the accumulator `Accumulation`. The chunk totals are always added
+ * with Neumaier's compensated summation, and the result is
+ * bit-identical for pools of any size.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \param pool the thread pool on which to value the chunks.
+ * \param dt the type of discounting to use.
+ * \return the present value of the schedule of cash flows.
+ */
+
+template <class Accumulation>
+double pv_stream(const CashFlowView& cashflows,
+                 const double interest_rate,
+                 ThreadPool& pool,
+                 const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the value of a schedule's remaining cash flows at a time.
+
+/*!
+ * Discounts the cash flows after `valuation_time` back to
+ * `valuation_time`, rather than to time zero, as for valuing a seasoned
+ * position from a schedule built at issuance. The schedule is neither
+ * copied nor shifted: the remaining cash flows are found by binary
+ * search, discounted to time zero as by `pv_stream()`, and compounded
+ * forward to `valuation_time`, so no memory is allocated. The cash
+ * flows must be in order of time.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \param valuation_time the time, in periods, at which to value the
+ * cash flows.
+ * \param dt the type of discounting to use.
+ * \return the value at `valuation_time` of the cash flows after it.
+ */
+
+double pv_stream_at(const CashFlowView& cashflows,
+                    const double interest_rate,
+                    const double valuation_time,
+                    const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the present values of a schedule at many interest rates.
+
+/*!
+ * Values a single schedule of cash flows at each of a set of interest
+ * rates, as for scenario and sensitivity analysis, and is equivalent to
+ * calling `pv_stream(cashflows, interest_rates[j], dt)` for each rate.
+ * Rather than traversing the whole schedule once for each rate, the
+ * schedule is traversed in blocks small enough to remain in the L1
+ * cache while all the rates are applied to them, and the rates are
+ * discounted several at a time in SIMD registers. The accuracy of each
+ * result is as for the single rate overload.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * std::vector<double> rates;
+ * for ( int bp = -200; bp <= 200; ++bp ) {
+ *     rates.push_back(0.05 + bp * 0.0001);
+ * }
+ * std::vector<double> pvals(rates.size());
+ * financial::pv_stream(sched, rates.data(), rates.size(), pvals.data());
+ * ~~~~
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rates an array of `num_rates` periodic interest rates.
+ * \param num_rates the number of interest rates.
+ * \param present_values an array of `num_rates` doubles to receive the
+ * present value of the schedule at each interest rate.
+ * \param dt the type of discounting to use.
+ */
+
+void pv_stream(const CashFlowView& cashflows,
+               const double * interest_rates,
+               const std::size_t num_rates,
+               double * present_values,
+               const enum disc_type dt = disc_type::discrete);
+
+
+//! Calculates the present values of a schedule at many interest rates.
+
+/*!
+ * As the array overload, but takes and returns std::vectors.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rates the periodic interest rates.
+ * \param dt the type of discounting to use.
+ * \return the present value of the schedule at each interest rate.
+ */
+
+std::vector<double> pv_stream(const CashFlowView& cashflows,
+                              const std::vector<double>& interest_rates,
+                              const enum disc_type dt = disc_type::discrete);
+
+
+//! Present value of a cash flow stream and its rate derivatives.
+
+/*!
+ * The `PvDerivatives` struct holds the present value of a stream of
+ * cash flows at a particular interest rate, together with its first
+ * and second derivatives with respect to that interest rate.
+ */
+
+struct PvDerivatives {
+    double pv;          /*!< the present value */
+    double first;       /*!< the first derivative of the present value */
+    double second;      /*!< the second derivative of the present value */
+};
+
+
+//! Calculates the present value of a schedule and its derivatives.
+
+/*!
+ * Calculates the present value of a schedule of cash flows discounted
+ * discretely at a periodic interest rate, together with its first and
+ * second derivatives with respect to the interest rate, in a single
+ * pass over the schedule. For a cash flow `a` at time `t`, the present
+ * value is `a * (1 + r) ** -t`, the first derivative is `-t * a *
+ * (1 + r) ** (-t - 1)`, and the second derivative is `t * (t + 1) * a *
+ * (1 + r) ** (-t - 2)`. These are the quantities needed by Newton's and
+ * Halley's methods when solving for an interest rate.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \return the present value and its first and second derivatives.
+ */
+
+PvDerivatives pv_stream_derivatives(const CashFlowView& cashflows,
+                                    const double interest_rate);
+
+
+//! Calculates the present value and risk of a schedule of cash flows.
+
+/*!
+ * As the `std::vector<TimedCashFlow>` overload of `price_and_risk()`.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param interest_rate the periodic interest rate.
+ * \return the present value and risk measures of the schedule.
+ */
+
+RiskMeasures price_and_risk(const CashFlowView& cashflows,
+                            const double interest_rate);
+
+
+//! Library implementation details namespace
+
+namespace detail {
+
+//! Returns the logarithm of the one-period growth factor.
+
+/*!
+ * \param interest_rate the periodic interest rate.
+ * \param dt the type of discounting.
+ * \return `log1p(interest_rate)` for discrete discounting, or the
+ * interest rate itself for continuous discounting, as `pv_sum()` takes
+ * it.
+ */
+
+double log_growth(const double interest_rate, const enum disc_type dt);
+
+}               //  namespace detail
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_CASHFLOW_SCHEDULE_H
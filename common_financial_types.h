@@ -85,6 +85,64 @@ struct TimedCashFlow {
         amount(amount), time_period(time_period) {}
 };
 
+//! Price and interest rate risk structure
+
+/*!
+ * The `RiskMeasures` struct describes the present value of a stream of
+ * cash flows at a particular interest rate, and the sensitivity of that
+ * present value to changes in the interest rate.
+ *
+ * The Macaulay duration is the present value weighted average time to
+ * the cash flows. The modified duration is the proportional fall in the
+ * present value for a unit rise in the interest rate, and is equal to
+ * the Macaulay duration divided by `1 + r`. The convexity is the second
+ * derivative of the present value with respect to the interest rate,
+ * divided by the present value. The DV01 is the fall in the present
+ * value for a one basis point rise in the interest rate, to first order.
+ */
+
+struct RiskMeasures {
+    double pv;                  /*!< the present value */
+    double macaulay_duration;   /*!< the Macaulay duration */
+    double modified_duration;   /*!< the modified duration */
+    double convexity;           /*!< the convexity */
+    double dv01;                /*!< the dollar value of a basis point */
+
+    //! Default constructor
+
+    /*!
+     * Initializes members to zero.
+     */
+
+    explicit RiskMeasures() : pv(0), macaulay_duration(0),
+        modified_duration(0), convexity(0), dv01(0) {}
+
+    //! Constructor
+
+    /*!
+     * Initializes members from the present value and its derivatives.
+     * The durations and convexity are undefined if the present value
+     * is zero.
+     *
+     * \param pv the present value
+     * \param first the first derivative of the present value with
+     * respect to the interest rate
+     * \param second the second derivative of the present value with
+     * respect to the interest rate
+     * \param interest_rate the periodic interest rate
+     */
+
+    explicit RiskMeasures(const double pv,
+                          const double first,
+                          const double second,
+                          const double interest_rate) :
+        pv(pv),
+        macaulay_duration(-first * (1 + interest_rate) / pv),
+        modified_duration(-first / pv),
+        convexity(second / pv),
+        dv01(-first * 0.0001) {}
+};
+
 }               //  namespace financial
 
 #endif          //  PG_FINANCIAL_COMMON_TYPES_H
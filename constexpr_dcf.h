@@ -0,0 +1,403 @@
+/*!
+ * \file        constexpr_dcf.h
+ * \brief       Compile-time discounted cash flow functions.
+ * \details     Header-only versions of the basic discounted cash flow
+ * functions, for integer numbers of periods known at compile time and
+ * for discounting and annuity types chosen at compile time. Calls with
+ * constant arguments are evaluated by the compiler, and calls in loops
+ * are inlined in full.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_CONSTEXPR_DCF_H
+#define PG_FINANCIAL_CONSTEXPR_DCF_H
+
+#include <cmath>
+#include "common_financial_types.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Raises a number to a non-negative integer power.
+
+/*!
+ * Uses exponentiation by squaring, so requires at most
+ * `2 * log2(exponent)` multiplications, and can be evaluated at
+ * compile time. Each multiplication adds a rounding error which later
+ * squarings amplify, so the relative error grows by about 0.7 ulp for
+ * each unit of the exponent, and the result is as accurate as
+ * `std::pow()` only for the first few powers. Any rounding error in
+ * `base` is multiplied by `exponent` as well, so the compounding
+ * factors below do not raise a rounded `1 + interest_rate` this way.
+ *
+ * \param base the number to raise to a power.
+ * \param exponent the power to raise it to.
+ * \return `base` raised to the power `exponent`.
+ */
+
+constexpr double ipow(const double base, const unsigned exponent) {
+    return exponent == 0 ? 1.0 :
+           (exponent % 2 ? base * ipow(base * base, exponent / 2) :
+                           ipow(base * base, exponent / 2));
+}
+
+
+//! Library implementation details namespace
+
+namespace detail {
+
+//! Returns `(1 + a) * (1 + b) - 1`, given `a` and `b`.
+
+constexpr double combine_growth(const double a, const double b) {
+    return a + b + a * b;
+}
+
+//! Raises a growth factor to a non-negative integer power.
+
+/*!
+ * Calculates `(1 + growth)^exponent - 1` by exponentiation by squaring,
+ * as `ipow()` does, but on the growth over one period rather than on
+ * the compounding factor. A square is `growth * (2 + growth)`, so the
+ * growth is never added to one and rounded, and the result has no
+ * cancellation when the compounding factor is close to one.
+ *
+ * \param growth the growth over one period.
+ * \param exponent the number of periods.
+ * \return the growth over `exponent` periods.
+ */
+
+constexpr double growth_power(const double growth, const unsigned exponent) {
+    return exponent == 0 ? 0.0 :
+           (exponent % 2 ?
+            combine_growth(growth, growth_power(growth * (2 + growth),
+                                                exponent / 2)) :
+            growth_power(growth * (2 + growth), exponent / 2));
+}
+
+//! Calculates `compound_factor_int(interest_rate, num_periods) - 1`.
+
+/*!
+ * The compile-time twin of the `expm1()` growth used by the runtime
+ * annuity functions, with no cancellation for a small rate.
+ *
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods over which to compound.
+ * \return the growth over `num_periods` periods.
+ */
+
+constexpr double compound_growth_int(const double interest_rate,
+                                     const int num_periods) {
+    return num_periods >= 0 ?
+           growth_power(interest_rate,
+                        static_cast<unsigned>(num_periods)) :
+           -growth_power(interest_rate,
+                         static_cast<unsigned>(-num_periods)) /
+           (1 + growth_power(interest_rate,
+                             static_cast<unsigned>(-num_periods)));
+}
+
+}               //  namespace detail
+
+
+//! Calculates a compounding factor for an integer number of periods.
+
+/*!
+ * As `compound_factor()` with discrete compounding, for a number of
+ * periods which is an integer but not necessarily known at compile time.
+ * The factor is compounded from the interest rate itself, as
+ * `detail::growth_power()` does, so the rounding of `1 + interest_rate`
+ * is not multiplied by the number of periods.
+ *
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods over which to compound.
+ * \return the calculated compounding factor.
+ */
+
+constexpr double compound_factor_int(const double interest_rate,
+                                     const int num_periods) {
+    return num_periods >= 0 ?
+           1 + detail::growth_power(interest_rate,
+                                    static_cast<unsigned>(num_periods)) :
+           1 / (1 + detail::growth_power(interest_rate,
+                                         static_cast<unsigned>(
+                                             -num_periods)));
+}
+
+
+//! Calculates a discount factor for an integer number of periods.
+
+/*!
+ * As `discount_factor()` with discrete discounting, for a number of
+ * periods which is an integer but not necessarily known at compile time.
+ *
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods over which to discount.
+ * \return the calculated discount factor.
+ */
+
+constexpr double discount_factor_int(const double interest_rate,
+                                     const int num_periods) {
+    return 1 / compound_factor_int(interest_rate, num_periods);
+}
+
+
+//! Calculates a compounding factor for a fixed number of periods.
+
+/*!
+ * Sample usage:
+ * ~~~~{.cpp}
+ * constexpr double cf = financial::compound_factor<7>(0.1);
+ * ~~~~
+ *
+ * \tparam N the number of periods over which to compound.
+ * \param interest_rate the periodic interest rate.
+ * \return the calculated compounding factor.
+ */
+
+template <int N>
+constexpr double compound_factor(const double interest_rate) {
+    return compound_factor_int(interest_rate, N);
+}
+
+
+//! Calculates a discount factor for a fixed number of periods.
+
+/*!
+ * \tparam N the number of periods over which to discount.
+ * \param interest_rate the periodic interest rate.
+ * \return the calculated discount factor.
+ */
+
+template <int N>
+constexpr double discount_factor(const double interest_rate) {
+    return discount_factor_int(interest_rate, N);
+}
+
+
+//! Calculates a present value over a fixed number of periods.
+
+/*!
+ * \tparam N the number of periods until the cash flow.
+ * \param cashflow the nominal amount of the single cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \return the present value of the cash flow.
+ */
+
+template <int N>
+constexpr double pv(const double cashflow, const double interest_rate) {
+    return cashflow * discount_factor<N>(interest_rate);
+}
+
+
+//! Calculates a future value over a fixed number of periods.
+
+/*!
+ * \tparam N the number of periods until maturity.
+ * \param cashflow the nominal amount of the invested cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \return the future value of the cash flow.
+ */
+
+template <int N>
+constexpr double fv(const double cashflow, const double interest_rate) {
+    return cashflow * compound_factor<N>(interest_rate);
+}
+
+
+//! Calculates a compounding factor with a fixed type of compounding.
+
+/*!
+ * As `compound_factor()`, but the type of compounding is a template
+ * parameter rather than a runtime argument, so no branch is needed.
+ *
+ * \tparam DT the type of compounding to use.
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods over which to compound.
+ * \return the calculated compounding factor.
+ */
+
+template <disc_type DT>
+double compound_factor(const double interest_rate, const double num_periods);
+
+//! Discrete specialization of compound_factor<disc_type>().
+
+template <>
+inline double compound_factor<disc_type::discrete>(const double interest_rate,
+                                                   const double num_periods) {
+    return std::pow(1 + interest_rate, num_periods);
+}
+
+//! Continuous specialization of compound_factor<disc_type>().
+
+template <>
+inline double compound_factor<disc_type::continuous>(const double
+                                                     interest_rate,
+                                                     const double
+                                                     num_periods) {
+    return std::exp(interest_rate * num_periods);
+}
+
+
+//! Calculates a discount factor with a fixed type of discounting.
+
+/*!
+ * \tparam DT the type of discounting to use.
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods over which to discount.
+ * \return the calculated discount factor.
+ */
+
+template <disc_type DT>
+inline double discount_factor(const double interest_rate,
+                              const double num_periods) {
+    return 1 / compound_factor<DT>(interest_rate, num_periods);
+}
+
+
+//! Calculates a present value with a fixed type of discounting.
+
+/*!
+ * \tparam DT the type of discounting to use.
+ * \param cashflow the nominal amount of the single cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods until the cash flow.
+ * \return the present value of the cash flow.
+ */
+
+template <disc_type DT>
+inline double pv(const double cashflow,
+                 const double interest_rate,
+                 const double num_periods) {
+    return cashflow * discount_factor<DT>(interest_rate, num_periods);
+}
+
+
+//! Calculates a future value with a fixed type of compounding.
+
+/*!
+ * \tparam DT the type of compounding to use.
+ * \param cashflow the nominal amount of the invested cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periods until maturity.
+ * \return the future value of the cash flow.
+ */
+
+template <disc_type DT>
+inline double fv(const double cashflow,
+                 const double interest_rate,
+                 const double num_periods) {
+    return cashflow * compound_factor<DT>(interest_rate, num_periods);
+}
+
+
+//! Calculates the present value of a perpetuity of a fixed type.
+
+/*!
+ * \tparam AT the type of perpetuity.
+ * \param cashflow the nominal amount of the periodic cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \return the present value of the perpetuity.
+ */
+
+template <annuity_type AT>
+constexpr double pv_perpetuity(const double cashflow,
+                               const double interest_rate) {
+    return AT == annuity_type::due ?
+           cashflow / interest_rate * (1 + interest_rate) :
+           cashflow / interest_rate;
+}
+
+
+//! Calculates the present value of an annuity of fixed type and length.
+
+/*!
+ * Sample usage:
+ * ~~~~{.cpp}
+ * constexpr double pva = financial::pv_annuity<15,
+ *                        financial::annuity_type::due>(150, 0.08);
+ * ~~~~
+ *
+ * \tparam N the number of periodic cash flows.
+ * \tparam AT the type of annuity.
+ * \param cashflow the nominal amount of the periodic cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \return the present value of the annuity.
+ */
+
+template <int N, annuity_type AT = annuity_type::immediate>
+constexpr double pv_annuity(const double cashflow,
+                            const double interest_rate) {
+    return pv_perpetuity<AT>(cashflow, interest_rate) *
+           -detail::compound_growth_int(interest_rate, -N);
+}
+
+
+//! Calculates the present value of an annuity of a fixed type.
+
+/*!
+ * As `pv_annuity()`, but the type of annuity is a template parameter
+ * rather than a runtime argument, and the integer number of periods is
+ * discounted by exponentiation by squaring, with no cancellation for a
+ * small rate.
+ *
+ * \tparam AT the type of annuity.
+ * \param cashflow the nominal amount of the periodic cash flow.
+ * \param interest_rate the periodic interest rate.
+ * \param num_periods the number of periodic cash flows.
+ * \return the present value of the annuity.
+ */
+
+template <annuity_type AT>
+constexpr double pv_annuity(const double cashflow,
+                            const double interest_rate,
+                            const int num_periods) {
+    return pv_perpetuity<AT>(cashflow, interest_rate) *
+           -detail::compound_growth_int(interest_rate, -num_periods);
+}
+
+
+//! Calculates the periodic payment to a sinking fund of fixed length.
+
+/*!
+ * \tparam N the number of periodic payments.
+ * \param fund_value the terminal value of the sinking fund.
+ * \param interest_rate the periodic interest rate.
+ * \return the nominal amount of the required periodic payment.
+ */
+
+template <int N>
+constexpr double sinking_fund_payment(const double fund_value,
+                                      const double interest_rate) {
+    return fund_value * interest_rate /
+           detail::compound_growth_int(interest_rate, N);
+}
+
+
+//! Calculates the periodic repayment of a loan of fixed length.
+
+/*!
+ * Sample usage:
+ * ~~~~{.cpp}
+ * constexpr double lp = financial::loan_repayment<360>(80000, 0.0075);
+ * ~~~~
+ *
+ * \tparam N the number of periodic repayments.
+ * \param loan_amount the amount of the loan.
+ * \param interest_rate the periodic interest rate.
+ * \return the nominal amount of the periodic loan repayment.
+ */
+
+template <int N>
+constexpr double loan_repayment(const double loan_amount,
+                                const double interest_rate) {
+    return loan_amount * interest_rate /
+           -detail::compound_growth_int(interest_rate, -N);
+}
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_CONSTEXPR_DCF_H
@@ -0,0 +1,268 @@
+/*!
+ * \file        dates.cpp
+ * \brief       Dates, day count conventions and dated cash flows
+ * implementation.
+ * \details     Dates, day count conventions and dated cash flows
+ * implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cassert>
+#include <cstddef>
+#include <iomanip>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+#include <stdint.h>
+#include "cashflow_schedule.h"
+#include "dates.h"
+
+using namespace financial;
+
+namespace {
+
+//! Number of years in the range of dates.
+
+const int num_years = last_year - first_year + 1;
+
+//! Days before the start of each month, in common and leap years.
+
+const int days_before_month[2][13] = {
+    {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+    {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}
+};
+
+//! Returns 1 for a leap year, and 0 otherwise.
+
+int is_leap(const int year) {
+    return ( year % 4 == 0 && (year % 100 != 0 || year % 400 == 0) ) ? 1 : 0;
+}
+
+//! Calendar fields of a date, packed into four bytes.
+
+struct CalendarFields {
+    uint16_t year;      /*!< the year */
+    uint8_t month;      /*!< the month */
+    uint8_t day;        /*!< the day of the month */
+};
+
+//! Precomputed table of the calendar fields of every date in the range.
+
+struct DateTable {
+    DateTable() : fields(), year_start(), inverse_year_length() {
+        int serial = 0;
+        for ( int y = 0; y < num_years; ++y ) {
+            const int year = first_year + y;
+            const int leap = is_leap(year);
+            year_start[y] = serial;
+            inverse_year_length[y] = 1.0 / (365 + leap);
+            for ( int m = 1; m <= 12; ++m ) {
+                const int days = days_before_month[leap][m] -
+                                 days_before_month[leap][m - 1];
+                for ( int d = 1; d <= days; ++d ) {
+                    CalendarFields f;
+                    f.year = static_cast<uint16_t>(year);
+                    f.month = static_cast<uint8_t>(m);
+                    f.day = static_cast<uint8_t>(d);
+                    fields.push_back(f);
+                    ++serial;
+                }
+            }
+        }
+        year_start[num_years] = serial;
+    }
+
+    std::vector<CalendarFields> fields;     /*!< fields, by serial */
+    int year_start[num_years + 1];          /*!< serial of each 1 January,
+                                                 and one past the range */
+    double inverse_year_length[num_years];  /*!< 1 / days in each year */
+};
+
+//! Returns the date table, building it on the first call.
+
+const DateTable& date_table() {
+    static const DateTable table;
+    return table;
+}
+
+//! Returns the number of dates in the range.
+
+int num_dates() {
+    return date_table().year_start[num_years];
+}
+
+//! Calculates an ACT/ACT ISDA year fraction from table lookups.
+
+/*!
+ * Counts the days in each calendar year over that year's length,
+ * taking whole years between the first and last as one each.
+ */
+
+inline double act_act_fraction(const DateTable& table, const int start,
+                               const int end) {
+    if ( end < start ) {
+        return -act_act_fraction(table, end, start);
+    }
+    const int y1 = table.fields[start].year - first_year;
+    const int y2 = table.fields[end].year - first_year;
+    if ( y1 == y2 ) {
+        return (end - start) * table.inverse_year_length[y1];
+    }
+    return (table.year_start[y1 + 1] - start) *
+           table.inverse_year_length[y1] +
+           (y2 - y1 - 1) +
+           (end - table.year_start[y2]) * table.inverse_year_length[y2];
+}
+
+//! Calculates a 30/360 year fraction from table lookups.
+
+inline double thirty_360_fraction(const DateTable& table, const int start,
+                                  const int end, const bool eurobond) {
+    const CalendarFields& f1 = table.fields[start];
+    const CalendarFields& f2 = table.fields[end];
+    int d1 = f1.day;
+    int d2 = f2.day;
+    if ( d1 == 31 ) {
+        d1 = 30;
+    }
+    if ( d2 == 31 && (eurobond || d1 == 30) ) {
+        d2 = 30;
+    }
+    return (360 * (f2.year - f1.year) + 30 * (f2.month - f1.month) +
+            (d2 - d1)) / 360.0;
+}
+
+//! Calculates year fractions from a start date to many dates.
+
+/*!
+ * `date_at(i)` returns the serial of the `i`th date. The convention is
+ * chosen once, outside the loop over the dates.
+ */
+
+template <class DateAt>
+void fractions_from(const int start, const std::size_t count,
+                    const day_count dc, const DateAt& date_at,
+                    double * fractions) {
+    const DateTable& table = date_table();
+    switch ( dc ) {
+        case day_count::act_360:
+            for ( std::size_t i = 0; i < count; ++i ) {
+                fractions[i] = (date_at(i) - start) / 360.0;
+            }
+            break;
+
+        case day_count::act_365_fixed:
+            for ( std::size_t i = 0; i < count; ++i ) {
+                fractions[i] = (date_at(i) - start) / 365.0;
+            }
+            break;
+
+        case day_count::act_act_isda:
+            for ( std::size_t i = 0; i < count; ++i ) {
+                fractions[i] = act_act_fraction(table, start, date_at(i));
+            }
+            break;
+
+        case day_count::thirty_360:
+            for ( std::size_t i = 0; i < count; ++i ) {
+                fractions[i] = thirty_360_fraction(table, start,
+                                                   date_at(i), false);
+            }
+            break;
+
+        case day_count::thirty_e_360:
+            for ( std::size_t i = 0; i < count; ++i ) {
+                fractions[i] = thirty_360_fraction(table, start,
+                                                   date_at(i), true);
+            }
+            break;
+
+        default:
+            assert(false);
+            break;
+    }
+}
+
+}           //  namespace
+
+Date::Date(const int year, const int month, const int day) : m_serial(0) {
+    if ( year < first_year || year > last_year ) {
+        throw std::domain_error("Date is outside the range of dates");
+    }
+    const int leap = is_leap(year);
+    if ( month < 1 || month > 12 || day < 1 ||
+         day > days_before_month[leap][month] -
+               days_before_month[leap][month - 1] ) {
+        throw std::domain_error("Invalid date");
+    }
+    m_serial = date_table().year_start[year - first_year] +
+               days_before_month[leap][month - 1] + day - 1;
+}
+
+Date Date::from_serial(const int serial) {
+    if ( serial < 0 || serial >= num_dates() ) {
+        throw std::domain_error("Date is outside the range of dates");
+    }
+    Date date;
+    date.m_serial = serial;
+    return date;
+}
+
+int Date::year() const {
+    return date_table().fields[m_serial].year;
+}
+
+int Date::month() const {
+    return date_table().fields[m_serial].month;
+}
+
+int Date::day() const {
+    return date_table().fields[m_serial].day;
+}
+
+std::ostream& financial::operator<<(std::ostream& out, const Date date) {
+    const char fill = out.fill('0');
+    out << std::setw(4) << date.year() << '-' << std::setw(2)
+        << date.month() << '-' << std::setw(2) << date.day();
+    out.fill(fill);
+    return out;
+}
+
+double financial::year_fraction(const Date start, const Date end,
+                                const day_count dc) {
+    double fraction = 0;
+    const int serial = end.serial();
+    fractions_from(start.serial(), 1, dc,
+                   [serial](const std::size_t) { return serial; },
+                   &fraction);
+    return fraction;
+}
+
+void financial::year_fractions(const Date start, const Date * dates,
+                               const std::size_t count, const day_count dc,
+                               double * fractions) {
+    fractions_from(start.serial(), count, dc,
+                   [dates](const std::size_t i) { return dates[i].serial(); },
+                   fractions);
+}
+
+CashFlowSchedule financial::dated_schedule(const std::vector<DatedCashFlow>&
+                                           cashflows,
+                                           const Date valuation_date,
+                                           const day_count dc) {
+    std::vector<double> times(cashflows.size());
+    fractions_from(valuation_date.serial(), cashflows.size(), dc,
+                   [&cashflows](const std::size_t i) {
+                       return cashflows[i].date.serial();
+                   },
+                   times.data());
+
+    CashFlowSchedule sched;
+    sched.reserve(cashflows.size());
+    for ( std::size_t i = 0; i < cashflows.size(); ++i ) {
+        sched.add(cashflows[i].amount, times[i]);
+    }
+    return sched;
+}
@@ -0,0 +1,278 @@
+/*!
+ * \file        dates.h
+ * \brief       Dates, day count conventions and dated cash flows interface.
+ * \details     Serial dates backed by a precomputed date table, year
+ * fractions under the common day count conventions, and cash flows
+ * which are paid on dates rather than at times.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_DATES_H
+#define PG_FINANCIAL_DATES_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "cashflow_schedule.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! First year in the range of dates.
+
+const int first_year = 1900;
+
+
+//! Last year in the range of dates.
+
+const int last_year = 2199;
+
+
+//! Date class.
+
+/*!
+ * A calendar date in the range 1 January 1900 to 31 December 2199,
+ * held as a serial number of days since 1 January 1900, which is
+ * serial zero. The year, month and day of every date in the range are
+ * precomputed into a table the first time a date is constructed, so
+ * converting a serial date to its calendar fields is a table lookup.
+ *
+ * Dates are as cheap to copy and compare as integers, and the number
+ * of days between two dates is the difference of their serials.
+ */
+
+class Date {
+    public:
+
+        //! Default constructor
+
+        /*!
+         * Creates the date 1 January 1900.
+         */
+
+        Date() : m_serial(0) {}
+
+
+        //! Constructor
+
+        /*!
+         * \param year the year.
+         * \param month the month, from 1 for January to 12.
+         * \param day the day of the month, from 1.
+         * \throws std::domain_error if the date is not a valid date in
+         * the range.
+         */
+
+        Date(const int year, const int month, const int day);
+
+
+        //! Creates a date from its serial number.
+
+        /*!
+         * \param serial the number of days since 1 January 1900.
+         * \return the date.
+         * \throws std::domain_error if the serial is outside the range.
+         */
+
+        static Date from_serial(const int serial);
+
+
+        //! Returns the number of days since 1 January 1900.
+
+        int serial() const { return m_serial; }
+
+
+        //! Returns the year.
+
+        int year() const;
+
+
+        //! Returns the month, from 1 for January to 12.
+
+        int month() const;
+
+
+        //! Returns the day of the month, from 1.
+
+        int day() const;
+
+
+        //! Returns the day of the week, from 0 for Monday to 6.
+
+        int weekday() const { return m_serial % 7; }
+
+
+        //! Returns the date a number of days later.
+
+        /*!
+         * \param days the number of days, which may be negative.
+         * \return the date `days` days later.
+         * \throws std::domain_error if the result is outside the range.
+         */
+
+        Date add_days(const int days) const {
+            return from_serial(m_serial + days);
+        }
+
+
+        //! Returns the number of days from another date to this one.
+
+        int operator-(const Date& other) const {
+            return m_serial - other.m_serial;
+        }
+
+
+        //! Comparison operators, ordering dates in time.
+
+        bool operator==(const Date& other) const {
+            return m_serial == other.m_serial;
+        }
+
+        bool operator!=(const Date& other) const {
+            return m_serial != other.m_serial;
+        }
+
+        bool operator<(const Date& other) const {
+            return m_serial < other.m_serial;
+        }
+
+        bool operator<=(const Date& other) const {
+            return m_serial <= other.m_serial;
+        }
+
+        bool operator>(const Date& other) const {
+            return m_serial > other.m_serial;
+        }
+
+        bool operator>=(const Date& other) const {
+            return m_serial >= other.m_serial;
+        }
+
+
+    private:
+        int m_serial;           /*!< days since 1 January 1900 */
+};
+
+
+//! Writes a date in ISO 8601 format, as YYYY-MM-DD.
+
+std::ostream& operator<<(std::ostream& out, const Date date);
+
+
+//! Enumeration class for day count conventions
+
+enum class day_count {
+    act_360,        /*!< actual days over 360 */
+    act_365_fixed,  /*!< actual days over 365 */
+    act_act_isda,   /*!< actual days in each year over that year's
+                         length, as in the ISDA definitions */
+    thirty_360,     /*!< 30/360 US bond basis: a 31st is the 30th,
+                         and an end date on the 31st is the 30th only
+                         if the start date is the 30th or 31st */
+    thirty_e_360    /*!< 30E/360 Eurobond basis: every 31st is the
+                         30th */
+};
+
+
+//! Calculates the year fraction between two dates.
+
+/*!
+ * \param start the start date.
+ * \param end the end date, which may be before the start date, giving
+ * a negative year fraction.
+ * \param dc the day count convention.
+ * \return the year fraction from `start` to `end`.
+ */
+
+double year_fraction(const Date start, const Date end,
+                     const day_count dc);
+
+
+//! Calculates the year fractions from a date to many dates.
+
+/*!
+ * Calculates `fractions[i] = year_fraction(start, dates[i], dc)` for
+ * each `i`. The calendar fields each convention needs are looked up in
+ * the date table, rather than calculated, and the loop over the dates
+ * is specialized for the convention, so converting a date costs a few
+ * nanoseconds.
+ *
+ * \param start the start date.
+ * \param dates an array of `count` dates.
+ * \param count the number of dates.
+ * \param dc the day count convention.
+ * \param fractions an array of `count` doubles to receive the year
+ * fractions.
+ */
+
+void year_fractions(const Date start, const Date * dates,
+                    const std::size_t count, const day_count dc,
+                    double * fractions);
+
+
+//! Dated cash flow structure
+
+/*!
+ * The `DatedCashFlow` struct describes the amount of a future cash flow
+ * and the date on which it will be paid.
+ */
+
+struct DatedCashFlow {
+    double amount;      /*!< the amount of the cash flow */
+    Date date;          /*!< the date on which the cash flow will be paid */
+
+    //! Default constructor
+
+    /*!
+     * Initializes the amount to zero.
+     */
+
+    explicit DatedCashFlow() : amount(0), date() {}
+
+    //! Constructor
+
+    /*!
+     * Initializes members to provided values.
+     *
+     * \param amount the amount of the cash flow
+     * \param date the date on which the cash flow will be paid
+     */
+
+    explicit DatedCashFlow(const double amount, const Date date) :
+        amount(amount), date(date) {}
+};
+
+
+//! Builds a cash flow schedule from dated cash flows.
+
+/*!
+ * Converts the date of each cash flow to its year fraction from the
+ * valuation date, so the schedule can be discounted at an annual rate
+ * with `pv_stream()`. Cash flows dated before the valuation date have
+ * negative times, and are compounded rather than discounted.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * const financial::CashFlowSchedule sched =
+ *     financial::dated_schedule(flows, financial::Date(2013, 6, 28),
+ *                               financial::day_count::act_365_fixed);
+ * double pval = financial::pv_stream(sched, 0.045);
+ * ~~~~
+ *
+ * \param cashflows the dated cash flows.
+ * \param valuation_date the date at which the cash flows are valued.
+ * \param dc the day count convention.
+ * \return the cash flows, timed in years from the valuation date.
+ */
+
+CashFlowSchedule dated_schedule(const std::vector<DatedCashFlow>& cashflows,
+                                const Date valuation_date,
+                                const day_count dc);
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_DATES_H
@@ -0,0 +1,104 @@
+/*!
+ * \file        discount_table.cpp
+ * \brief       Precomputed discount factor table implementation.
+ * \details     Precomputed discount factor table implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "basic_dcf.h"
+#include "discount_table.h"
+
+using namespace financial;
+
+DiscountTable::DiscountTable(const double interest_rate,
+                             const int max_periods,
+                             const int steps_per_period,
+                             const enum disc_type dt) :
+    m_interest_rate(interest_rate),
+    m_max_periods(max_periods),
+    m_steps_per_period(steps_per_period),
+    m_dt(dt),
+    m_step_log_growth(0),
+    m_df(),
+    m_cf() {
+    if ( max_periods < 0 ) {
+        throw std::domain_error("Number of periods cannot be negative");
+    }
+    if ( steps_per_period < 1 ) {
+        throw std::domain_error("Steps per period must be at least one");
+    }
+
+    const double log_growth = ( dt == disc_type::continuous ) ?
+                              interest_rate : std::log1p(interest_rate);
+    m_step_log_growth = log_growth / steps_per_period;
+
+    const std::size_t num_points =
+        static_cast<std::size_t>(max_periods) * steps_per_period + 1;
+    m_df.reserve(num_points);
+    m_cf.reserve(num_points);
+    for ( std::size_t k = 0; k < num_points; ++k ) {
+        const double num_periods = static_cast<double>(k) / steps_per_period;
+        m_cf.push_back(financial::compound_factor(interest_rate,
+                                                  num_periods, dt));
+        m_df.push_back(financial::discount_factor(interest_rate,
+                                                  num_periods, dt));
+    }
+}
+
+bool DiscountTable::locate(const double num_periods, std::size_t& index,
+                           double& fraction) const {
+    const double position = num_periods * m_steps_per_period;
+    if ( !(position >= 0 &&
+           position <= static_cast<double>(m_df.size() - 1)) ) {
+        return false;
+    }
+    index = static_cast<std::size_t>(position);
+    fraction = position - index;
+    return true;
+}
+
+double DiscountTable::compound_factor(const double num_periods) const {
+    std::size_t index;
+    double fraction;
+    if ( !locate(num_periods, index, fraction) ) {
+        return financial::compound_factor(m_interest_rate, num_periods, m_dt);
+    }
+    if ( fraction == 0 ) {
+        return m_cf[index];
+    }
+
+    //  Linear interpolation of the log of the factor between grid points
+    //  is the same as growing the lower grid point's factor at the
+    //  table's rate for the remaining fraction of a step.
+
+    return m_cf[index] * std::exp(fraction * m_step_log_growth);
+}
+
+double DiscountTable::discount_factor(const double num_periods) const {
+    std::size_t index;
+    double fraction;
+    if ( !locate(num_periods, index, fraction) ) {
+        return financial::discount_factor(m_interest_rate, num_periods, m_dt);
+    }
+    if ( fraction == 0 ) {
+        return m_df[index];
+    }
+    return m_df[index] * std::exp(-fraction * m_step_log_growth);
+}
+
+double DiscountTable::pv_stream(const std::vector<TimedCashFlow>& cashflows)
+    const {
+    double pv_total = 0;
+    for ( std::vector<TimedCashFlow>::const_iterator itr = cashflows.begin();
+            itr != cashflows.end(); ++itr ) {
+        const TimedCashFlow& cf = *itr;
+        pv_total += pv(cf.amount, cf.time_period);
+    }
+    return pv_total;
+}
@@ -0,0 +1,161 @@
+/*!
+ * \file        discount_table.h
+ * \brief       Precomputed discount factor table interface.
+ * \details     Precomputed discount factor table interface.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_DISCOUNT_TABLE_H
+#define PG_FINANCIAL_DISCOUNT_TABLE_H
+
+#include <cstddef>
+#include <vector>
+#include "common_financial_types.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Discount factor table class.
+
+/*!
+ * Precomputes the discount and compounding factors for a single
+ * interest rate over a grid of periods, so that repeatedly discounting
+ * at that rate costs a table load rather than a call to `std::pow()`.
+ *
+ * The grid runs from zero to a maximum number of periods in steps of a
+ * fixed fraction of a period. Factors for numbers of periods on the grid
+ * are identical to those returned by `discount_factor()` and
+ * `compound_factor()`. Factors between grid points are found by linear
+ * interpolation of the logarithm of the discount factor, which is exact
+ * for a single interest rate up to rounding, at the cost of a call to
+ * `std::exp()`. Factors beyond the grid, or for negative numbers of
+ * periods, are calculated directly.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * const financial::DiscountTable monthly(0.0035, 360);
+ * double total = 0;
+ * for ( int i = 1; i <= 360; ++i ) {
+ *     total += monthly.pv(1250, i);
+ * }
+ * ~~~~
+ */
+
+class DiscountTable {
+    public:
+
+        //! Constructor
+
+        /*!
+         * Builds the tables.
+         *
+         * \param interest_rate the periodic interest rate.
+         * \param max_periods the number of periods covered by the tables.
+         * \param steps_per_period the number of grid points in each
+         * period, for instance 12 for a monthly grid over annual periods.
+         * \param dt the type of discounting to use.
+         * \throws std::domain_error if `max_periods` is negative or
+         * `steps_per_period` is less than one.
+         */
+
+        explicit DiscountTable(const double interest_rate,
+                               const int max_periods,
+                               const int steps_per_period = 1,
+                               const enum disc_type dt =
+                                   disc_type::discrete);
+
+
+        //! Returns the periodic interest rate.
+
+        double interest_rate() const { return m_interest_rate; }
+
+
+        //! Returns the number of periods covered by the tables.
+
+        int max_periods() const { return m_max_periods; }
+
+
+        //! Returns the number of grid points in each period.
+
+        int steps_per_period() const { return m_steps_per_period; }
+
+
+        //! Returns a compounding factor.
+
+        /*!
+         * \param num_periods the number of periods over which to compound.
+         * \return the compounding factor at the table's interest rate.
+         */
+
+        double compound_factor(const double num_periods) const;
+
+
+        //! Returns a discount factor.
+
+        /*!
+         * \param num_periods the number of periods over which to discount.
+         * \return the discount factor at the table's interest rate.
+         */
+
+        double discount_factor(const double num_periods) const;
+
+
+        //! Calculates the present value of a single cash flow.
+
+        /*!
+         * \param cashflow the nominal amount of the single cash flow.
+         * \param num_periods the number of periods until the cash flow.
+         * \return the present value of the cash flow.
+         */
+
+        double pv(const double cashflow, const double num_periods) const {
+            return cashflow * discount_factor(num_periods);
+        }
+
+
+        //! Calculates the future value of a single invested cash flow.
+
+        /*!
+         * \param cashflow the nominal amount of the invested cash flow.
+         * \param num_periods the number of periods until maturity.
+         * \return the future value of the cash flow.
+         */
+
+        double fv(const double cashflow, const double num_periods) const {
+            return cashflow * compound_factor(num_periods);
+        }
+
+
+        //! Calculates the present value of a stream of cash flows.
+
+        /*!
+         * \param cashflows a std::vector of TimedCashFlow structs
+         * representing the stream of cash flows.
+         * \return the present value of the stream of cash flows.
+         */
+
+        double pv_stream(const std::vector<TimedCashFlow>& cashflows) const;
+
+
+    private:
+
+        //! Finds the grid interval containing a number of periods.
+        bool locate(const double num_periods, std::size_t& index,
+                    double& fraction) const;
+
+        double m_interest_rate;         /*!< periodic interest rate */
+        int m_max_periods;              /*!< periods covered */
+        int m_steps_per_period;         /*!< grid points per period */
+        enum disc_type m_dt;            /*!< type of discounting */
+        double m_step_log_growth;       /*!< log of growth per step */
+        std::vector<double> m_df;       /*!< discount factors */
+        std::vector<double> m_cf;       /*!< compounding factors */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_DISCOUNT_TABLE_H
@@ -11,7 +11,27 @@
 #define PG_FINANCIAL_H
 
 #include "common_financial_types.h"
+#include "accumulation.h"
+#include "arena.h"
 #include "basic_dcf.h"
+#include "batch_dcf.h"
+#include "constexpr_dcf.h"
+#include "dates.h"
+#include "discount_table.h"
+#include "amortization.h"
+#include "yield_curve.h"
 #include "bond.h"
+#include "bootstrap.h"
+#include "calendar.h"
+#include "cashflow_schedule.h"
+#include "cashflow_file.h"
+#include "cashflow_range.h"
+#include "instrumentation.h"
+#include "instruments.h"
+#include "irr.h"
+#include "philox.h"
+#include "rate_simulation.h"
+#include "thread_pool.h"
+#include "portfolio.h"
 
 #endif          //  PG_FINANCIAL_H
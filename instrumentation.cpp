@@ -0,0 +1,214 @@
+/*!
+ * \file        instrumentation.cpp
+ * \brief       Hot path instrumentation implementation.
+ * \details     Hot path instrumentation implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+#include "instrumentation.h"
+
+using namespace financial;
+
+namespace {
+
+//! Names of the entry points, indexed by probe.
+
+const char * const probe_names[num_probes] = {
+    "compound_factor", "discount_factor", "pv", "fv", "pv_perpetuity",
+    "pv_annuity", "pv_stream", "price_and_risk", "sinking_fund_payment",
+    "loan_repayment", "bond_value", "schedule_build"
+};
+
+//! Counters for one entry point, updated by one thread.
+
+struct AtomicStats {
+    std::atomic<uint64_t> calls;        /*!< the number of calls */
+    std::atomic<uint64_t> cashflows;    /*!< the cash flows processed */
+    std::atomic<uint64_t> nanoseconds;  /*!< the time spent */
+};
+
+struct ThreadCounters;
+
+//! Registry of the threads' counters.
+
+struct Registry {
+    Registry() : mutex(), threads(), retired(), next_number(1), hook(0) {}
+
+    std::mutex mutex;                       /*!< guards the other members,
+                                                 except the hook */
+    std::vector<ThreadCounters *> threads;  /*!< the running threads */
+    ThreadStats retired;                    /*!< exited threads' totals */
+    uint64_t next_number;                   /*!< the next thread number */
+    std::atomic<TraceHook> hook;            /*!< the tracing hook */
+};
+
+//! Returns the registry.
+
+Registry& registry() {
+    static Registry the_registry;
+    return the_registry;
+}
+
+//! One thread's counters, which register and unregister themselves.
+
+struct ThreadCounters {
+    ThreadCounters() : number(0), probes() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        number = reg.next_number++;
+        reg.threads.push_back(this);
+    }
+
+    ~ThreadCounters() {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for ( std::size_t p = 0; p < num_probes; ++p ) {
+            ProbeStats& total = reg.retired.probes[p];
+            total.calls += probes[p].calls.load(std::memory_order_relaxed);
+            total.cashflows +=
+                probes[p].cashflows.load(std::memory_order_relaxed);
+            total.nanoseconds +=
+                probes[p].nanoseconds.load(std::memory_order_relaxed);
+        }
+        reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(),
+                                    this));
+    }
+
+    uint64_t number;                    /*!< the thread's number */
+    AtomicStats probes[num_probes];     /*!< the counters */
+
+    private:
+        ThreadCounters(const ThreadCounters&);
+        ThreadCounters& operator=(const ThreadCounters&);
+};
+
+//! Returns the calling thread's counters.
+
+ThreadCounters& local_counters() {
+    static thread_local ThreadCounters counters;
+    return counters;
+}
+
+//! Copies a thread's counters.
+
+ThreadStats snapshot(const ThreadCounters& counters) {
+    ThreadStats stats;
+    stats.thread_number = counters.number;
+    for ( std::size_t p = 0; p < num_probes; ++p ) {
+        const AtomicStats& source = counters.probes[p];
+        stats.probes[p].calls = source.calls.load(std::memory_order_relaxed);
+        stats.probes[p].cashflows =
+            source.cashflows.load(std::memory_order_relaxed);
+        stats.probes[p].nanoseconds =
+            source.nanoseconds.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+}           //  namespace
+
+bool financial::instrumentation_enabled() {
+#ifdef PG_FINANCIAL_INSTRUMENT
+    return true;
+#else
+    return false;
+#endif
+}
+
+const char * financial::probe_name(const probe entry_point) {
+    const std::size_t index = static_cast<std::size_t>(entry_point);
+    assert(index < num_probes);
+    return probe_names[index];
+}
+
+std::vector<ThreadStats> financial::thread_stats() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    std::vector<ThreadStats> stats;
+    for ( std::size_t t = 0; t < reg.threads.size(); ++t ) {
+        stats.push_back(snapshot(*reg.threads[t]));
+    }
+    std::sort(stats.begin(), stats.end(),
+              [](const ThreadStats& a, const ThreadStats& b) {
+                  return a.thread_number < b.thread_number;
+              });
+    stats.push_back(reg.retired);
+    return stats;
+}
+
+ProbeStats financial::total_stats(const probe entry_point) {
+    const std::size_t index = static_cast<std::size_t>(entry_point);
+    const std::vector<ThreadStats> stats = thread_stats();
+    ProbeStats total;
+    for ( std::size_t t = 0; t < stats.size(); ++t ) {
+        total.calls += stats[t].probes[index].calls;
+        total.cashflows += stats[t].probes[index].cashflows;
+        total.nanoseconds += stats[t].probes[index].nanoseconds;
+    }
+    return total;
+}
+
+void financial::reset_stats() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for ( std::size_t t = 0; t < reg.threads.size(); ++t ) {
+        for ( std::size_t p = 0; p < num_probes; ++p ) {
+            AtomicStats& counters = reg.threads[t]->probes[p];
+            counters.calls.store(0, std::memory_order_relaxed);
+            counters.cashflows.store(0, std::memory_order_relaxed);
+            counters.nanoseconds.store(0, std::memory_order_relaxed);
+        }
+    }
+    reg.retired = ThreadStats();
+}
+
+void financial::write_stats(std::ostream& out) {
+    const std::vector<ThreadStats> stats = thread_stats();
+    for ( std::size_t t = 0; t < stats.size(); ++t ) {
+        for ( std::size_t p = 0; p < num_probes; ++p ) {
+            const ProbeStats& probe_stats = stats[t].probes[p];
+            if ( probe_stats.calls == 0 ) {
+                continue;
+            }
+            const char * const fields[] = {"calls", "cashflows",
+                                           "nanoseconds"};
+            const uint64_t values[] = {probe_stats.calls,
+                                       probe_stats.cashflows,
+                                       probe_stats.nanoseconds};
+            for ( int f = 0; f < 3; ++f ) {
+                out << "financial_probe_" << fields[f]
+                    << "{probe=\"" << probe_names[p]
+                    << "\",thread=\"" << stats[t].thread_number << "\"} "
+                    << values[f] << '\n';
+            }
+        }
+    }
+}
+
+void financial::set_trace_hook(const TraceHook hook) {
+    registry().hook.store(hook);
+}
+
+void detail::record_probe(const probe entry_point, const uint64_t cashflows,
+                          const uint64_t nanoseconds) {
+    AtomicStats& counters =
+        local_counters().probes[static_cast<std::size_t>(entry_point)];
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.cashflows.fetch_add(cashflows, std::memory_order_relaxed);
+    counters.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+
+    const TraceHook hook = registry().hook.load(std::memory_order_acquire);
+    if ( hook ) {
+        hook(entry_point, cashflows, nanoseconds);
+    }
+}
@@ -0,0 +1,275 @@
+/*!
+ * \file        instrumentation.h
+ * \brief       Hot path instrumentation interface.
+ * \details     Optional per-thread counters of calls, cash flows and time
+ * spent in the library's entry points, with a tracing hook, compiled in
+ * only when the library is built with `PG_FINANCIAL_INSTRUMENT` defined.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_INSTRUMENTATION_H
+#define PG_FINANCIAL_INSTRUMENTATION_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include <stdint.h>
+
+#ifdef PG_FINANCIAL_INSTRUMENT
+#include <chrono>
+#endif
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Enumeration class for instrumented entry points
+
+/*!
+ * Each call to an entry point records one call. An entry point which
+ * calls another, as `SimpleBond::value()` calls `discount_factor()`,
+ * records both calls, and the time of the inner call is included in
+ * that of the outer.
+ */
+
+enum class probe {
+    compound_factor,        /*!< compound_factor() */
+    discount_factor,        /*!< discount_factor() */
+    pv,                     /*!< pv() */
+    fv,                     /*!< fv() */
+    pv_perpetuity,          /*!< pv_perpetuity() */
+    pv_annuity,             /*!< pv_annuity() */
+    pv_stream,              /*!< pv_stream() and pv_stream_at() */
+    price_and_risk,         /*!< price_and_risk() */
+    sinking_fund_payment,   /*!< sinking_fund_payment() */
+    loan_repayment,         /*!< loan_repayment() */
+    bond_value,             /*!< SimpleBond::value() and dirty_price() */
+    schedule_build          /*!< building a bond's cash flow schedule */
+};
+
+
+//! Number of instrumented entry points.
+
+const std::size_t num_probes = 12;
+
+
+//! Counters for one instrumented entry point.
+
+struct ProbeStats {
+
+    //! Default constructor
+
+    ProbeStats() : calls(0), cashflows(0), nanoseconds(0) {}
+
+    uint64_t calls;         /*!< the number of calls */
+    uint64_t cashflows;     /*!< the number of cash flows processed */
+    uint64_t nanoseconds;   /*!< the time spent in the calls */
+};
+
+
+//! Counters for one thread.
+
+struct ThreadStats {
+
+    //! Default constructor
+
+    ThreadStats() : thread_number(0), probes() {}
+
+    uint64_t thread_number;             /*!< the thread's number, or zero
+                                             for exited threads */
+    ProbeStats probes[num_probes];      /*!< the counters, indexed by
+                                             probe */
+};
+
+
+//! Tracing hook function type.
+
+/*!
+ * A hook is called on the thread which made the call, as each call to
+ * an instrumented entry point returns, with the entry point, the number
+ * of cash flows processed, and the time taken in nanoseconds. It must
+ * be thread safe, and should be fast.
+ */
+
+typedef void (*TraceHook)(const probe entry_point,
+                          const uint64_t cashflows,
+                          const uint64_t nanoseconds);
+
+
+//! Returns true if the instrumentation was compiled into the library.
+
+/*!
+ * The instrumentation is compiled in by building the library with
+ * `PG_FINANCIAL_INSTRUMENT` defined, as `make INSTRUMENT=1` does. When
+ * it is not, the probes compile to nothing, so cost nothing, no
+ * counters are recorded and the hook is never called.
+ */
+
+bool instrumentation_enabled();
+
+
+//! Returns the name of an instrumented entry point.
+
+const char * probe_name(const probe entry_point);
+
+
+//! Returns the counters of every thread.
+
+/*!
+ * Each thread which has called an instrumented entry point has its own
+ * counters, which only it updates, so counting does not contend
+ * between threads. Threads are numbered from one in the order of their
+ * first call. The counters of threads which have exited are added
+ * together into a final entry numbered zero. The counters are read
+ * while other threads may be updating them, so a snapshot taken while
+ * calls are in progress need not be consistent between counters.
+ *
+ * \return the counters of each thread.
+ */
+
+std::vector<ThreadStats> thread_stats();
+
+
+//! Returns the counters for an entry point, summed over every thread.
+
+ProbeStats total_stats(const probe entry_point);
+
+
+//! Sets every counter of every thread to zero.
+
+void reset_stats();
+
+
+//! Writes every thread's counters in a text exposition format.
+
+/*!
+ * Writes one line for each counter of each thread and entry point with
+ * any calls, such as
+ * `financial_probe_calls{probe="pv_stream",thread="1"} 1024`, in the
+ * text format read by Prometheus and similar monitoring systems.
+ *
+ * \param out the stream to write to.
+ */
+
+void write_stats(std::ostream& out);
+
+
+//! Sets the tracing hook.
+
+/*!
+ * \param hook the function to call as each instrumented call returns,
+ * or null for none.
+ */
+
+void set_trace_hook(const TraceHook hook);
+
+
+//! Library implementation details namespace
+
+namespace detail {
+
+//! Adds one call to the calling thread's counters, and calls the hook.
+
+void record_probe(const probe entry_point, const uint64_t cashflows,
+                  const uint64_t nanoseconds);
+
+#ifdef PG_FINANCIAL_INSTRUMENT
+
+//! Probe which counts and times the scope it is declared in.
+
+class ScopedProbe {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param entry_point the instrumented entry point.
+         * \param cashflows the number of cash flows the call processes.
+         */
+
+        ScopedProbe(const probe entry_point, const std::size_t cashflows) :
+            m_entry_point(entry_point), m_cashflows(cashflows),
+            m_start(std::chrono::steady_clock::now()) {}
+
+
+        //! Adds to the number of cash flows the call processes.
+
+        /*!
+         * For calls which only learn how many cash flows they process as
+         * they go, such as those reading from input iterators.
+         *
+         * \param cashflows the number of cash flows to add.
+         */
+
+        void add_cashflows(const std::size_t cashflows) {
+            m_cashflows += cashflows;
+        }
+
+
+        //! Destructor, which records the call.
+
+        ~ScopedProbe() {
+            const std::chrono::steady_clock::duration elapsed =
+                std::chrono::steady_clock::now() - m_start;
+            record_probe(m_entry_point, m_cashflows,
+                         std::chrono::duration_cast<
+                             std::chrono::nanoseconds>(elapsed).count());
+        }
+
+
+    private:
+        ScopedProbe(const ScopedProbe&);
+        ScopedProbe& operator=(const ScopedProbe&);
+
+        probe m_entry_point;        /*!< the entry point */
+        uint64_t m_cashflows;       /*!< the cash flows processed */
+        std::chrono::steady_clock::time_point m_start;  /*!< start time */
+};
+
+#endif
+
+}               //  namespace detail
+
+}               //  namespace financial
+
+
+//! Counts and times the rest of the enclosing scope.
+
+/*!
+ * Expands to nothing, and does not evaluate its arguments, unless
+ * `PG_FINANCIAL_INSTRUMENT` is defined.
+ *
+ * \param entry_point the name of a `financial::probe` enumerator.
+ * \param cashflows the number of cash flows the call processes.
+ */
+
+#ifdef PG_FINANCIAL_INSTRUMENT
+#define PG_FINANCIAL_PROBE(entry_point, cashflows) \
+    financial::detail::ScopedProbe pg_financial_probe( \
+            financial::probe::entry_point, (cashflows))
+#else
+#define PG_FINANCIAL_PROBE(entry_point, cashflows) ((void) 0)
+#endif
+
+
+//! Adds cash flows to the probe declared by `PG_FINANCIAL_PROBE`.
+
+/*!
+ * Must be used in the scope of a `PG_FINANCIAL_PROBE`. Expands to
+ * nothing, and does not evaluate its argument, unless
+ * `PG_FINANCIAL_INSTRUMENT` is defined.
+ *
+ * \param cashflows the number of cash flows to add.
+ */
+
+#ifdef PG_FINANCIAL_INSTRUMENT
+#define PG_FINANCIAL_PROBE_CASHFLOWS(cashflows) \
+    pg_financial_probe.add_cashflows(cashflows)
+#else
+#define PG_FINANCIAL_PROBE_CASHFLOWS(cashflows) ((void) 0)
+#endif
+
+#endif          //  PG_FINANCIAL_INSTRUMENTATION_H
@@ -0,0 +1,300 @@
+/*!
+ * \file        instruments.cpp
+ * \brief       Coupon bond instrument family implementation.
+ * \details     Coupon bond instrument family implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "bond.h"
+#include "portfolio.h"
+#include "thread_pool.h"
+#include "yield_curve.h"
+#include "instruments.h"
+
+using namespace financial;
+
+const std::size_t InstrumentBook::chunk_size;
+
+namespace {
+
+//! Checks that a bond which pays coupons has a coupon frequency.
+
+void check_frequency(const int coupon_frequency) {
+    if ( coupon_frequency < 1 ) {
+        throw std::domain_error("coupon frequency must be positive");
+    }
+}
+
+//! Values bonds from the discount factor grid for their frequency.
+
+class GridPricer {
+    public:
+        explicit GridPricer(const std::vector<const double *>& grids) :
+            m_grids(grids) {}
+
+        template <class Bond>
+        double operator()(const Bond& bond) const {
+            const int frequency = bond.coupon_frequency();
+            return bond.value_on_grid(m_grids[frequency ? frequency : 1]);
+        }
+
+    private:
+        const std::vector<const double *>& m_grids;
+};
+
+//! Values fixed rate bonds in closed form at a flat rate.
+
+class FlatRatePricer {
+    public:
+        explicit FlatRatePricer(const double rate) : m_rate(rate) {}
+
+        double operator()(const FixedRateBond& bond) const {
+            return bond.value(m_rate);
+        }
+
+    private:
+        double m_rate;
+};
+
+//! Values a range of positions in bonds of one type.
+
+/*!
+ * Writes each position's value to `values`, by position index, and
+ * returns their total. `Bond` is the concrete type, so each call to
+ * `pricer` is resolved at compile time.
+ */
+
+template <class Bond, class Pricer>
+double value_positions(const std::vector<Bond>& bonds,
+                       const std::vector<double>& quantities,
+                       const std::vector<std::size_t>& positions,
+                       const std::size_t begin, const std::size_t end,
+                       const Pricer& pricer,
+                       std::vector<double>& values) {
+    const Bond * bond = bonds.data();
+    const double * quantity = quantities.data();
+    const std::size_t * index = positions.data();
+
+    double subtotal = 0;
+    for ( std::size_t i = begin; i < end; ++i ) {
+        const double pval = quantity[i] * pricer(bond[i]);
+        values[index[i]] = pval;
+        subtotal += pval;
+    }
+    return subtotal;
+}
+
+}           //  namespace
+
+FloatingRateNote::FloatingRateNote(const double notional,
+                                   const double spread,
+                                   const int coupon_frequency,
+                                   const int maturity) :
+    CouponBond<FloatingRateNote>(notional, coupon_frequency, maturity),
+    m_spread(spread) {
+    check_frequency(coupon_frequency);
+}
+
+StepUpBond::StepUpBond(const double notional,
+                       const std::vector<double>& coupons,
+                       const int coupon_frequency, const int maturity) :
+    CouponBond<StepUpBond>(notional, coupon_frequency, maturity),
+    m_coupons(coupons) {
+    check_frequency(coupon_frequency);
+    if ( coupons.empty() ) {
+        throw std::domain_error("step-up bond must have a coupon rate");
+    }
+}
+
+AmortizingBond::AmortizingBond(const double notional, const double coupon,
+                               const int coupon_frequency,
+                               const int maturity) :
+    CouponBond<AmortizingBond>(notional, coupon_frequency, maturity),
+    m_coupon(coupon) {
+    check_frequency(coupon_frequency);
+}
+
+std::size_t InstrumentBook::add(const FixedRateBond& bond,
+                                const double quantity) {
+    return add_to(m_fixed, bond, quantity);
+}
+
+std::size_t InstrumentBook::add(const SimpleBond& bond,
+                                const double quantity) {
+    return add_to(m_fixed, FixedRateBond(bond), quantity);
+}
+
+std::size_t InstrumentBook::add(const FloatingRateNote& bond,
+                                const double quantity) {
+    return add_to(m_floating, bond, quantity);
+}
+
+std::size_t InstrumentBook::add(const StepUpBond& bond,
+                                const double quantity) {
+    return add_to(m_step_up, bond, quantity);
+}
+
+std::size_t InstrumentBook::add(const AmortizingBond& bond,
+                                const double quantity) {
+    return add_to(m_amortizing, bond, quantity);
+}
+
+PortfolioValuation InstrumentBook::value(const double discount_rate) const {
+    const double lg = std::log1p(discount_rate);
+    return run_valuation([lg](const double t) { return std::exp(-t * lg); },
+                         &discount_rate, 0);
+}
+
+PortfolioValuation InstrumentBook::value(const double discount_rate,
+                                         ThreadPool& pool) const {
+    const double lg = std::log1p(discount_rate);
+    return run_valuation([lg](const double t) { return std::exp(-t * lg); },
+                         &discount_rate, &pool);
+}
+
+PortfolioValuation InstrumentBook::value(const YieldCurve& curve) const {
+    return run_valuation([&curve](const double t) {
+                             return curve.discount_factor(t);
+                         }, 0, 0);
+}
+
+PortfolioValuation InstrumentBook::value(const YieldCurve& curve,
+                                         ThreadPool& pool) const {
+    return run_valuation([&curve](const double t) {
+                             return curve.discount_factor(t);
+                         }, 0, &pool);
+}
+
+template <class Bond>
+std::size_t InstrumentBook::add_to(Bucket<Bond>& bucket, const Bond& bond,
+                                   const double quantity) {
+
+    //  Every bond is checked on construction, but an empty grid would
+    //  be read out of bounds, so check again before sizing it.
+
+    detail::check_bond_terms(bond.coupon_frequency(), bond.maturity());
+    bucket.bonds.push_back(bond);
+    bucket.quantities.push_back(quantity);
+
+    //  Zero coupon bonds are valued from the grid for a frequency of
+    //  one, at the discount factor for their maturity.
+
+    const int frequency = std::max(bond.coupon_frequency(), 1);
+    if ( m_grid_sizes.size() <= static_cast<std::size_t>(frequency) ) {
+        m_grid_sizes.resize(frequency + 1, 0);
+    }
+    m_grid_sizes[frequency] = std::max(m_grid_sizes[frequency],
+                                       bond.maturity() * frequency);
+    bucket.positions.push_back(m_num_positions);
+    return m_num_positions++;
+}
+
+std::vector<InstrumentBook::Chunk> InstrumentBook::make_chunks() const {
+    const bond_type types[] = {bond_type::fixed, bond_type::floating,
+                               bond_type::step_up, bond_type::amortizing};
+    const std::size_t sizes[] = {m_fixed.bonds.size(),
+                                 m_floating.bonds.size(),
+                                 m_step_up.bonds.size(),
+                                 m_amortizing.bonds.size()};
+
+    std::vector<Chunk> chunks;
+    for ( int t = 0; t < 4; ++t ) {
+        for ( std::size_t b = 0; b < sizes[t]; b += chunk_size ) {
+            Chunk chunk;
+            chunk.type = types[t];
+            chunk.begin = b;
+            chunk.end = ( sizes[t] - b < chunk_size ) ? sizes[t] :
+                                                        b + chunk_size;
+            chunks.push_back(chunk);
+        }
+    }
+    return chunks;
+}
+
+template <class DiscountFactor>
+PortfolioValuation InstrumentBook::run_valuation(
+        const DiscountFactor& discount_factor,
+        const double * flat_rate, ThreadPool * pool) const {
+
+    //  Each grid point's time is calculated as `CouponBond` calculates
+    //  it, so the discount factors are identical to the bonds' own.
+
+    std::vector<std::vector<double> > grids(m_grid_sizes.size());
+    std::vector<const double *> grid_data(m_grid_sizes.size(), 0);
+    for ( std::size_t f = 1; f < m_grid_sizes.size(); ++f ) {
+        const int frequency = static_cast<int>(f);
+        grids[f].resize(m_grid_sizes[f]);
+        for ( int k = 1; k <= m_grid_sizes[f]; ++k ) {
+            const double t = static_cast<double>(k) / frequency;
+            grids[f][k - 1] = discount_factor(t);
+        }
+        grid_data[f] = grids[f].data();
+    }
+
+    const std::vector<Chunk> chunks = make_chunks();
+    std::vector<double> subtotals(chunks.size());
+
+    PortfolioValuation valuation;
+    valuation.positions.resize(m_num_positions);
+
+    for_each_chunk(pool, chunks.size(), [&](std::size_t i) {
+        subtotals[i] = value_chunk(chunks[i], grid_data, flat_rate,
+                                   valuation.positions);
+    });
+
+    for ( std::size_t i = 0; i < subtotals.size(); ++i ) {
+        valuation.total += subtotals[i];
+    }
+    return valuation;
+}
+
+double InstrumentBook::value_chunk(const Chunk& chunk,
+                                   const std::vector<const double *>& grids,
+                                   const double * flat_rate,
+                                   std::vector<double>& positions) const {
+
+    //  The type is switched on once for each chunk, and each bucket's
+    //  loop is compiled for its own type of bond.
+
+    const GridPricer grid_pricer(grids);
+    switch ( chunk.type ) {
+        case bond_type::fixed:
+            if ( flat_rate ) {
+                return value_positions(m_fixed.bonds, m_fixed.quantities,
+                                       m_fixed.positions, chunk.begin,
+                                       chunk.end, FlatRatePricer(*flat_rate),
+                                       positions);
+            }
+            return value_positions(m_fixed.bonds, m_fixed.quantities,
+                                   m_fixed.positions, chunk.begin,
+                                   chunk.end, grid_pricer, positions);
+
+        case bond_type::floating:
+            return value_positions(m_floating.bonds, m_floating.quantities,
+                                   m_floating.positions, chunk.begin,
+                                   chunk.end, grid_pricer, positions);
+
+        case bond_type::step_up:
+            return value_positions(m_step_up.bonds, m_step_up.quantities,
+                                   m_step_up.positions, chunk.begin,
+                                   chunk.end, grid_pricer, positions);
+
+        case bond_type::amortizing:
+            return value_positions(m_amortizing.bonds,
+                                   m_amortizing.quantities,
+                                   m_amortizing.positions, chunk.begin,
+                                   chunk.end, grid_pricer, positions);
+
+        default:
+            assert(false);
+            return 0;
+    }
+}
@@ -0,0 +1,783 @@
+/*!
+ * \file        instruments.h
+ * \brief       Coupon bond instrument family interface.
+ * \details     Fixed rate, floating rate, step-up and amortizing bonds
+ * sharing a statically dispatched valuation, and a book which prices
+ * them in batches grouped by type.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_INSTRUMENTS_H
+#define PG_FINANCIAL_INSTRUMENTS_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include "bond.h"
+#include "cashflow_schedule.h"
+#include "portfolio.h"
+#include "thread_pool.h"
+#include "yield_curve.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Coupon bond class template.
+
+/*!
+ * Base of a family of bonds, issued at time zero with a maturity of a
+ * whole number of periods, whose cash flows differ only in their coupon
+ * rates and in how their notional is repaid. Each concrete bond derives
+ * from `CouponBond<Derived>`, and provides two functions, which the
+ * template calls directly rather than through a virtual function:
+ *
+ * - `double coupon_rate(const int payment, const double forward) const`
+ *   returns the periodic coupon rate for the coupon period ending with
+ *   payment number `payment`, counted from one, given the simple
+ *   periodic forward rate over that coupon period implied by the
+ *   discount factors.
+ * - `double outstanding(const int payment) const` returns the notional
+ *   outstanding over that coupon period, on which the coupon accrues.
+ *   The difference between the notional outstanding over one coupon
+ *   period and the next is repaid at the end of the first, and the
+ *   notional outstanding over the last coupon period is repaid at
+ *   maturity.
+ *
+ * A bond with a coupon frequency of zero is a zero coupon bond, which
+ * repays its notional at maturity and pays no coupons. A bond has no
+ * virtual functions, and is destroyed through the concrete type, so it
+ * can be stored and priced by value in a contiguous array of bonds of
+ * the same type.
+ */
+
+template <class Derived>
+class CouponBond {
+    public:
+
+        //! Returns the notional amount at issuance.
+
+        double notional() const { return m_notional; }
+
+
+        //! Returns the number of coupon payments each period.
+
+        int coupon_frequency() const { return m_coupon_frequency; }
+
+
+        //! Returns the number of periods to maturity.
+
+        int maturity() const { return m_maturity; }
+
+
+        //! Returns the number of payments over the bond's lifetime.
+
+        /*!
+         * \return the number of coupon dates, or 1 for a zero coupon
+         * bond.
+         */
+
+        int num_payments() const {
+            return m_coupon_frequency ? m_maturity * m_coupon_frequency : 1;
+        }
+
+
+        //! DCF valuation
+
+        /*!
+         * Values the bond in a single pass over its payment dates,
+         * without building a cash flow schedule. Forward rates for
+         * floating coupons are projected from the same discount rate.
+         *
+         * \param discount_rate the discount rate to use.
+         * \return the present value of the bond.
+         */
+
+        double value(const double discount_rate) const {
+            const double lg = std::log1p(discount_rate);
+            return discount([lg](const int, const double t) {
+                                return std::exp(-t * lg);
+                            },
+                            [](const double, const double) {});
+        }
+
+
+        //! DCF valuation against a yield curve
+
+        /*!
+         * As the flat rate overload, discounting each payment at the
+         * curve's discount factor for its date, and projecting forward
+         * rates from the curve.
+         *
+         * \param curve the yield curve to discount against.
+         * \return the present value of the bond.
+         */
+
+        double value(const YieldCurve& curve) const {
+            return discount([&curve](const int, const double t) {
+                                return curve.discount_factor(t);
+                            },
+                            [](const double, const double) {});
+        }
+
+
+        //! DCF valuation from a grid of discount factors
+
+        /*!
+         * As the other overloads, taking the discount factor for each
+         * payment from an array. Valuing many bonds with the same
+         * coupon frequency against one grid calculates each discount
+         * factor once, rather than once for each bond. The result is
+         * identical to that of the flat rate or yield curve overload
+         * whose discount factors fill the grid.
+         *
+         * \param discount_factors an array holding, at index `k - 1`,
+         * the discount factor at time `k / coupon_frequency()` for each
+         * payment `k`, or for a zero coupon bond, the discount factor
+         * at time `k` for each whole period `k` up to the maturity.
+         * \return the present value of the bond.
+         */
+
+        double value_on_grid(const double * discount_factors) const {
+            return discount([discount_factors](const int k, const double) {
+                                return discount_factors[k - 1];
+                            },
+                            [](const double, const double) {});
+        }
+
+
+        //! Builds the bond's cash flow schedule.
+
+        /*!
+         * Floating coupons are projected at the discount rate, so
+         * `pv_stream(bond.schedule(rate), rate)` is equal to
+         * `bond.value(rate)`, to within rounding.
+         *
+         * \param discount_rate the rate from which to project forward
+         * rates.
+         * \return the bond's cash flow schedule.
+         */
+
+        CashFlowSchedule schedule(const double discount_rate) const {
+            const double lg = std::log1p(discount_rate);
+            CashFlowSchedule sched;
+            sched.reserve(num_payments());
+            discount([lg](const int, const double t) {
+                         return std::exp(-t * lg);
+                     },
+                     [&sched](const double amount, const double t) {
+                         sched.add(amount, t);
+                     });
+            return sched;
+        }
+
+
+        //! Builds the bond's cash flow schedule against a yield curve.
+
+        /*!
+         * \param curve the yield curve from which to project forward
+         * rates.
+         * \return the bond's cash flow schedule.
+         */
+
+        CashFlowSchedule schedule(const YieldCurve& curve) const {
+            CashFlowSchedule sched;
+            sched.reserve(num_payments());
+            discount([&curve](const int, const double t) {
+                         return curve.discount_factor(t);
+                     },
+                     [&sched](const double amount, const double t) {
+                         sched.add(amount, t);
+                     });
+            return sched;
+        }
+
+
+    protected:
+
+        //! Constructor
+
+        /*!
+         * \param notional the notional amount at issuance.
+         * \param coupon_frequency the number of coupon payments each
+         * period, or zero for a zero coupon bond.
+         * \param maturity the number of periods to maturity.
+         * \throws std::domain_error if `coupon_frequency` is negative,
+         * or `maturity` is less than one.
+         */
+
+        CouponBond(const double notional, const int coupon_frequency,
+                   const int maturity) :
+            m_notional(notional),
+            m_coupon_frequency(coupon_frequency),
+            m_maturity(maturity) {
+            detail::check_bond_terms(coupon_frequency, maturity);
+        }
+
+
+        //! Destructor
+
+        ~CouponBond() {}
+
+
+    private:
+        double m_notional;      /*!< notional amount at issuance */
+        int m_coupon_frequency; /*!< coupon payments per period */
+        int m_maturity;         /*!< periods to maturity */
+
+
+        //! Discounts the bond's payments.
+
+        /*!
+         * \param discount_factor a function returning the discount
+         * factor for a payment's index on the grid and its time.
+         * \param visit a function called with the amount and time of
+         * each payment, in order.
+         * \return the present value of the payments.
+         */
+
+        template <class DiscountFactor, class Visitor>
+        double discount(const DiscountFactor& discount_factor,
+                        const Visitor& visit) const {
+            const Derived& bond = static_cast<const Derived&>(*this);
+            if ( !m_coupon_frequency ) {
+                const double repayment = bond.outstanding(1);
+                visit(repayment, m_maturity);
+                return repayment * discount_factor(m_maturity, m_maturity);
+            }
+
+            const int periods = num_payments();
+            double df_start = 1;
+            double outstanding = bond.outstanding(1);
+            double pv_total = 0;
+            for ( int cp = 1; cp <= periods; ++cp ) {
+                const double t = static_cast<double>(cp) /
+                                 m_coupon_frequency;
+                const double df = discount_factor(cp, t);
+                const double forward = (df_start / df - 1) *
+                                       m_coupon_frequency;
+                const double next = ( cp < periods ) ?
+                                    bond.outstanding(cp + 1) : 0;
+                const double amount = outstanding *
+                                      bond.coupon_rate(cp, forward) /
+                                      m_coupon_frequency +
+                                      (outstanding - next);
+                visit(amount, t);
+                pv_total += amount * df;
+                df_start = df;
+                outstanding = next;
+            }
+            return pv_total;
+        }
+};
+
+
+//! Fixed rate bond class.
+
+/*!
+ * A bond paying a level coupon on its whole notional, with the notional
+ * repaid at maturity, on the same terms as a `SimpleBond`. The bond is
+ * valued in closed form, exactly as by `SimpleBond::value()`.
+ */
+
+class FixedRateBond : public CouponBond<FixedRateBond> {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param notional the notional amount.
+         * \param coupon the periodic coupon rate.
+         * \param coupon_frequency the number of coupon payments each
+         * period, or zero for a zero coupon bond.
+         * \param maturity the number of periods to maturity.
+         * \throws std::domain_error if `coupon_frequency` is negative,
+         * or `maturity` is less than one.
+         */
+
+        FixedRateBond(const double notional, const double coupon,
+                      const int coupon_frequency, const int maturity) :
+            CouponBond<FixedRateBond>(notional, coupon_frequency, maturity),
+            m_coupon(coupon) {}
+
+
+        //! Creates a fixed rate bond on the terms of a `SimpleBond`.
+
+        /*!
+         * \param bond the bond whose terms to copy.
+         * \throws std::domain_error if the bond's coupon frequency is
+         * negative, or its maturity is less than one.
+         */
+
+        explicit FixedRateBond(const SimpleBond& bond) :
+            CouponBond<FixedRateBond>(bond.principal(),
+                                      bond.coupon_frequency(),
+                                      bond.maturity()),
+            m_coupon(bond.coupon()) {}
+
+
+        //! Returns the periodic coupon rate.
+
+        double coupon() const { return m_coupon; }
+
+
+        //! Returns the coupon rate, whatever the forward rate.
+
+        double coupon_rate(const int, const double) const {
+            return m_coupon;
+        }
+
+
+        //! Returns the notional, which is outstanding until maturity.
+
+        double outstanding(const int) const { return notional(); }
+
+
+        //! DCF valuation
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \return the present value of the bond, as an annuity of
+         * coupons plus the discounted notional.
+         */
+
+        double value(const double discount_rate) const {
+            const BondFactors factors = bond_factors(discount_rate,
+                                                     coupon_frequency(),
+                                                     maturity());
+            return notional() * (m_coupon * factors.coupon_factor +
+                                 factors.principal_factor);
+        }
+
+
+        //! DCF valuation against a yield curve
+
+        /*!
+         * \param curve the yield curve to discount against.
+         * \return the present value of the bond.
+         */
+
+        double value(const YieldCurve& curve) const {
+            const BondFactors factors = bond_factors(curve,
+                                                     coupon_frequency(),
+                                                     maturity());
+            return notional() * (m_coupon * factors.coupon_factor +
+                                 factors.principal_factor);
+        }
+
+
+        //! DCF valuation from a grid of discount factors
+
+        /*!
+         * Adds the discount factors in the same order as
+         * `bond_factors()` does for a yield curve, so the result is
+         * identical to `value(curve)` when the grid is filled from
+         * `curve`.
+         *
+         * \param discount_factors the grid, as for
+         * `CouponBond::value_on_grid()`.
+         * \return the present value of the bond.
+         */
+
+        double value_on_grid(const double * discount_factors) const {
+            const int frequency = coupon_frequency();
+            const int periods = maturity() * (frequency ? frequency : 1);
+            const double principal_factor = discount_factors[periods - 1];
+            double annuity = 0;
+            if ( frequency ) {
+                for ( int cp = 1; cp < periods; ++cp ) {
+                    annuity += discount_factors[cp - 1];
+                }
+                annuity += principal_factor;
+                annuity /= frequency;
+            }
+            return notional() * (m_coupon * annuity + principal_factor);
+        }
+
+
+    private:
+        double m_coupon;        /*!< periodic coupon rate */
+};
+
+
+//! Floating rate note class.
+
+/*!
+ * A bond paying a coupon of the forward rate over each coupon period,
+ * plus a fixed spread, on its whole notional. Forward rates are
+ * projected from the curve, or the flat rate, at which the note is
+ * valued, so a note with no spread is valued at par.
+ */
+
+class FloatingRateNote : public CouponBond<FloatingRateNote> {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param notional the notional amount.
+         * \param spread the periodic spread over the forward rate.
+         * \param coupon_frequency the number of coupon payments each
+         * period.
+         * \param maturity the number of periods to maturity.
+         * \throws std::domain_error if `coupon_frequency` is not
+         * positive, or `maturity` is less than one.
+         */
+
+        FloatingRateNote(const double notional, const double spread,
+                         const int coupon_frequency, const int maturity);
+
+
+        //! Returns the periodic spread over the forward rate.
+
+        double spread() const { return m_spread; }
+
+
+        //! Returns the forward rate plus the spread.
+
+        double coupon_rate(const int, const double forward) const {
+            return forward + m_spread;
+        }
+
+
+        //! Returns the notional, which is outstanding until maturity.
+
+        double outstanding(const int) const { return notional(); }
+
+
+    private:
+        double m_spread;        /*!< periodic spread */
+};
+
+
+//! Step-up bond class.
+
+/*!
+ * A bond paying a fixed coupon on its whole notional, whose rate
+ * changes from one period to the next according to a schedule of
+ * rates, with the notional repaid at maturity.
+ */
+
+class StepUpBond : public CouponBond<StepUpBond> {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param notional the notional amount.
+         * \param coupons the periodic coupon rate in each period, from
+         * the first. The last rate applies to any later periods.
+         * \param coupon_frequency the number of coupon payments each
+         * period.
+         * \param maturity the number of periods to maturity.
+         * \throws std::domain_error if `coupons` is empty,
+         * `coupon_frequency` is not positive, or `maturity` is less
+         * than one.
+         */
+
+        StepUpBond(const double notional,
+                   const std::vector<double>& coupons,
+                   const int coupon_frequency, const int maturity);
+
+
+        //! Returns the coupon rate in each period.
+
+        const std::vector<double>& coupons() const { return m_coupons; }
+
+
+        //! Returns the coupon rate for the period containing a payment.
+
+        double coupon_rate(const int payment, const double) const {
+            const std::size_t period = static_cast<std::size_t>(
+                    (payment - 1) / coupon_frequency());
+            return period < m_coupons.size() ? m_coupons[period] :
+                                               m_coupons.back();
+        }
+
+
+        //! Returns the notional, which is outstanding until maturity.
+
+        double outstanding(const int) const { return notional(); }
+
+
+    private:
+        std::vector<double> m_coupons;  /*!< coupon rate by period */
+};
+
+
+//! Amortizing bond class.
+
+/*!
+ * A bond paying a level coupon on its outstanding notional, which is
+ * repaid in equal instalments on each coupon date.
+ */
+
+class AmortizingBond : public CouponBond<AmortizingBond> {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param notional the notional amount at issuance.
+         * \param coupon the periodic coupon rate.
+         * \param coupon_frequency the number of coupon payments each
+         * period.
+         * \param maturity the number of periods to maturity.
+         * \throws std::domain_error if `coupon_frequency` is not
+         * positive, or `maturity` is less than one.
+         */
+
+        AmortizingBond(const double notional, const double coupon,
+                       const int coupon_frequency, const int maturity);
+
+
+        //! Returns the periodic coupon rate.
+
+        double coupon() const { return m_coupon; }
+
+
+        //! Returns the coupon rate, whatever the forward rate.
+
+        double coupon_rate(const int, const double) const {
+            return m_coupon;
+        }
+
+
+        //! Returns the notional outstanding before a payment.
+
+        double outstanding(const int payment) const {
+            return notional() * (num_payments() - payment + 1) /
+                   num_payments();
+        }
+
+
+    private:
+        double m_coupon;        /*!< periodic coupon rate */
+};
+
+
+//! Book of coupon bonds of several types.
+
+/*!
+ * Holds positions in bonds of every type in the `CouponBond` family,
+ * with the bonds of each type stored by value in their own contiguous
+ * array. A valuation runs through each array in turn, so every bond is
+ * valued by a direct, inlined call for its concrete type, with no
+ * virtual call and no branch on the type of each bond. Each valuation
+ * first fills a grid of discount factors for each coupon frequency in
+ * the book, from which the bonds are valued with no further discount
+ * factor calculations, except that fixed rate bonds at a flat rate are
+ * valued in closed form. Each array is divided into chunks of
+ * `chunk_size` positions, which may be valued on a thread pool, and the
+ * chunk totals are added in a fixed order, so the results are identical
+ * with any number of threads.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::InstrumentBook book;
+ * book.add(financial::FixedRateBond(1000, 0.05, 2, 10), 250);
+ * book.add(financial::FloatingRateNote(1000, 0.002, 4, 5), 100);
+ * book.add(financial::AmortizingBond(1000, 0.04, 12, 15), 40);
+ *
+ * financial::ThreadPool pool;
+ * financial::PortfolioValuation val = book.value(curve, pool);
+ * ~~~~
+ */
+
+class InstrumentBook {
+    public:
+
+        //! Number of positions in each chunk of work.
+
+        static const std::size_t chunk_size = 4096;
+
+
+        //! Default constructor
+
+        /*!
+         * Creates an empty book.
+         */
+
+        InstrumentBook() : m_fixed(), m_floating(), m_step_up(),
+                           m_amortizing(), m_grid_sizes(),
+                           m_num_positions(0) {}
+
+
+        //! Adds a position in a fixed rate bond.
+
+        /*!
+         * \param bond the bond held.
+         * \param quantity the number of bonds held.
+         * \return the index of the position, which is its index in
+         * `PortfolioValuation::positions`.
+         */
+
+        std::size_t add(const FixedRateBond& bond,
+                        const double quantity = 1);
+
+
+        //! Adds a position in a simple bond, as a fixed rate bond.
+
+        /*!
+         * \param bond the bond held.
+         * \param quantity the number of bonds held.
+         * \return the index of the position.
+         * \throws std::domain_error if the bond's coupon frequency is
+         * negative, or its maturity is less than one.
+         */
+
+        std::size_t add(const SimpleBond& bond, const double quantity = 1);
+
+
+        //! Adds a position in a floating rate note.
+
+        std::size_t add(const FloatingRateNote& bond,
+                        const double quantity = 1);
+
+
+        //! Adds a position in a step-up bond.
+
+        std::size_t add(const StepUpBond& bond, const double quantity = 1);
+
+
+        //! Adds a position in an amortizing bond.
+
+        std::size_t add(const AmortizingBond& bond,
+                        const double quantity = 1);
+
+
+        //! Returns the number of positions in the book.
+
+        std::size_t size() const { return m_num_positions; }
+
+
+        //! Values the book on the calling thread.
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \return the present value of each position, and the total.
+         * Each position's value is exactly the quantity times the
+         * bond's `value(discount_rate)`.
+         */
+
+        PortfolioValuation value(const double discount_rate) const;
+
+
+        //! Values the book in parallel.
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \param pool the thread pool to run the valuation on.
+         * \return the present value of each position, and the total,
+         * identical to those returned by the single threaded overload.
+         */
+
+        PortfolioValuation value(const double discount_rate,
+                                 ThreadPool& pool) const;
+
+
+        //! Values the book against a yield curve on the calling thread.
+
+        /*!
+         * \param curve the yield curve to discount against.
+         * \return the present value of each position, and the total.
+         * Each position's value is exactly the quantity times the
+         * bond's `value(curve)`.
+         */
+
+        PortfolioValuation value(const YieldCurve& curve) const;
+
+
+        //! Values the book against a yield curve in parallel.
+
+        /*!
+         * \param curve the yield curve to discount against.
+         * \param pool the thread pool to run the valuation on.
+         * \return the present value of each position, and the total,
+         * identical to those returned by the single threaded overload.
+         */
+
+        PortfolioValuation value(const YieldCurve& curve,
+                                 ThreadPool& pool) const;
+
+
+    private:
+
+        //! Positions in bonds of a single type.
+
+        template <class Bond>
+        struct Bucket {
+            Bucket() : bonds(), quantities(), positions() {}
+            std::vector<Bond> bonds;            /*!< the bonds held */
+            std::vector<double> quantities;     /*!< quantities held */
+            std::vector<std::size_t> positions; /*!< position indices */
+        };
+
+        //! Enumeration class for the types of bond.
+
+        enum class bond_type {
+            fixed,
+            floating,
+            step_up,
+            amortizing
+        };
+
+        //! A chunk of positions within a bucket.
+
+        struct Chunk {
+            bond_type type;     /*!< the bucket */
+            std::size_t begin;  /*!< the first position in the bucket */
+            std::size_t end;    /*!< one past the last position */
+        };
+
+        Bucket<FixedRateBond> m_fixed;          /*!< fixed rate bonds */
+        Bucket<FloatingRateNote> m_floating;    /*!< floating rate notes */
+        Bucket<StepUpBond> m_step_up;           /*!< step-up bonds */
+        Bucket<AmortizingBond> m_amortizing;    /*!< amortizing bonds */
+        std::vector<int> m_grid_sizes;          /*!< grid sizes, by
+                                                     coupon frequency */
+        std::size_t m_num_positions;            /*!< number of positions */
+
+
+        //! Adds a position to a bucket.
+
+        template <class Bond>
+        std::size_t add_to(Bucket<Bond>& bucket, const Bond& bond,
+                           const double quantity);
+
+
+        //! Divides the buckets into chunks.
+
+        std::vector<Chunk> make_chunks() const;
+
+
+        //! Values the book, on a thread pool if one is given.
+
+        /*!
+         * \param discount_factor a function returning the discount
+         * factor for a time, with which to fill the grids.
+         * \param flat_rate the flat discount rate, or a null pointer
+         * when valuing against a curve.
+         * \param pool the thread pool, or a null pointer.
+         */
+
+        template <class DiscountFactor>
+        PortfolioValuation run_valuation(
+                const DiscountFactor& discount_factor,
+                const double * flat_rate, ThreadPool * pool) const;
+
+
+        //! Values a chunk of positions, returning their total.
+
+        double value_chunk(const Chunk& chunk,
+                           const std::vector<const double *>& grids,
+                           const double * flat_rate,
+                           std::vector<double>& positions) const;
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_INSTRUMENTS_H
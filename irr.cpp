@@ -0,0 +1,266 @@
+/*!
+ * \file        irr.cpp
+ * \brief       Internal rate of return functions implementation.
+ * \details     Internal rate of return functions implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+#include "cashflow_schedule.h"
+#include "thread_pool.h"
+#include "irr.h"
+
+using namespace financial;
+
+namespace {
+
+//! Number of streams in each chunk of a batched solve.
+
+const std::size_t streams_per_chunk = 64;
+
+//! Maximum number of bracket expansions and Newton iterations.
+
+const int max_iterations = 100;
+
+//! Largest magnitude of `t * log(1 + r)` allowed, to avoid overflow.
+
+const double max_exponent = 700;
+
+//! Reads the cash flows of a CashFlowView.
+
+class ViewFlows {
+    public:
+        explicit ViewFlows(const CashFlowView& cashflows) :
+            m_amounts(cashflows.amounts()), m_times(cashflows.times()),
+            m_size(cashflows.size()) {}
+        std::size_t size() const { return m_size; }
+        double amount(const std::size_t i) const { return m_amounts[i]; }
+        double time(const std::size_t i) const { return m_times[i]; }
+
+    private:
+        const double * m_amounts;
+        const double * m_times;
+        std::size_t m_size;
+};
+
+//! Reads the cash flows of a std::vector of TimedCashFlow structs.
+
+class VectorFlows {
+    public:
+        explicit VectorFlows(const std::vector<TimedCashFlow>& cashflows) :
+            m_cashflows(cashflows) {}
+        std::size_t size() const { return m_cashflows.size(); }
+        double amount(const std::size_t i) const {
+            return m_cashflows[i].amount;
+        }
+        double time(const std::size_t i) const {
+            return m_cashflows[i].time_period;
+        }
+
+    private:
+        const std::vector<TimedCashFlow>& m_cashflows;
+};
+
+//! Present value of a stream, and its derivative, at `log(1 + r)`.
+
+struct NpvDerivative {
+    double npv;         /*!< the present value */
+    double first;       /*!< the derivative with respect to log(1 + r) */
+};
+
+//! Calculates the present value and its derivative in one pass.
+
+/*!
+ * Each time period is measured as `(time - origin) * scale`.
+ */
+
+template <class Flows>
+NpvDerivative npv_derivative(const Flows& flows, const double origin,
+                             const double scale, const double x) {
+    double s0 = 0;
+    double s1 = 0;
+    for ( std::size_t i = 0; i < flows.size(); ++i ) {
+        const double t = (flows.time(i) - origin) * scale;
+        const double dcf = flows.amount(i) * std::exp(-t * x);
+        s0 += dcf;
+        s1 += t * dcf;
+    }
+    NpvDerivative ret_value;
+    ret_value.npv = s0;
+    ret_value.first = -s1;
+    return ret_value;
+}
+
+//! Checks an initial guess, returning `log(1 + guess)`.
+
+double log_guess(const double guess) {
+    if ( !(guess > -1) ) {
+        throw std::domain_error("IRR guess must be greater than -1");
+    }
+    return std::log1p(guess);
+}
+
+//! Solves for the rate of a stream, returning NaN if there is none.
+
+/*!
+ * \param flows the cash flows.
+ * \param xirr true to measure times in years from the earliest day,
+ * false to measure them in periods.
+ * \param x0 `log(1 + guess)`.
+ */
+
+template <class Flows>
+double solve_rate(const Flows& flows, const bool xirr, const double x0) {
+    const double no_rate = std::numeric_limits<double>::quiet_NaN();
+
+    //  A rate exists only if the stream has both positive and negative
+    //  amounts, and the times span an interval.
+
+    bool positive = false;
+    bool negative = false;
+    double min_time = std::numeric_limits<double>::infinity();
+    double max_time = -min_time;
+    for ( std::size_t i = 0; i < flows.size(); ++i ) {
+        positive = positive || flows.amount(i) > 0;
+        negative = negative || flows.amount(i) < 0;
+        min_time = std::fmin(min_time, flows.time(i));
+        max_time = std::fmax(max_time, flows.time(i));
+    }
+    if ( !positive || !negative || !(max_time > min_time) ) {
+        return no_rate;
+    }
+
+    const double origin = xirr ? min_time : 0;
+    const double scale = xirr ? 1 / xirr_days_per_year : 1;
+    //  Discount factors overflow for negative rates at late times, and
+    //  for positive rates at times before the origin, so limit the
+    //  search to where they stay finite.
+
+    const double late = std::fmax(max_time - origin, 0) * scale;
+    const double early = std::fmax(origin - min_time, 0) * scale;
+    const double lo_limit = -max_exponent / std::fmax(late, 1);
+    const double hi_limit = max_exponent / std::fmax(early, 1);
+    const double x_start = std::fmin(std::fmax(x0, lo_limit), hi_limit);
+
+    //  Expand a bracket outward from the guess until the present value
+    //  changes sign, moving whichever end is closer to zero.
+
+    double lo = std::fmax(x_start - 0.1, lo_limit);
+    double hi = std::fmin(x_start + 0.1, hi_limit);
+    double f_lo = npv_derivative(flows, origin, scale, lo).npv;
+    double f_hi = npv_derivative(flows, origin, scale, hi).npv;
+    for ( int i = 0; (f_lo > 0) == (f_hi > 0); ++i ) {
+        if ( i == max_iterations || (lo == lo_limit && hi == hi_limit) ) {
+            return no_rate;
+        }
+        const double width = 1.6 * (hi - lo);
+        if ( hi == hi_limit ||
+             (lo > lo_limit && std::fabs(f_lo) < std::fabs(f_hi)) ) {
+            lo = std::fmax(lo - width, lo_limit);
+            f_lo = npv_derivative(flows, origin, scale, lo).npv;
+        } else {
+            hi = std::fmin(hi + width, hi_limit);
+            f_hi = npv_derivative(flows, origin, scale, hi).npv;
+        }
+    }
+
+    //  Newton's method, keeping every iterate inside the bracket.
+
+    const bool lo_positive = f_lo > 0;
+    double x = ( x0 > lo && x0 < hi ) ? x0 : (lo + hi) / 2;
+    for ( int i = 0; i < max_iterations; ++i ) {
+        const NpvDerivative nd = npv_derivative(flows, origin, scale, x);
+        if ( nd.npv == 0 ) {
+            break;
+        } else if ( (nd.npv > 0) == lo_positive ) {
+            lo = x;
+        } else {
+            hi = x;
+        }
+
+        double next = x - nd.npv / nd.first;
+        if ( !(next > lo && next < hi) ) {
+            next = (lo + hi) / 2;
+        }
+
+        const double step = next - x;
+        x = next;
+        if ( std::fabs(step) <= 4 * std::numeric_limits<double>::epsilon() *
+                                 (1 + std::fabs(x)) ) {
+            break;
+        }
+    }
+
+    return std::expm1(x);
+}
+
+//! Solves a single stream, throwing if there is no rate.
+
+template <class Flows>
+double solve_or_throw(const Flows& flows, const bool xirr,
+                      const double guess) {
+    const double rate = solve_rate(flows, xirr, log_guess(guess));
+    if ( std::isnan(rate) ) {
+        throw std::domain_error("Cash flows have no internal rate of return");
+    }
+    return rate;
+}
+
+//! Solves a batch of streams in chunks on a thread pool.
+
+std::vector<double> solve_batch(const std::vector<std::vector<
+                                TimedCashFlow> >& streams, ThreadPool& pool,
+                                const bool xirr, const double guess) {
+    const double x0 = log_guess(guess);
+    std::vector<double> rates(streams.size());
+    const std::size_t num_chunks = (streams.size() + streams_per_chunk - 1) /
+                                   streams_per_chunk;
+    pool.parallel_for(num_chunks, [&](const std::size_t chunk) {
+        const std::size_t begin = chunk * streams_per_chunk;
+        const std::size_t remaining = streams.size() - begin;
+        const std::size_t end = ( remaining < streams_per_chunk ) ?
+                                streams.size() : begin + streams_per_chunk;
+        for ( std::size_t i = begin; i < end; ++i ) {
+            rates[i] = solve_rate(VectorFlows(streams[i]), xirr, x0);
+        }
+    });
+    return rates;
+}
+
+}           //  namespace
+
+double financial::irr(const CashFlowView& cashflows, const double guess) {
+    return solve_or_throw(ViewFlows(cashflows), false, guess);
+}
+
+double financial::irr(const std::vector<TimedCashFlow>& cashflows,
+                      const double guess) {
+    return solve_or_throw(VectorFlows(cashflows), false, guess);
+}
+
+double financial::xirr(const CashFlowView& cashflows, const double guess) {
+    return solve_or_throw(ViewFlows(cashflows), true, guess);
+}
+
+double financial::xirr(const std::vector<TimedCashFlow>& cashflows,
+                       const double guess) {
+    return solve_or_throw(VectorFlows(cashflows), true, guess);
+}
+
+std::vector<double> financial::irr(const std::vector<std::vector<
+                                   TimedCashFlow> >& streams,
+                                   ThreadPool& pool, const double guess) {
+    return solve_batch(streams, pool, false, guess);
+}
+
+std::vector<double> financial::xirr(const std::vector<std::vector<
+                                    TimedCashFlow> >& streams,
+                                    ThreadPool& pool, const double guess) {
+    return solve_batch(streams, pool, true, guess);
+}
@@ -0,0 +1,157 @@
+/*!
+ * \file        irr.h
+ * \brief       Internal rate of return functions interface.
+ * \details     Functions for solving for the internal rate of return of
+ * streams of cash flows, singly or in parallel batches.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_IRR_H
+#define PG_FINANCIAL_IRR_H
+
+#include <vector>
+#include "common_financial_types.h"
+#include "cashflow_schedule.h"
+#include "thread_pool.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Number of days in a year for `xirr()`.
+
+const double xirr_days_per_year = 365;
+
+
+//! Calculates the internal rate of return of a stream of cash flows.
+
+/*!
+ * Finds the periodic interest rate `r` at which the present value of
+ * the cash flows, discounted discretely, is zero. The time period of
+ * each cash flow is measured in periods, as for `pv_stream()`.
+ *
+ * The rate is solved for in terms of `log(1 + r)`, in which each
+ * discount factor is a plain exponential. A bracket containing a sign
+ * change of the present value is first found by expanding outward from
+ * the guess, and Newton's method is then used, with any step which
+ * would leave the bracket replaced by a bisection step, so convergence
+ * is guaranteed. The present value and its derivative are calculated
+ * together in a single pass over the cash flows, and a typical solve
+ * requires four to six passes.
+ *
+ * Where the cash flows change sign more than once, there may be more
+ * than one rate, and the one found is the one closest to the guess
+ * within the first bracket found.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * std::vector<financial::TimedCashFlow> project;
+ * project.push_back(financial::TimedCashFlow(-1000, 0));
+ * project.push_back(financial::TimedCashFlow(300, 1));
+ * project.push_back(financial::TimedCashFlow(500, 2));
+ * project.push_back(financial::TimedCashFlow(400, 3));
+ * double rate = financial::irr(project);
+ * ~~~~
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param guess an initial estimate of the rate.
+ * \return the internal rate of return.
+ * \throws std::domain_error if `guess` is not greater than -1, or if no
+ * rate could be found, for instance because the cash flows do not
+ * include both positive and negative amounts.
+ */
+
+double irr(const CashFlowView& cashflows, const double guess = 0.1);
+
+
+//! Calculates the internal rate of return of a stream of cash flows.
+
+/*!
+ * As the `CashFlowView` overload, but reads the cash flows directly
+ * from a std::vector of TimedCashFlow structs.
+ *
+ * \param cashflows the cash flows.
+ * \param guess an initial estimate of the rate.
+ * \return the internal rate of return.
+ * \throws std::domain_error as for the `CashFlowView` overload.
+ */
+
+double irr(const std::vector<TimedCashFlow>& cashflows,
+           const double guess = 0.1);
+
+
+//! Calculates the annual internal rate of return of dated cash flows.
+
+/*!
+ * As `irr()`, but the time period of each cash flow is a day number,
+ * such as a serial date, and the rate returned is the effective annual
+ * rate `r` at which `sum(amount * (1 + r) ** -((day - first_day) /
+ * 365))` is zero, where `first_day` is the earliest day in the stream.
+ * This is the convention of the spreadsheet XIRR function.
+ *
+ * \param cashflows the cash flows, as a schedule or a view, with their
+ * time periods as day numbers.
+ * \param guess an initial estimate of the rate.
+ * \return the annual internal rate of return.
+ * \throws std::domain_error as for `irr()`.
+ */
+
+double xirr(const CashFlowView& cashflows, const double guess = 0.1);
+
+
+//! Calculates the annual internal rate of return of dated cash flows.
+
+/*!
+ * \param cashflows the cash flows, with their time periods as day
+ * numbers.
+ * \param guess an initial estimate of the rate.
+ * \return the annual internal rate of return.
+ * \throws std::domain_error as for `irr()`.
+ */
+
+double xirr(const std::vector<TimedCashFlow>& cashflows,
+            const double guess = 0.1);
+
+
+//! Calculates the internal rates of return of many streams in parallel.
+
+/*!
+ * Solves each stream independently, as `irr()`, sharing the streams
+ * among the threads of a `ThreadPool` in fixed-size chunks. A stream
+ * for which no rate can be found gives a quiet NaN, rather than
+ * throwing, so one bad stream does not lose the results of the others.
+ *
+ * \param streams the streams of cash flows.
+ * \param pool the thread pool to run the solves on.
+ * \param guess an initial estimate of each rate.
+ * \return the internal rate of return of each stream.
+ * \throws std::domain_error if `guess` is not greater than -1.
+ */
+
+std::vector<double> irr(const std::vector<std::vector<TimedCashFlow> >&
+                        streams, ThreadPool& pool, const double guess = 0.1);
+
+
+//! Calculates the annual rates of return of many streams in parallel.
+
+/*!
+ * As the batched `irr()`, solving each stream as `xirr()`.
+ *
+ * \param streams the streams of cash flows, with their time periods as
+ * day numbers.
+ * \param pool the thread pool to run the solves on.
+ * \param guess an initial estimate of each rate.
+ * \return the annual internal rate of return of each stream.
+ * \throws std::domain_error if `guess` is not greater than -1.
+ */
+
+std::vector<double> xirr(const std::vector<std::vector<TimedCashFlow> >&
+                         streams, ThreadPool& pool,
+                         const double guess = 0.1);
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_IRR_H
@@ -0,0 +1,138 @@
+/*!
+ * \file        philox.h
+ * \brief       Counter-based random number generator.
+ * \details     Header-only Philox4x32-10 counter-based random number
+ * generator, with conversions to uniform and normal deviates.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_PHILOX_H
+#define PG_FINANCIAL_PHILOX_H
+
+#include <cmath>
+#include <stdint.h>
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Philox4x32-10 counter-based random number generator.
+
+/*!
+ * Maps a 128-bit counter and a 64-bit key to 128 random bits, as
+ * described by Salmon et al., "Parallel Random Numbers: As Easy as 1,
+ * 2, 3" (SC11). There is no state beyond the key, so any block of a
+ * random stream can be generated directly from its counter. Giving each
+ * simulation path its own counters makes the results independent of
+ * the order in which the paths are run, and of the number of threads
+ * running them.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * const financial::Philox4x32 rng(seed);
+ * double normals[2];
+ * rng.normals(step, 0, path, 0, normals);
+ * ~~~~
+ */
+
+class Philox4x32 {
+    public:
+
+        //! Constructor
+
+        /*!
+         * \param seed the 64-bit key.
+         */
+
+        explicit Philox4x32(const uint64_t seed) :
+            m_key0(static_cast<uint32_t>(seed)),
+            m_key1(static_cast<uint32_t>(seed >> 32)) {}
+
+
+        //! Generates 128 random bits from a counter.
+
+        /*!
+         * \param c0 the first word of the counter.
+         * \param c1 the second word of the counter.
+         * \param c2 the third word of the counter.
+         * \param c3 the fourth word of the counter.
+         * \param out an array of four words to receive the random bits.
+         */
+
+        void operator()(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3,
+                        uint32_t * out) const {
+            uint32_t k0 = m_key0;
+            uint32_t k1 = m_key1;
+            for ( int round = 0; round < 10; ++round ) {
+                const uint64_t p0 = static_cast<uint64_t>(multiplier0) * c0;
+                const uint64_t p1 = static_cast<uint64_t>(multiplier1) * c2;
+                const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+                const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+                c0 = hi1 ^ c1 ^ k0;
+                c1 = static_cast<uint32_t>(p1);
+                c2 = hi0 ^ c3 ^ k1;
+                c3 = static_cast<uint32_t>(p0);
+                k0 += weyl0;
+                k1 += weyl1;
+            }
+            out[0] = c0;
+            out[1] = c1;
+            out[2] = c2;
+            out[3] = c3;
+        }
+
+
+        //! Generates two standard normal deviates from a counter.
+
+        /*!
+         * The 128 bits are converted to two uniform deviates in (0, 1)
+         * with 53 bits of precision, and then to two independent normal
+         * deviates by the Box-Muller transform.
+         *
+         * \param c0 the first word of the counter.
+         * \param c1 the second word of the counter.
+         * \param c2 the third word of the counter.
+         * \param c3 the fourth word of the counter.
+         * \param out an array of two doubles to receive the deviates.
+         */
+
+        void normals(const uint32_t c0, const uint32_t c1,
+                     const uint32_t c2, const uint32_t c3,
+                     double * out) const {
+            uint32_t bits[4];
+            (*this)(c0, c1, c2, c3, bits);
+            const double u1 = uniform(bits[0], bits[1]);
+            const double u2 = uniform(bits[2], bits[3]);
+            const double radius = std::sqrt(-2 * std::log(u1));
+            const double angle = 6.283185307179586476925 * u2;
+            out[0] = radius * std::cos(angle);
+            out[1] = radius * std::sin(angle);
+        }
+
+
+        //! Converts 64 random bits to a uniform deviate in (0, 1).
+
+        static double uniform(const uint32_t hi, const uint32_t lo) {
+            const uint64_t bits = (static_cast<uint64_t>(hi) << 21) ^
+                                  (lo >> 11);
+            return (static_cast<double>(bits & ((1ULL << 53) - 1)) + 0.5) /
+                   9007199254740992.0;
+        }
+
+
+    private:
+        static const uint32_t multiplier0 = 0xD2511F53;    /*!< round mul */
+        static const uint32_t multiplier1 = 0xCD9E8D57;    /*!< round mul */
+        static const uint32_t weyl0 = 0x9E3779B9;          /*!< key bump */
+        static const uint32_t weyl1 = 0xBB67AE85;          /*!< key bump */
+
+        uint32_t m_key0;        /*!< low word of the key */
+        uint32_t m_key1;        /*!< high word of the key */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_PHILOX_H
@@ -0,0 +1,184 @@
+/*!
+ * \file        portfolio.cpp
+ * \brief       Bond portfolio pricing engine implementation.
+ * \details     Bond portfolio pricing engine implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+#include "bond.h"
+#include "thread_pool.h"
+#include "portfolio.h"
+
+using namespace financial;
+
+const std::size_t Portfolio::chunk_size;
+
+std::size_t Portfolio::add(const SimpleBond& bond, const double quantity) {
+    const int frequency = bond.coupon_frequency();
+    const std::pair<int, int> key(frequency, bond.maturity());
+
+    std::map<std::pair<int, int>, std::size_t>::const_iterator itr =
+        m_group_index.find(key);
+    std::size_t group_index;
+    if ( itr == m_group_index.end() ) {
+        group_index = m_groups.size();
+        m_groups.push_back(Group(frequency, bond.maturity()));
+        m_group_index[key] = group_index;
+    } else {
+        group_index = itr->second;
+    }
+
+    Group& group = m_groups[group_index];
+    group.principals.push_back(bond.principal() * quantity);
+    group.coupons.push_back(bond.coupon());
+    group.positions.push_back(m_num_positions);
+    return m_num_positions++;
+}
+
+PortfolioValuation Portfolio::value(const double discount_rate) const {
+    return run_valuation(discount_rate, 0);
+}
+
+PortfolioValuation Portfolio::value(const double discount_rate,
+                                    ThreadPool& pool) const {
+    return run_valuation(discount_rate, &pool);
+}
+
+PortfolioValuation Portfolio::run_valuation(const double discount_rate,
+                                            ThreadPool * pool) const {
+    std::vector<BondFactors> factors;
+    factors.reserve(m_groups.size());
+    for ( std::size_t i = 0; i < m_groups.size(); ++i ) {
+        factors.push_back(bond_factors(discount_rate,
+                                       m_groups[i].coupon_frequency,
+                                       m_groups[i].maturity));
+    }
+
+    const std::vector<Chunk> chunks = make_chunks();
+    std::vector<double> subtotals(chunks.size());
+
+    PortfolioValuation valuation;
+    valuation.positions.resize(m_num_positions);
+
+    for_each_chunk(pool, chunks.size(), [&](std::size_t i) {
+        subtotals[i] = value_chunk(chunks[i], factors, valuation.positions);
+    });
+
+    for ( std::size_t i = 0; i < subtotals.size(); ++i ) {
+        valuation.total += subtotals[i];
+    }
+    return valuation;
+}
+
+PortfolioRisk Portfolio::price_and_risk(const double discount_rate) const {
+    return run_risk(discount_rate, 0);
+}
+
+PortfolioRisk Portfolio::price_and_risk(const double discount_rate,
+                                        ThreadPool& pool) const {
+    return run_risk(discount_rate, &pool);
+}
+
+PortfolioRisk Portfolio::run_risk(const double discount_rate,
+                                  ThreadPool * pool) const {
+    std::vector<BondRiskFactors> factors;
+    factors.reserve(m_groups.size());
+    for ( std::size_t i = 0; i < m_groups.size(); ++i ) {
+        factors.push_back(bond_risk_factors(discount_rate,
+                                            m_groups[i].coupon_frequency,
+                                            m_groups[i].maturity));
+    }
+
+    const std::vector<Chunk> chunks = make_chunks();
+    std::vector<PvDerivatives> subtotals(chunks.size());
+
+    PortfolioRisk risk;
+    risk.positions.resize(m_num_positions);
+
+    for_each_chunk(pool, chunks.size(), [&](std::size_t i) {
+        subtotals[i] = risk_chunk(chunks[i], factors, discount_rate,
+                                  risk.positions);
+    });
+
+    double pv_total = 0;
+    double first_total = 0;
+    double second_total = 0;
+    for ( std::size_t i = 0; i < subtotals.size(); ++i ) {
+        pv_total += subtotals[i].pv;
+        first_total += subtotals[i].first;
+        second_total += subtotals[i].second;
+    }
+    risk.total = RiskMeasures(pv_total, first_total, second_total,
+                              discount_rate);
+    return risk;
+}
+
+std::vector<Portfolio::Chunk> Portfolio::make_chunks() const {
+    std::vector<Chunk> chunks;
+    for ( std::size_t g = 0; g < m_groups.size(); ++g ) {
+        const std::size_t group_size = m_groups[g].positions.size();
+        for ( std::size_t b = 0; b < group_size; b += chunk_size ) {
+            Chunk chunk;
+            chunk.group = g;
+            chunk.begin = b;
+            chunk.end = ( group_size - b < chunk_size ) ? group_size :
+                                                          b + chunk_size;
+            chunks.push_back(chunk);
+        }
+    }
+    return chunks;
+}
+
+double Portfolio::value_chunk(const Chunk& chunk,
+                              const std::vector<BondFactors>& factors,
+                              std::vector<double>& positions) const {
+    const Group& group = m_groups[chunk.group];
+    const double cf = factors[chunk.group].coupon_factor;
+    const double pf = factors[chunk.group].principal_factor;
+    const double * principals = group.principals.data();
+    const double * coupons = group.coupons.data();
+    const std::size_t * indices = group.positions.data();
+
+    double subtotal = 0;
+    for ( std::size_t i = chunk.begin; i < chunk.end; ++i ) {
+        const double pval = principals[i] * (coupons[i] * cf + pf);
+        positions[indices[i]] = pval;
+        subtotal += pval;
+    }
+    return subtotal;
+}
+
+PvDerivatives Portfolio::risk_chunk(const Chunk& chunk,
+                                    const std::vector<BondRiskFactors>&
+                                    factors,
+                                    const double discount_rate,
+                                    std::vector<RiskMeasures>& positions)
+                                    const {
+    const Group& group = m_groups[chunk.group];
+    const PvDerivatives& cf = factors[chunk.group].coupon_factor;
+    const PvDerivatives& pf = factors[chunk.group].principal_factor;
+    const double * principals = group.principals.data();
+    const double * coupons = group.coupons.data();
+    const std::size_t * indices = group.positions.data();
+
+    PvDerivatives subtotal = {0, 0, 0};
+    for ( std::size_t i = chunk.begin; i < chunk.end; ++i ) {
+        const double p = principals[i];
+        const double c = coupons[i];
+        const double pval = p * (c * cf.pv + pf.pv);
+        const double first = p * (c * cf.first + pf.first);
+        const double second = p * (c * cf.second + pf.second);
+        positions[indices[i]] = RiskMeasures(pval, first, second,
+                                             discount_rate);
+        subtotal.pv += pval;
+        subtotal.first += first;
+        subtotal.second += second;
+    }
+    return subtotal;
+}
@@ -0,0 +1,230 @@
+/*!
+ * \file        portfolio.h
+ * \brief       Bond portfolio pricing engine interface.
+ * \details     Bond portfolio pricing engine interface.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_PORTFOLIO_H
+#define PG_FINANCIAL_PORTFOLIO_H
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+#include "bond.h"
+#include "thread_pool.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Portfolio valuation structure
+
+/*!
+ * The `PortfolioValuation` struct holds the present value of each
+ * position in a portfolio, in the order in which the positions were
+ * added, together with their total.
+ */
+
+struct PortfolioValuation {
+    double total;                   /*!< the total present value */
+    std::vector<double> positions;  /*!< each position's present value */
+
+    //! Default constructor
+
+    PortfolioValuation() : total(0), positions() {}
+};
+
+
+//! Portfolio risk structure
+
+/*!
+ * The `PortfolioRisk` struct holds the present value and risk measures
+ * of each position in a portfolio, in the order in which the positions
+ * were added, together with those of the portfolio as a whole.
+ */
+
+struct PortfolioRisk {
+    RiskMeasures total;                 /*!< the whole portfolio's risk */
+    std::vector<RiskMeasures> positions;    /*!< each position's risk */
+
+    //! Default constructor
+
+    PortfolioRisk() : total(), positions() {}
+};
+
+
+//! Bond portfolio class.
+
+/*!
+ * Holds a portfolio of positions in simple bonds, and values them in
+ * parallel.
+ *
+ * Positions are stored in a flat structure-of-arrays layout, grouped by
+ * coupon frequency and maturity. Since the value of a level coupon bond
+ * is linear in its principal and coupon rate (see `BondFactors`), each
+ * group's discounting is done once per valuation, and each position is
+ * then valued with a single multiply-add from contiguous arrays.
+ *
+ * For valuation, the positions in each group are divided into chunks of
+ * a fixed size, which are shared among the threads of a `ThreadPool`.
+ * The total is the sum of the chunk subtotals taken in a fixed order, so
+ * it is bit-for-bit identical whatever the number of threads and
+ * however the chunks happen to be scheduled.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::Portfolio book;
+ * book.add(financial::SimpleBond(1000, 0.05, 2, 10), 250);
+ * book.add(financial::SimpleBond(1000, 0.04, 1, 5), 100);
+ *
+ * financial::ThreadPool pool;
+ * financial::PortfolioValuation val = book.value(0.045, pool);
+ * std::cout << "Total value: " << val.total << std::endl;
+ * ~~~~
+ */
+
+class Portfolio {
+    public:
+
+        //! Number of positions in each chunk of work.
+
+        static const std::size_t chunk_size = 4096;
+
+
+        //! Default constructor
+
+        /*!
+         * Creates an empty portfolio.
+         */
+
+        Portfolio() : m_groups(), m_group_index(), m_num_positions(0) {}
+
+
+        //! Adds a position to the portfolio.
+
+        /*!
+         * \param bond the bond held.
+         * \param quantity the number of bonds held.
+         * \return the index of the position, which is its index in
+         * `PortfolioValuation::positions`.
+         */
+
+        std::size_t add(const SimpleBond& bond, const double quantity = 1);
+
+
+        //! Returns the number of positions in the portfolio.
+
+        std::size_t size() const { return m_num_positions; }
+
+
+        //! Values the portfolio on the calling thread.
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \return the present value of each position, and the total.
+         */
+
+        PortfolioValuation value(const double discount_rate) const;
+
+
+        //! Values the portfolio in parallel.
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \param pool the thread pool to run the valuation on.
+         * \return the present value of each position, and the total,
+         * identical to those returned by the single threaded overload.
+         */
+
+        PortfolioValuation value(const double discount_rate,
+                                 ThreadPool& pool) const;
+
+
+        //! Calculates the portfolio's present value and risk measures.
+
+        /*!
+         * Calculates the present value, durations, convexity and DV01
+         * of each position and of the whole portfolio, on the calling
+         * thread. Each group's factors and their derivatives are
+         * calculated once, in a single pass over its coupon dates (see
+         * `bond_risk_factors()`).
+         *
+         * \param discount_rate the discount rate to use.
+         * \return the risk measures of each position, and the total.
+         */
+
+        PortfolioRisk price_and_risk(const double discount_rate) const;
+
+
+        //! Calculates the portfolio's present value and risk in parallel.
+
+        /*!
+         * \param discount_rate the discount rate to use.
+         * \param pool the thread pool to run the calculation on.
+         * \return the risk measures of each position, and the total,
+         * identical to those returned by the single threaded overload.
+         */
+
+        PortfolioRisk price_and_risk(const double discount_rate,
+                                     ThreadPool& pool) const;
+
+
+    private:
+
+        //! Positions sharing a coupon frequency and maturity.
+
+        struct Group {
+            Group(const int coupon_frequency, const int maturity) :
+                coupon_frequency(coupon_frequency), maturity(maturity),
+                principals(), coupons(), positions() {}
+            int coupon_frequency;               /*!< coupon frequency */
+            int maturity;                       /*!< periods to maturity */
+            std::vector<double> principals;     /*!< principal * quantity */
+            std::vector<double> coupons;        /*!< coupon rates */
+            std::vector<std::size_t> positions; /*!< position indices */
+        };
+
+        //! A chunk of positions within a group.
+
+        struct Chunk {
+            std::size_t group;  /*!< the group index */
+            std::size_t begin;  /*!< the first position in the group */
+            std::size_t end;    /*!< one past the last position */
+        };
+
+        //! Divides the groups into chunks.
+        std::vector<Chunk> make_chunks() const;
+
+        //! Values one chunk, returning its subtotal.
+        double value_chunk(const Chunk& chunk,
+                           const std::vector<BondFactors>& factors,
+                           std::vector<double>& positions) const;
+
+        //! Calculates one chunk's risk, returning its subtotals.
+        PvDerivatives risk_chunk(const Chunk& chunk,
+                                 const std::vector<BondRiskFactors>& factors,
+                                 const double discount_rate,
+                                 std::vector<RiskMeasures>& positions) const;
+
+        //! Values the portfolio, with or without a thread pool.
+        PortfolioValuation run_valuation(const double discount_rate,
+                                         ThreadPool * pool) const;
+
+        //! Calculates risk, with or without a thread pool.
+        PortfolioRisk run_risk(const double discount_rate,
+                               ThreadPool * pool) const;
+
+        std::vector<Group> m_groups;    /*!< the position groups */
+        std::map<std::pair<int, int>, std::size_t> m_group_index;
+                                        /*!< groups by frequency, maturity */
+        std::size_t m_num_positions;    /*!< the number of positions */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_PORTFOLIO_H
@@ -0,0 +1,316 @@
+/*!
+ * \file        pv_kernels.cpp
+ * \brief       Vectorized discounting kernels implementation.
+ * \details     Scalar discounting kernels, and runtime selection of the
+ * instruction set used by the dispatching kernels.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cassert>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include "pv_kernels.h"
+
+using namespace financial;
+using namespace financial::detail;
+
+namespace {
+
+//! Returns true if the running processor supports an instruction set.
+
+bool cpu_supports(const simd_isa isa) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    __builtin_cpu_init();
+    if ( isa == simd_isa::avx2 ) {
+        return __builtin_cpu_supports("avx2") &&
+               __builtin_cpu_supports("fma");
+    } else if ( isa == simd_isa::avx512 ) {
+        return __builtin_cpu_supports("avx512f");
+    }
+#endif
+    return isa == simd_isa::scalar;
+}
+
+
+//! Determines the widest available instruction set.
+
+simd_isa detect_isa() {
+    if ( isa_available(simd_isa::avx512) ) {
+        return simd_isa::avx512;
+    } else if ( isa_available(simd_isa::avx2) ) {
+        return simd_isa::avx2;
+    } else {
+        return simd_isa::scalar;
+    }
+}
+
+}           //  namespace
+
+
+simd_isa detail::active_isa() {
+    static const simd_isa isa = detect_isa();
+    return isa;
+}
+
+bool detail::isa_available(const simd_isa isa) {
+    if ( isa == simd_isa::avx2 ) {
+        return avx2_compiled() && cpu_supports(simd_isa::avx2);
+    } else if ( isa == simd_isa::avx512 ) {
+        return avx512_compiled() && cpu_supports(simd_isa::avx512);
+    } else {
+        return true;
+    }
+}
+
+double detail::kernel_exp(const double x) {
+    using namespace exp_constants;
+
+    if ( x > max_arg ) {
+        return std::numeric_limits<double>::infinity();
+    } else if ( x < min_arg ) {
+        return 0;
+    } else if ( std::isnan(x) ) {
+        return x;
+    }
+
+    const double kd = std::nearbyint(x * log2e);
+    const double r = (x - kd * ln2_hi) - kd * ln2_lo;
+    double p = poly[0];
+    for ( int i = 1; i < 14; ++i ) {
+        p = p * r + poly[i];
+    }
+    return std::ldexp(p, static_cast<int>(kd));
+}
+
+double detail::kernel_expm1(const double x) {
+    using namespace exp_constants;
+
+    //  Beyond the limit exp(x) is either so large, or so small, that
+    //  subtracting one loses nothing. NaN also takes this path.
+
+    if ( !(std::fabs(x) <= expm1_limit) ) {
+        return kernel_exp(x) - 1;
+    }
+
+    const double kd = std::nearbyint(x * log2e);
+    const double r = (x - kd * ln2_hi) - kd * ln2_lo;
+    double p = poly[0];
+    for ( int i = 1; i < 13; ++i ) {
+        p = p * r + poly[i];
+    }
+    const double q = p * r;
+    const int k = static_cast<int>(kd);
+    return k ? std::ldexp(q, k) + (std::ldexp(1.0, k) - 1) : q;
+}
+
+double detail::kernel_log1p(const double x) {
+    using namespace log_constants;
+
+    const double u = 1 + x;
+    int e = 0;
+    double m = 2 * std::frexp(u, &e);
+    --e;
+    if ( m > sqrt2 ) {
+        m /= 2;
+        ++e;
+    }
+
+    const double s = (m - 1) / (m + 1);
+    const double z = s * s;
+    double p = poly[0];
+    for ( int i = 1; i < 12; ++i ) {
+        p = p * z + poly[i];
+    }
+
+    //  (x - (u - 1)) / u corrects for the rounding of 1 + x.
+
+    const double correction = (x - (u - 1)) / u;
+    return e * exp_constants::ln2_hi +
+           (2 * s * p + (e * exp_constants::ln2_lo + correction));
+}
+
+double detail::pv_sum_scalar(const double * amounts,
+                             const double * times,
+                             const std::size_t num_cashflows,
+                             const double log_growth) {
+    double pv_total = 0;
+    for ( std::size_t i = 0; i < num_cashflows; ++i ) {
+        pv_total += amounts[i] * kernel_exp(-times[i] * log_growth);
+    }
+    return pv_total;
+}
+
+double detail::pv_sum(const simd_isa isa,
+                      const double * amounts,
+                      const double * times,
+                      const std::size_t num_cashflows,
+                      const double log_growth) {
+    if ( isa == simd_isa::avx512 ) {
+        return pv_sum_avx512(amounts, times, num_cashflows, log_growth);
+    } else if ( isa == simd_isa::avx2 ) {
+        return pv_sum_avx2(amounts, times, num_cashflows, log_growth);
+    } else if ( isa == simd_isa::scalar ) {
+        return pv_sum_scalar(amounts, times, num_cashflows, log_growth);
+    } else {
+        assert(false);
+        return 0;
+    }
+}
+
+double detail::pv_sum(const double * amounts,
+                      const double * times,
+                      const std::size_t num_cashflows,
+                      const double log_growth) {
+    return pv_sum(active_isa(), amounts, times, num_cashflows, log_growth);
+}
+
+void detail::pv_sum_multi_scalar(const double * amounts,
+                                 const double * times,
+                                 const std::size_t num_cashflows,
+                                 const double * log_growths,
+                                 const std::size_t num_rates,
+                                 double * present_values) {
+    std::fill(present_values, present_values + num_rates, 0.0);
+    for ( std::size_t b = 0; b < num_cashflows; b += multi_block_size ) {
+        const std::size_t e = std::min(num_cashflows, b + multi_block_size);
+        for ( std::size_t j = 0; j < num_rates; ++j ) {
+            double pv_total = present_values[j];
+            for ( std::size_t i = b; i < e; ++i ) {
+                pv_total += amounts[i] *
+                            kernel_exp(-times[i] * log_growths[j]);
+            }
+            present_values[j] = pv_total;
+        }
+    }
+}
+
+void detail::pv_sum_multi(const simd_isa isa,
+                          const double * amounts,
+                          const double * times,
+                          const std::size_t num_cashflows,
+                          const double * log_growths,
+                          const std::size_t num_rates,
+                          double * present_values) {
+    if ( isa == simd_isa::avx512 ) {
+        pv_sum_multi_avx512(amounts, times, num_cashflows,
+                            log_growths, num_rates, present_values);
+    } else if ( isa == simd_isa::avx2 ) {
+        pv_sum_multi_avx2(amounts, times, num_cashflows,
+                          log_growths, num_rates, present_values);
+    } else if ( isa == simd_isa::scalar ) {
+        pv_sum_multi_scalar(amounts, times, num_cashflows,
+                            log_growths, num_rates, present_values);
+    } else {
+        assert(false);
+    }
+}
+
+void detail::pv_sum_multi(const double * amounts,
+                          const double * times,
+                          const std::size_t num_cashflows,
+                          const double * log_growths,
+                          const std::size_t num_rates,
+                          double * present_values) {
+    pv_sum_multi(active_isa(), amounts, times, num_cashflows,
+                 log_growths, num_rates, present_values);
+}
+
+void detail::discount_factors_scalar(const double * rates,
+                                     const double * periods,
+                                     const std::size_t num_rates,
+                                     double * factors) {
+    const double no_rate = std::numeric_limits<double>::quiet_NaN();
+    for ( std::size_t i = 0; i < num_rates; ++i ) {
+        factors[i] = ( rates[i] > -1 ) ?
+            kernel_exp(-periods[i] * kernel_log1p(rates[i])) : no_rate;
+    }
+}
+
+void detail::discount_factors(const simd_isa isa,
+                              const double * rates,
+                              const double * periods,
+                              const std::size_t num_rates,
+                              double * factors) {
+    if ( isa == simd_isa::avx512 ) {
+        discount_factors_avx512(rates, periods, num_rates, factors);
+    } else if ( isa == simd_isa::avx2 ) {
+        discount_factors_avx2(rates, periods, num_rates, factors);
+    } else if ( isa == simd_isa::scalar ) {
+        discount_factors_scalar(rates, periods, num_rates, factors);
+    } else {
+        assert(false);
+    }
+}
+
+void detail::discount_factors(const double * rates,
+                              const double * periods,
+                              const std::size_t num_rates,
+                              double * factors) {
+    discount_factors(active_isa(), rates, periods, num_rates, factors);
+}
+
+void detail::discount_growths_scalar(const double * rates,
+                                     const double * periods,
+                                     const std::size_t num_rates,
+                                     double * growths) {
+    const double no_rate = std::numeric_limits<double>::quiet_NaN();
+    for ( std::size_t i = 0; i < num_rates; ++i ) {
+        growths[i] = ( rates[i] > -1 ) ?
+            kernel_expm1(-periods[i] * kernel_log1p(rates[i])) : no_rate;
+    }
+}
+
+void detail::discount_growths(const simd_isa isa,
+                              const double * rates,
+                              const double * periods,
+                              const std::size_t num_rates,
+                              double * growths) {
+    if ( isa == simd_isa::avx512 ) {
+        discount_growths_avx512(rates, periods, num_rates, growths);
+    } else if ( isa == simd_isa::avx2 ) {
+        discount_growths_avx2(rates, periods, num_rates, growths);
+    } else if ( isa == simd_isa::scalar ) {
+        discount_growths_scalar(rates, periods, num_rates, growths);
+    } else {
+        assert(false);
+    }
+}
+
+void detail::discount_growths(const double * rates,
+                              const double * periods,
+                              const std::size_t num_rates,
+                              double * growths) {
+    discount_growths(active_isa(), rates, periods, num_rates, growths);
+}
+
+void detail::exponentials_scalar(const double * args,
+                                 const std::size_t num_args,
+                                 double * results) {
+    for ( std::size_t i = 0; i < num_args; ++i ) {
+        results[i] = kernel_exp(args[i]);
+    }
+}
+
+void detail::exponentials(const simd_isa isa,
+                          const double * args,
+                          const std::size_t num_args,
+                          double * results) {
+    if ( isa == simd_isa::avx512 ) {
+        exponentials_avx512(args, num_args, results);
+    } else if ( isa == simd_isa::avx2 ) {
+        exponentials_avx2(args, num_args, results);
+    } else if ( isa == simd_isa::scalar ) {
+        exponentials_scalar(args, num_args, results);
+    } else {
+        assert(false);
+    }
+}
+
+void detail::exponentials(const double * args,
+                          const std::size_t num_args,
+                          double * results) {
+    exponentials(active_isa(), args, num_args, results);
+}
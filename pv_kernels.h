@@ -0,0 +1,463 @@
+/*!
+ * \file        pv_kernels.h
+ * \brief       Vectorized discounting kernels interface.
+ * \details     Internal interface to the vectorized discounting kernels
+ * and the runtime selection of the instruction set they use.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_PV_KERNELS_H
+#define PG_FINANCIAL_PV_KERNELS_H
+
+#include <cstddef>
+
+//! User library namespace
+
+namespace financial {
+
+//! Library implementation details namespace
+
+namespace detail {
+
+
+//! Enumeration class for SIMD instruction sets
+
+enum class simd_isa {
+    scalar,             /*!< portable scalar code. */
+    avx2,               /*!< AVX2 with FMA, four doubles per vector. */
+    avx512              /*!< AVX-512F, eight doubles per vector. */
+};
+
+
+//! Returns the widest instruction set usable on this processor.
+
+/*!
+ * The result is determined on the first call, and is the widest
+ * instruction set both compiled into the library and supported by
+ * the running processor.
+ *
+ * \return the instruction set used by the dispatching kernels.
+ */
+
+simd_isa active_isa();
+
+
+//! Returns true if a kernel for an instruction set can run here.
+
+/*!
+ * \param isa the instruction set to query.
+ * \return `true` if the kernels for `isa` were compiled into the
+ * library and the running processor supports them.
+ */
+
+bool isa_available(const simd_isa isa);
+
+
+//! Calculates a sum of discounted cash flows.
+
+/*!
+ * Calculates the sum over `i` of `amounts[i] * exp(-times[i] *
+ * log_growth)`, using the kernel for the active instruction set. For
+ * discrete discounting, `log_growth` is `log1p(interest_rate)`; for
+ * continuous discounting it is the interest rate itself.
+ *
+ * \param amounts an array of `num_cashflows` cash flow amounts.
+ * \param times an array of `num_cashflows` cash flow time periods.
+ * \param num_cashflows the number of cash flows.
+ * \param log_growth the logarithm of the one-period growth factor.
+ * \return the sum of the discounted cash flows.
+ */
+
+double pv_sum(const double * amounts,
+              const double * times,
+              const std::size_t num_cashflows,
+              const double log_growth);
+
+
+//! Calculates a sum of discounted cash flows with a given kernel.
+
+/*!
+ * As `pv_sum()`, but uses the kernel for a specified instruction set,
+ * which must be available.
+ *
+ * \param isa the instruction set to use.
+ * \param amounts an array of `num_cashflows` cash flow amounts.
+ * \param times an array of `num_cashflows` cash flow time periods.
+ * \param num_cashflows the number of cash flows.
+ * \param log_growth the logarithm of the one-period growth factor.
+ * \return the sum of the discounted cash flows.
+ */
+
+double pv_sum(const simd_isa isa,
+              const double * amounts,
+              const double * times,
+              const std::size_t num_cashflows,
+              const double log_growth);
+
+
+//! Calculates sums of discounted cash flows at many rates.
+
+/*!
+ * Calculates `pv_sum(amounts, times, num_cashflows, log_growths[j])` for
+ * each `j`, storing the result in `present_values[j]`. The cash flows are
+ * processed in blocks small enough to stay in the L1 cache while every
+ * rate is applied to them, and the rates are processed several vectors
+ * at a time. The cash flows for each rate are summed in order, so the
+ * results may differ from `pv_sum()` by reassociation error.
+ *
+ * \param amounts an array of `num_cashflows` cash flow amounts.
+ * \param times an array of `num_cashflows` cash flow time periods.
+ * \param num_cashflows the number of cash flows.
+ * \param log_growths an array of `num_rates` logarithms of one-period
+ * growth factors.
+ * \param num_rates the number of rates.
+ * \param present_values an array of `num_rates` doubles to receive the
+ * sums of the discounted cash flows.
+ */
+
+void pv_sum_multi(const double * amounts,
+                  const double * times,
+                  const std::size_t num_cashflows,
+                  const double * log_growths,
+                  const std::size_t num_rates,
+                  double * present_values);
+
+
+//! Calculates sums of discounted cash flows with a given kernel.
+
+/*!
+ * As `pv_sum_multi()`, but uses the kernel for a specified instruction
+ * set, which must be available.
+ */
+
+void pv_sum_multi(const simd_isa isa,
+                  const double * amounts,
+                  const double * times,
+                  const std::size_t num_cashflows,
+                  const double * log_growths,
+                  const std::size_t num_rates,
+                  double * present_values);
+
+
+//! Calculates discount factors for many rates and periods.
+
+/*!
+ * Calculates `factors[i] = (1 + rates[i]) ** -periods[i]`, as
+ * `exp(-periods[i] * log1p(rates[i]))`, using the kernel for the active
+ * instruction set. A rate not greater than -1 gives NaN.
+ *
+ * \param rates an array of `num_rates` periodic interest rates.
+ * \param periods an array of `num_rates` numbers of periods.
+ * \param num_rates the number of rates.
+ * \param factors an array of `num_rates` doubles to receive the
+ * discount factors, which may be the same array as `rates` or `periods`.
+ */
+
+void discount_factors(const double * rates,
+                      const double * periods,
+                      const std::size_t num_rates,
+                      double * factors);
+
+
+//! Calculates discount factors with a given kernel.
+
+/*!
+ * As `discount_factors()`, but uses the kernel for a specified
+ * instruction set, which must be available.
+ */
+
+void discount_factors(const simd_isa isa,
+                      const double * rates,
+                      const double * periods,
+                      const std::size_t num_rates,
+                      double * factors);
+
+
+//! Calculates discount factors less one for many rates and periods.
+
+/*!
+ * Calculates `growths[i] = (1 + rates[i]) ** -periods[i] - 1`, as
+ * `expm1(-periods[i] * log1p(rates[i]))`, using the kernel for the
+ * active instruction set. Unlike `discount_factors()` less one, there
+ * is no cancellation when the factor is close to one, so the result
+ * keeps full relative accuracy for small rates and short times. A rate
+ * not greater than -1 gives NaN.
+ *
+ * \param rates an array of `num_rates` periodic interest rates.
+ * \param periods an array of `num_rates` numbers of periods.
+ * \param num_rates the number of rates.
+ * \param growths an array of `num_rates` doubles to receive the
+ * results, which may be the same array as `rates` or `periods`.
+ */
+
+void discount_growths(const double * rates,
+                      const double * periods,
+                      const std::size_t num_rates,
+                      double * growths);
+
+
+//! Calculates discount factors less one with a given kernel.
+
+/*!
+ * As `discount_growths()`, but uses the kernel for a specified
+ * instruction set, which must be available.
+ */
+
+void discount_growths(const simd_isa isa,
+                      const double * rates,
+                      const double * periods,
+                      const std::size_t num_rates,
+                      double * growths);
+
+
+//! Calculates the exponential function of many arguments.
+
+/*!
+ * Calculates `results[i] = exp(args[i])` with the kernels' exponential
+ * function, using the kernel for the active instruction set.
+ *
+ * \param args an array of `num_args` arguments.
+ * \param num_args the number of arguments.
+ * \param results an array of `num_args` doubles to receive the
+ * exponentials, which may be the same array as `args`.
+ */
+
+void exponentials(const double * args,
+                  const std::size_t num_args,
+                  double * results);
+
+
+//! Calculates the exponential function with a given kernel.
+
+/*!
+ * As `exponentials()`, but uses the kernel for a specified instruction
+ * set, which must be available.
+ */
+
+void exponentials(const simd_isa isa,
+                  const double * args,
+                  const std::size_t num_args,
+                  double * results);
+
+
+//! Number of cash flows in each cache block of pv_sum_multi().
+
+const std::size_t multi_block_size = 512;
+
+
+//! Scalar kernel for pv_sum().
+
+double pv_sum_scalar(const double * amounts,
+                     const double * times,
+                     const std::size_t num_cashflows,
+                     const double log_growth);
+
+//! AVX2 kernel for pv_sum().
+
+double pv_sum_avx2(const double * amounts,
+                   const double * times,
+                   const std::size_t num_cashflows,
+                   const double log_growth);
+
+//! AVX-512 kernel for pv_sum().
+
+double pv_sum_avx512(const double * amounts,
+                     const double * times,
+                     const std::size_t num_cashflows,
+                     const double log_growth);
+
+//! Scalar kernel for pv_sum_multi().
+
+void pv_sum_multi_scalar(const double * amounts,
+                         const double * times,
+                         const std::size_t num_cashflows,
+                         const double * log_growths,
+                         const std::size_t num_rates,
+                         double * present_values);
+
+//! AVX2 kernel for pv_sum_multi().
+
+void pv_sum_multi_avx2(const double * amounts,
+                       const double * times,
+                       const std::size_t num_cashflows,
+                       const double * log_growths,
+                       const std::size_t num_rates,
+                       double * present_values);
+
+//! AVX-512 kernel for pv_sum_multi().
+
+void pv_sum_multi_avx512(const double * amounts,
+                         const double * times,
+                         const std::size_t num_cashflows,
+                         const double * log_growths,
+                         const std::size_t num_rates,
+                         double * present_values);
+
+//! Scalar kernel for discount_factors().
+
+void discount_factors_scalar(const double * rates,
+                             const double * periods,
+                             const std::size_t num_rates,
+                             double * factors);
+
+//! AVX2 kernel for discount_factors().
+
+void discount_factors_avx2(const double * rates,
+                           const double * periods,
+                           const std::size_t num_rates,
+                           double * factors);
+
+//! AVX-512 kernel for discount_factors().
+
+void discount_factors_avx512(const double * rates,
+                             const double * periods,
+                             const std::size_t num_rates,
+                             double * factors);
+
+//! Scalar kernel for discount_growths().
+
+void discount_growths_scalar(const double * rates,
+                             const double * periods,
+                             const std::size_t num_rates,
+                             double * growths);
+
+//! AVX2 kernel for discount_growths().
+
+void discount_growths_avx2(const double * rates,
+                           const double * periods,
+                           const std::size_t num_rates,
+                           double * growths);
+
+//! AVX-512 kernel for discount_growths().
+
+void discount_growths_avx512(const double * rates,
+                             const double * periods,
+                             const std::size_t num_rates,
+                             double * growths);
+
+//! Scalar kernel for exponentials().
+
+void exponentials_scalar(const double * args,
+                         const std::size_t num_args,
+                         double * results);
+
+//! AVX2 kernel for exponentials().
+
+void exponentials_avx2(const double * args,
+                       const std::size_t num_args,
+                       double * results);
+
+//! AVX-512 kernel for exponentials().
+
+void exponentials_avx512(const double * args,
+                         const std::size_t num_args,
+                         double * results);
+
+//! Returns true if the AVX2 kernels were compiled into the library.
+
+bool avx2_compiled();
+
+//! Returns true if the AVX-512 kernels were compiled into the library.
+
+bool avx512_compiled();
+
+
+//! Calculates the exponential function with the kernels' algorithm.
+
+/*!
+ * A scalar version of the exponential used by all the kernels: the
+ * argument is reduced to `r = x - k * ln(2)` with `|r| <= ln(2) / 2`,
+ * `exp(r)` is evaluated with a degree 13 Taylor polynomial, and the
+ * result is scaled by `2 ** k`. The error is within 1.5 ulp wherever
+ * the result is a normal number. Above `max_arg` the result overflows
+ * to infinity, below `min_arg` it underflows to zero, and between
+ * `min_arg` and -708 it is subnormal, scaled with a single rounding. A
+ * NaN argument gives NaN. The vectorized kernels treat every argument
+ * in the same way.
+ *
+ * \param x the argument.
+ * \return the exponential of `x`.
+ */
+
+double kernel_exp(const double x);
+
+
+//! Constants shared by the kernels' exponential function.
+
+namespace exp_constants {
+    const double min_arg = -745.13321910194111;     /*!< underflow limit */
+    const double max_arg = 709.78271289338397;      /*!< overflow limit */
+    const double log2e = 1.4426950408889634074;     /*!< 1 / ln(2) */
+    const double ln2_hi = 6.93147180369123816490e-01;   /*!< ln(2) high */
+    const double ln2_lo = 1.90821492927058770002e-10;   /*!< ln(2) low */
+
+    //! Taylor coefficients 1/13! down to 1/0!, for Horner's method.
+    const double poly[14] = {
+        1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0,
+        1.0 / 3628800.0, 1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0,
+        1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+    };
+}
+
+//! Calculates `exp(x) - 1` with the kernels' algorithm.
+
+/*!
+ * A scalar version of the `expm1()` used by the kernels. For `|x|` not
+ * greater than `expm1_limit`, the argument is reduced as for
+ * `kernel_exp()`, `expm1(r)` is evaluated with the same polynomial less
+ * its constant term, and the result is `2 ** k * expm1(r) + (2 ** k -
+ * 1)`, which involves no cancellation. When `k` is zero the result is
+ * just `expm1(r)`, so small `x` keeps full relative accuracy. Beyond
+ * `expm1_limit`, the result is `kernel_exp(x) - 1`. The error is within
+ * 3 ulp.
+ *
+ * \param x the argument.
+ * \return the exponential of `x`, less one.
+ */
+
+double kernel_expm1(const double x);
+
+
+//! Largest magnitude of argument reduced by `kernel_expm1()`.
+
+const double expm1_limit = 40.0;
+
+
+//! Calculates `log(1 + x)` with the kernels' algorithm.
+
+/*!
+ * A scalar version of the logarithm used by the kernels: `1 + x` is
+ * split into `m * 2 ** e` with `m` in [sqrt(1/2), sqrt(2)], `log(m)` is
+ * evaluated as `2 * atanh(s)` with `s = (m - 1) / (m + 1)` by its odd
+ * series to the 23rd power, and `e * ln(2)` is added. The rounding
+ * error in forming `1 + x` is corrected to first order, so small `x`
+ * keeps full relative accuracy. The error is within 2 ulp for `x`
+ * greater than -1; `x` must be greater than -1.
+ *
+ * \param x the argument.
+ * \return the logarithm of `1 + x`.
+ */
+
+double kernel_log1p(const double x);
+
+
+//! Constants used by the kernels' logarithm function.
+
+namespace log_constants {
+    const double sqrt2 = 1.4142135623730950488;     /*!< sqrt(2) */
+
+    //! Series coefficients 1/23 down to 1/1, for Horner's method in s^2.
+    const double poly[12] = {
+        1.0 / 23.0, 1.0 / 21.0, 1.0 / 19.0, 1.0 / 17.0, 1.0 / 15.0,
+        1.0 / 13.0, 1.0 / 11.0, 1.0 / 9.0, 1.0 / 7.0, 1.0 / 5.0,
+        1.0 / 3.0, 1.0
+    };
+}
+
+}               //  namespace detail
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_PV_KERNELS_H
@@ -0,0 +1,358 @@
+/*!
+ * \file        pv_kernels_avx2.cpp
+ * \brief       AVX2 discounting kernels implementation.
+ * \details     AVX2 discounting kernels implementation. This file must
+ * be compiled with AVX2 and FMA code generation enabled; if it is not,
+ * the kernels are not compiled in and are never selected.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <limits>
+#include "pv_kernels.h"
+
+using namespace financial;
+using namespace financial::detail;
+
+#if defined(__AVX2__) && defined(__FMA__)
+
+#include <immintrin.h>
+
+namespace {
+
+//! Calculates the exponential function of four doubles.
+
+inline __m256d exp_pd(const __m256d x) {
+    using namespace exp_constants;
+
+    const __m256d cx = _mm256_min_pd(_mm256_max_pd(x,
+                _mm256_set1_pd(min_arg)), _mm256_set1_pd(max_arg));
+    const __m256d kd = _mm256_round_pd(
+            _mm256_mul_pd(cx, _mm256_set1_pd(log2e)),
+            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(kd, _mm256_set1_pd(ln2_hi), cx);
+    r = _mm256_fnmadd_pd(kd, _mm256_set1_pd(ln2_lo), r);
+
+    __m256d p = _mm256_set1_pd(poly[0]);
+    for ( int i = 1; i < 14; ++i ) {
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(poly[i]));
+    }
+
+    //  k ranges over [-1075, 1024], beyond the normal exponents, so
+    //  2 ** k is applied as two factors, each a normal number. The
+    //  second multiplication is the only one which may round.
+
+    const __m128i k = _mm256_cvtpd_epi32(kd);
+    const __m128i k1 = _mm_srai_epi32(k, 1);
+    const __m128i k2 = _mm_sub_epi32(k, k1);
+    const __m256i bias = _mm256_set1_epi64x(1023);
+    const __m256d f1 = _mm256_castsi256_pd(_mm256_slli_epi64(
+            _mm256_add_epi64(_mm256_cvtepi32_epi64(k1), bias), 52));
+    const __m256d f2 = _mm256_castsi256_pd(_mm256_slli_epi64(
+            _mm256_add_epi64(_mm256_cvtepi32_epi64(k2), bias), 52));
+    __m256d result = _mm256_mul_pd(_mm256_mul_pd(p, f1), f2);
+
+    //  Arguments outside the clamped range overflow or underflow, and
+    //  NaN, which the clamp replaced, is passed through.
+
+    if ( _mm256_movemask_pd(_mm256_cmp_pd(x, cx, _CMP_EQ_OQ)) == 0xf ) {
+        return result;
+    }
+    result = _mm256_blendv_pd(result,
+            _mm256_set1_pd(std::numeric_limits<double>::infinity()),
+            _mm256_cmp_pd(x, _mm256_set1_pd(max_arg), _CMP_GT_OQ));
+    result = _mm256_blendv_pd(result, _mm256_setzero_pd(),
+            _mm256_cmp_pd(x, _mm256_set1_pd(min_arg), _CMP_LT_OQ));
+    return _mm256_blendv_pd(result, x, _mm256_cmp_pd(x, x, _CMP_UNORD_Q));
+}
+
+
+//! Calculates exp(x) - 1 of four doubles.
+
+inline __m256d expm1_pd(const __m256d x) {
+    using namespace exp_constants;
+
+    const __m256d limit = _mm256_set1_pd(expm1_limit);
+    const __m256d cx = _mm256_min_pd(_mm256_max_pd(x,
+                _mm256_sub_pd(_mm256_setzero_pd(), limit)), limit);
+    const __m256d kd = _mm256_round_pd(
+            _mm256_mul_pd(cx, _mm256_set1_pd(log2e)),
+            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_fnmadd_pd(kd, _mm256_set1_pd(ln2_hi), cx);
+    r = _mm256_fnmadd_pd(kd, _mm256_set1_pd(ln2_lo), r);
+
+    __m256d p = _mm256_set1_pd(poly[0]);
+    for ( int i = 1; i < 13; ++i ) {
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(poly[i]));
+    }
+    const __m256d q = _mm256_mul_pd(p, r);
+
+    //  2 ** k is a normal number for |k| within the limit, and
+    //  2 ** k - 1 is exact.
+
+    const __m256i k = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(kd));
+    const __m256d two_k = _mm256_castsi256_pd(_mm256_slli_epi64(
+            _mm256_add_epi64(k, _mm256_set1_epi64x(1023)), 52));
+    const __m256d result = _mm256_fmadd_pd(q, two_k,
+            _mm256_sub_pd(two_k, _mm256_set1_pd(1.0)));
+
+    if ( _mm256_movemask_pd(_mm256_cmp_pd(x, cx, _CMP_EQ_OQ)) == 0xf ) {
+        return result;
+    }
+    return _mm256_blendv_pd(result,
+            _mm256_sub_pd(exp_pd(x), _mm256_set1_pd(1.0)),
+            _mm256_cmp_pd(x, cx, _CMP_NEQ_UQ));
+}
+
+
+//! Calculates log(1 + x) of four doubles, each greater than -1.
+
+inline __m256d log1p_pd(const __m256d x) {
+    using namespace log_constants;
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d u = _mm256_add_pd(one, x);
+
+    //  Split u into a mantissa in [1, 2) and an exponent, which is
+    //  converted to double by placing it in the mantissa of 2 ** 52.
+
+    const __m256i bits = _mm256_castpd_si256(u);
+    __m256d m = _mm256_castsi256_pd(_mm256_or_si256(
+            _mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+            _mm256_set1_epi64x(0x3FF0000000000000LL)));
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(
+            _mm256_srli_epi64(bits, 52),
+            _mm256_set1_epi64x(0x4330000000000000LL))),
+            _mm256_set1_pd(4503599627370496.0 + 1023));
+    const __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(sqrt2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), big);
+    e = _mm256_add_pd(e, _mm256_and_pd(big, one));
+
+    const __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one),
+                                    _mm256_add_pd(m, one));
+    const __m256d z = _mm256_mul_pd(s, s);
+    __m256d p = _mm256_set1_pd(poly[0]);
+    for ( int i = 1; i < 12; ++i ) {
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(poly[i]));
+    }
+
+    const __m256d correction = _mm256_div_pd(
+            _mm256_sub_pd(x, _mm256_sub_pd(u, one)), u);
+    const __m256d lo = _mm256_fmadd_pd(e,
+            _mm256_set1_pd(exp_constants::ln2_lo), correction);
+    return _mm256_fmadd_pd(e, _mm256_set1_pd(exp_constants::ln2_hi),
+                           _mm256_fmadd_pd(_mm256_add_pd(s, s), p, lo));
+}
+
+
+//! Sums the four lanes of a vector.
+
+inline double hsum_pd(const __m256d v) {
+    const __m128d lo = _mm256_castpd256_pd128(v);
+    const __m128d hi = _mm256_extractf128_pd(v, 1);
+    const __m128d s = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+}           //  namespace
+
+
+bool detail::avx2_compiled() {
+    return true;
+}
+
+double detail::pv_sum_avx2(const double * amounts,
+                           const double * times,
+                           const std::size_t num_cashflows,
+                           const double log_growth) {
+    const __m256d neg_lg = _mm256_set1_pd(-log_growth);
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+
+    std::size_t i = 0;
+    for ( ; i + 8 <= num_cashflows; i += 8 ) {
+        const __m256d t0 = _mm256_loadu_pd(times + i);
+        const __m256d t1 = _mm256_loadu_pd(times + i + 4);
+        const __m256d df0 = exp_pd(_mm256_mul_pd(t0, neg_lg));
+        const __m256d df1 = exp_pd(_mm256_mul_pd(t1, neg_lg));
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(amounts + i), df0, acc0);
+        acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(amounts + i + 4), df1, acc1);
+    }
+    for ( ; i + 4 <= num_cashflows; i += 4 ) {
+        const __m256d t0 = _mm256_loadu_pd(times + i);
+        const __m256d df0 = exp_pd(_mm256_mul_pd(t0, neg_lg));
+        acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(amounts + i), df0, acc0);
+    }
+
+    double pv_total = hsum_pd(_mm256_add_pd(acc0, acc1));
+    for ( ; i < num_cashflows; ++i ) {
+        pv_total += amounts[i] * kernel_exp(-times[i] * log_growth);
+    }
+    return pv_total;
+}
+
+void detail::pv_sum_multi_avx2(const double * amounts,
+                               const double * times,
+                               const std::size_t num_cashflows,
+                               const double * log_growths,
+                               const std::size_t num_rates,
+                               double * present_values) {
+    std::fill(present_values, present_values + num_rates, 0.0);
+    for ( std::size_t b = 0; b < num_cashflows; b += multi_block_size ) {
+        const std::size_t e = std::min(num_cashflows, b + multi_block_size);
+
+        std::size_t j = 0;
+        for ( ; j + 16 <= num_rates; j += 16 ) {
+            const __m256d zero = _mm256_setzero_pd();
+            const __m256d nlg0 = _mm256_sub_pd(zero,
+                    _mm256_loadu_pd(log_growths + j));
+            const __m256d nlg1 = _mm256_sub_pd(zero,
+                    _mm256_loadu_pd(log_growths + j + 4));
+            const __m256d nlg2 = _mm256_sub_pd(zero,
+                    _mm256_loadu_pd(log_growths + j + 8));
+            const __m256d nlg3 = _mm256_sub_pd(zero,
+                    _mm256_loadu_pd(log_growths + j + 12));
+            __m256d acc0 = _mm256_loadu_pd(present_values + j);
+            __m256d acc1 = _mm256_loadu_pd(present_values + j + 4);
+            __m256d acc2 = _mm256_loadu_pd(present_values + j + 8);
+            __m256d acc3 = _mm256_loadu_pd(present_values + j + 12);
+            for ( std::size_t i = b; i < e; ++i ) {
+                const __m256d a = _mm256_set1_pd(amounts[i]);
+                const __m256d t = _mm256_set1_pd(times[i]);
+                acc0 = _mm256_fmadd_pd(a, exp_pd(_mm256_mul_pd(t, nlg0)),
+                                       acc0);
+                acc1 = _mm256_fmadd_pd(a, exp_pd(_mm256_mul_pd(t, nlg1)),
+                                       acc1);
+                acc2 = _mm256_fmadd_pd(a, exp_pd(_mm256_mul_pd(t, nlg2)),
+                                       acc2);
+                acc3 = _mm256_fmadd_pd(a, exp_pd(_mm256_mul_pd(t, nlg3)),
+                                       acc3);
+            }
+            _mm256_storeu_pd(present_values + j, acc0);
+            _mm256_storeu_pd(present_values + j + 4, acc1);
+            _mm256_storeu_pd(present_values + j + 8, acc2);
+            _mm256_storeu_pd(present_values + j + 12, acc3);
+        }
+        for ( ; j + 4 <= num_rates; j += 4 ) {
+            const __m256d nlg0 = _mm256_sub_pd(_mm256_setzero_pd(),
+                    _mm256_loadu_pd(log_growths + j));
+            __m256d acc0 = _mm256_loadu_pd(present_values + j);
+            for ( std::size_t i = b; i < e; ++i ) {
+                const __m256d a = _mm256_set1_pd(amounts[i]);
+                const __m256d t = _mm256_set1_pd(times[i]);
+                acc0 = _mm256_fmadd_pd(a, exp_pd(_mm256_mul_pd(t, nlg0)),
+                                       acc0);
+            }
+            _mm256_storeu_pd(present_values + j, acc0);
+        }
+        for ( ; j < num_rates; ++j ) {
+            double pv_total = present_values[j];
+            for ( std::size_t i = b; i < e; ++i ) {
+                pv_total += amounts[i] *
+                            kernel_exp(-times[i] * log_growths[j]);
+            }
+            present_values[j] = pv_total;
+        }
+    }
+}
+
+void detail::discount_factors_avx2(const double * rates,
+                                   const double * periods,
+                                   const std::size_t num_rates,
+                                   double * factors) {
+    const __m256d minus_one = _mm256_set1_pd(-1.0);
+    const __m256d no_rate = _mm256_set1_pd(
+            std::numeric_limits<double>::quiet_NaN());
+
+    std::size_t i = 0;
+    for ( ; i + 4 <= num_rates; i += 4 ) {
+        const __m256d r = _mm256_loadu_pd(rates + i);
+        const __m256d t = _mm256_loadu_pd(periods + i);
+        const __m256d df = exp_pd(_mm256_sub_pd(_mm256_setzero_pd(),
+                _mm256_mul_pd(t, log1p_pd(r))));
+        const __m256d valid = _mm256_cmp_pd(r, minus_one, _CMP_GT_OQ);
+        _mm256_storeu_pd(factors + i,
+                         _mm256_blendv_pd(no_rate, df, valid));
+    }
+    discount_factors_scalar(rates + i, periods + i, num_rates - i,
+                            factors + i);
+}
+
+void detail::discount_growths_avx2(const double * rates,
+                                   const double * periods,
+                                   const std::size_t num_rates,
+                                   double * growths) {
+    const __m256d minus_one = _mm256_set1_pd(-1.0);
+    const __m256d no_rate = _mm256_set1_pd(
+            std::numeric_limits<double>::quiet_NaN());
+
+    std::size_t i = 0;
+    for ( ; i + 4 <= num_rates; i += 4 ) {
+        const __m256d r = _mm256_loadu_pd(rates + i);
+        const __m256d t = _mm256_loadu_pd(periods + i);
+        const __m256d g = expm1_pd(_mm256_sub_pd(_mm256_setzero_pd(),
+                _mm256_mul_pd(t, log1p_pd(r))));
+        const __m256d valid = _mm256_cmp_pd(r, minus_one, _CMP_GT_OQ);
+        _mm256_storeu_pd(growths + i,
+                         _mm256_blendv_pd(no_rate, g, valid));
+    }
+    discount_growths_scalar(rates + i, periods + i, num_rates - i,
+                            growths + i);
+}
+
+void detail::exponentials_avx2(const double * args,
+                               const std::size_t num_args,
+                               double * results) {
+    std::size_t i = 0;
+    for ( ; i + 4 <= num_args; i += 4 ) {
+        _mm256_storeu_pd(results + i, exp_pd(_mm256_loadu_pd(args + i)));
+    }
+    exponentials_scalar(args + i, num_args - i, results + i);
+}
+
+#else
+
+bool detail::avx2_compiled() {
+    return false;
+}
+
+double detail::pv_sum_avx2(const double * amounts,
+                           const double * times,
+                           const std::size_t num_cashflows,
+                           const double log_growth) {
+    return pv_sum_scalar(amounts, times, num_cashflows, log_growth);
+}
+
+void detail::pv_sum_multi_avx2(const double * amounts,
+                               const double * times,
+                               const std::size_t num_cashflows,
+                               const double * log_growths,
+                               const std::size_t num_rates,
+                               double * present_values) {
+    pv_sum_multi_scalar(amounts, times, num_cashflows,
+                        log_growths, num_rates, present_values);
+}
+
+void detail::discount_factors_avx2(const double * rates,
+                                   const double * periods,
+                                   const std::size_t num_rates,
+                                   double * factors) {
+    discount_factors_scalar(rates, periods, num_rates, factors);
+}
+
+void detail::discount_growths_avx2(const double * rates,
+                                   const double * periods,
+                                   const std::size_t num_rates,
+                                   double * growths) {
+    discount_growths_scalar(rates, periods, num_rates, growths);
+}
+
+void detail::exponentials_avx2(const double * args,
+                               const std::size_t num_args,
+                               double * results) {
+    exponentials_scalar(args, num_args, results);
+}
+
+#endif
@@ -0,0 +1,340 @@
+/*!
+ * \file        pv_kernels_avx512.cpp
+ * \brief       AVX-512 discounting kernels implementation.
+ * \details     AVX-512 discounting kernels implementation. This file must
+ * be compiled with AVX-512F code generation enabled; if it is not, the
+ * kernels are not compiled in and are never selected.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <limits>
+#include "pv_kernels.h"
+
+using namespace financial;
+using namespace financial::detail;
+
+#if defined(__AVX512F__)
+
+// GCC's AVX-512 headers initialize some intrinsics from deliberately
+// undefined vectors, which draws spurious uninitialized warnings.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+namespace {
+
+//! Calculates the exponential function of eight doubles.
+
+inline __m512d exp_pd(const __m512d x) {
+    using namespace exp_constants;
+
+    const __m512d cx = _mm512_min_pd(_mm512_max_pd(x,
+                _mm512_set1_pd(min_arg)), _mm512_set1_pd(max_arg));
+    const __m512d kd = _mm512_roundscale_pd(
+            _mm512_mul_pd(cx, _mm512_set1_pd(log2e)),
+            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(kd, _mm512_set1_pd(ln2_hi), cx);
+    r = _mm512_fnmadd_pd(kd, _mm512_set1_pd(ln2_lo), r);
+
+    __m512d p = _mm512_set1_pd(poly[0]);
+    for ( int i = 1; i < 14; ++i ) {
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(poly[i]));
+    }
+
+    //  Arguments outside the clamped range overflow or underflow, and
+    //  NaN, which the clamp replaced, is passed through. Scaling
+    //  handles subnormal results directly.
+
+    __m512d result = _mm512_scalef_pd(p, kd);
+    if ( _mm512_cmp_pd_mask(x, cx, _CMP_EQ_OQ) == 0xff ) {
+        return result;
+    }
+    result = _mm512_mask_blend_pd(
+            _mm512_cmp_pd_mask(x, _mm512_set1_pd(max_arg), _CMP_GT_OQ),
+            result,
+            _mm512_set1_pd(std::numeric_limits<double>::infinity()));
+    result = _mm512_mask_blend_pd(
+            _mm512_cmp_pd_mask(x, _mm512_set1_pd(min_arg), _CMP_LT_OQ),
+            result, _mm512_setzero_pd());
+    return _mm512_mask_blend_pd(_mm512_cmp_pd_mask(x, x, _CMP_UNORD_Q),
+                                result, x);
+}
+
+
+//! Calculates exp(x) - 1 of eight doubles.
+
+inline __m512d expm1_pd(const __m512d x) {
+    using namespace exp_constants;
+
+    const __m512d limit = _mm512_set1_pd(expm1_limit);
+    const __m512d cx = _mm512_min_pd(_mm512_max_pd(x,
+                _mm512_sub_pd(_mm512_setzero_pd(), limit)), limit);
+    const __m512d kd = _mm512_roundscale_pd(
+            _mm512_mul_pd(cx, _mm512_set1_pd(log2e)),
+            _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_fnmadd_pd(kd, _mm512_set1_pd(ln2_hi), cx);
+    r = _mm512_fnmadd_pd(kd, _mm512_set1_pd(ln2_lo), r);
+
+    __m512d p = _mm512_set1_pd(poly[0]);
+    for ( int i = 1; i < 13; ++i ) {
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(poly[i]));
+    }
+    const __m512d q = _mm512_mul_pd(p, r);
+
+    //  2 ** k - 1 is exact for |k| within the limit.
+
+    const __m512d two_k = _mm512_scalef_pd(_mm512_set1_pd(1.0), kd);
+    const __m512d result = _mm512_fmadd_pd(q, two_k,
+            _mm512_sub_pd(two_k, _mm512_set1_pd(1.0)));
+
+    const __mmask8 in_range = _mm512_cmp_pd_mask(x, cx, _CMP_EQ_OQ);
+    if ( in_range == 0xff ) {
+        return result;
+    }
+    return _mm512_mask_blend_pd(in_range,
+            _mm512_sub_pd(exp_pd(x), _mm512_set1_pd(1.0)), result);
+}
+
+
+//! Calculates log(1 + x) of eight doubles, each greater than -1.
+
+inline __m512d log1p_pd(const __m512d x) {
+    using namespace log_constants;
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d u = _mm512_add_pd(one, x);
+
+    __m512d m = _mm512_getmant_pd(u, _MM_MANT_NORM_1_2, _MM_MANT_SIGN_src);
+    __m512d e = _mm512_getexp_pd(u);
+    const __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(sqrt2),
+                                            _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+    e = _mm512_mask_add_pd(e, big, e, one);
+
+    const __m512d s = _mm512_div_pd(_mm512_sub_pd(m, one),
+                                    _mm512_add_pd(m, one));
+    const __m512d z = _mm512_mul_pd(s, s);
+    __m512d p = _mm512_set1_pd(poly[0]);
+    for ( int i = 1; i < 12; ++i ) {
+        p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(poly[i]));
+    }
+
+    const __m512d correction = _mm512_div_pd(
+            _mm512_sub_pd(x, _mm512_sub_pd(u, one)), u);
+    const __m512d lo = _mm512_fmadd_pd(e,
+            _mm512_set1_pd(exp_constants::ln2_lo), correction);
+    return _mm512_fmadd_pd(e, _mm512_set1_pd(exp_constants::ln2_hi),
+                           _mm512_fmadd_pd(_mm512_add_pd(s, s), p, lo));
+}
+
+}           //  namespace
+
+
+bool detail::avx512_compiled() {
+    return true;
+}
+
+double detail::pv_sum_avx512(const double * amounts,
+                             const double * times,
+                             const std::size_t num_cashflows,
+                             const double log_growth) {
+    const __m512d neg_lg = _mm512_set1_pd(-log_growth);
+    __m512d acc0 = _mm512_setzero_pd();
+    __m512d acc1 = _mm512_setzero_pd();
+
+    std::size_t i = 0;
+    for ( ; i + 16 <= num_cashflows; i += 16 ) {
+        const __m512d t0 = _mm512_loadu_pd(times + i);
+        const __m512d t1 = _mm512_loadu_pd(times + i + 8);
+        const __m512d df0 = exp_pd(_mm512_mul_pd(t0, neg_lg));
+        const __m512d df1 = exp_pd(_mm512_mul_pd(t1, neg_lg));
+        acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(amounts + i), df0, acc0);
+        acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(amounts + i + 8), df1, acc1);
+    }
+    if ( i < num_cashflows ) {
+        const __mmask8 m0 = static_cast<__mmask8>(
+                num_cashflows - i >= 8 ? 0xff :
+                (1u << (num_cashflows - i)) - 1);
+        const __m512d t0 = _mm512_maskz_loadu_pd(m0, times + i);
+        const __m512d df0 = exp_pd(_mm512_mul_pd(t0, neg_lg));
+        acc0 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m0, amounts + i),
+                               df0, acc0);
+        i += 8;
+        if ( i < num_cashflows ) {
+            const __mmask8 m1 = static_cast<__mmask8>(
+                    (1u << (num_cashflows - i)) - 1);
+            const __m512d t1 = _mm512_maskz_loadu_pd(m1, times + i);
+            const __m512d df1 = exp_pd(_mm512_mul_pd(t1, neg_lg));
+            acc1 = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(m1, amounts + i),
+                                   df1, acc1);
+        }
+    }
+
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1));
+}
+
+void detail::pv_sum_multi_avx512(const double * amounts,
+                                 const double * times,
+                                 const std::size_t num_cashflows,
+                                 const double * log_growths,
+                                 const std::size_t num_rates,
+                                 double * present_values) {
+    std::fill(present_values, present_values + num_rates, 0.0);
+    for ( std::size_t b = 0; b < num_cashflows; b += multi_block_size ) {
+        const std::size_t e = std::min(num_cashflows, b + multi_block_size);
+
+        std::size_t j = 0;
+        for ( ; j + 32 <= num_rates; j += 32 ) {
+            const __m512d zero = _mm512_setzero_pd();
+            const __m512d nlg0 = _mm512_sub_pd(zero,
+                    _mm512_loadu_pd(log_growths + j));
+            const __m512d nlg1 = _mm512_sub_pd(zero,
+                    _mm512_loadu_pd(log_growths + j + 8));
+            const __m512d nlg2 = _mm512_sub_pd(zero,
+                    _mm512_loadu_pd(log_growths + j + 16));
+            const __m512d nlg3 = _mm512_sub_pd(zero,
+                    _mm512_loadu_pd(log_growths + j + 24));
+            __m512d acc0 = _mm512_loadu_pd(present_values + j);
+            __m512d acc1 = _mm512_loadu_pd(present_values + j + 8);
+            __m512d acc2 = _mm512_loadu_pd(present_values + j + 16);
+            __m512d acc3 = _mm512_loadu_pd(present_values + j + 24);
+            for ( std::size_t i = b; i < e; ++i ) {
+                const __m512d a = _mm512_set1_pd(amounts[i]);
+                const __m512d t = _mm512_set1_pd(times[i]);
+                acc0 = _mm512_fmadd_pd(a, exp_pd(_mm512_mul_pd(t, nlg0)),
+                                       acc0);
+                acc1 = _mm512_fmadd_pd(a, exp_pd(_mm512_mul_pd(t, nlg1)),
+                                       acc1);
+                acc2 = _mm512_fmadd_pd(a, exp_pd(_mm512_mul_pd(t, nlg2)),
+                                       acc2);
+                acc3 = _mm512_fmadd_pd(a, exp_pd(_mm512_mul_pd(t, nlg3)),
+                                       acc3);
+            }
+            _mm512_storeu_pd(present_values + j, acc0);
+            _mm512_storeu_pd(present_values + j + 8, acc1);
+            _mm512_storeu_pd(present_values + j + 16, acc2);
+            _mm512_storeu_pd(present_values + j + 24, acc3);
+        }
+        for ( ; j < num_rates; j += 8 ) {
+            const __mmask8 m = static_cast<__mmask8>(
+                    num_rates - j >= 8 ? 0xff :
+                    (1u << (num_rates - j)) - 1);
+            const __m512d nlg0 = _mm512_sub_pd(_mm512_setzero_pd(),
+                    _mm512_maskz_loadu_pd(m, log_growths + j));
+            __m512d acc0 = _mm512_maskz_loadu_pd(m, present_values + j);
+            for ( std::size_t i = b; i < e; ++i ) {
+                const __m512d a = _mm512_set1_pd(amounts[i]);
+                const __m512d t = _mm512_set1_pd(times[i]);
+                acc0 = _mm512_fmadd_pd(a, exp_pd(_mm512_mul_pd(t, nlg0)),
+                                       acc0);
+            }
+            _mm512_mask_storeu_pd(present_values + j, m, acc0);
+        }
+    }
+}
+
+void detail::discount_factors_avx512(const double * rates,
+                                     const double * periods,
+                                     const std::size_t num_rates,
+                                     double * factors) {
+    const __m512d minus_one = _mm512_set1_pd(-1.0);
+    const __m512d no_rate = _mm512_set1_pd(
+            std::numeric_limits<double>::quiet_NaN());
+
+    for ( std::size_t i = 0; i < num_rates; i += 8 ) {
+        const __mmask8 m = static_cast<__mmask8>(
+                num_rates - i >= 8 ? 0xff : (1u << (num_rates - i)) - 1);
+        const __m512d r = _mm512_maskz_loadu_pd(m, rates + i);
+        const __m512d t = _mm512_maskz_loadu_pd(m, periods + i);
+        const __m512d df = exp_pd(_mm512_sub_pd(_mm512_setzero_pd(),
+                _mm512_mul_pd(t, log1p_pd(r))));
+        const __mmask8 valid = _mm512_cmp_pd_mask(r, minus_one,
+                                                  _CMP_GT_OQ);
+        _mm512_mask_storeu_pd(factors + i, m,
+                              _mm512_mask_blend_pd(valid, no_rate, df));
+    }
+}
+
+void detail::discount_growths_avx512(const double * rates,
+                                     const double * periods,
+                                     const std::size_t num_rates,
+                                     double * growths) {
+    const __m512d minus_one = _mm512_set1_pd(-1.0);
+    const __m512d no_rate = _mm512_set1_pd(
+            std::numeric_limits<double>::quiet_NaN());
+
+    for ( std::size_t i = 0; i < num_rates; i += 8 ) {
+        const __mmask8 m = static_cast<__mmask8>(
+                num_rates - i >= 8 ? 0xff : (1u << (num_rates - i)) - 1);
+        const __m512d r = _mm512_maskz_loadu_pd(m, rates + i);
+        const __m512d t = _mm512_maskz_loadu_pd(m, periods + i);
+        const __m512d g = expm1_pd(_mm512_sub_pd(_mm512_setzero_pd(),
+                _mm512_mul_pd(t, log1p_pd(r))));
+        const __mmask8 valid = _mm512_cmp_pd_mask(r, minus_one,
+                                                  _CMP_GT_OQ);
+        _mm512_mask_storeu_pd(growths + i, m,
+                              _mm512_mask_blend_pd(valid, no_rate, g));
+    }
+}
+
+void detail::exponentials_avx512(const double * args,
+                                 const std::size_t num_args,
+                                 double * results) {
+    for ( std::size_t i = 0; i < num_args; i += 8 ) {
+        const __mmask8 m = static_cast<__mmask8>(
+                num_args - i >= 8 ? 0xff : (1u << (num_args - i)) - 1);
+        _mm512_mask_storeu_pd(results + i, m,
+                              exp_pd(_mm512_maskz_loadu_pd(m, args + i)));
+    }
+}
+
+#else
+
+bool detail::avx512_compiled() {
+    return false;
+}
+
+double detail::pv_sum_avx512(const double * amounts,
+                             const double * times,
+                             const std::size_t num_cashflows,
+                             const double log_growth) {
+    return pv_sum_scalar(amounts, times, num_cashflows, log_growth);
+}
+
+void detail::pv_sum_multi_avx512(const double * amounts,
+                                 const double * times,
+                                 const std::size_t num_cashflows,
+                                 const double * log_growths,
+                                 const std::size_t num_rates,
+                                 double * present_values) {
+    pv_sum_multi_scalar(amounts, times, num_cashflows,
+                        log_growths, num_rates, present_values);
+}
+
+void detail::discount_factors_avx512(const double * rates,
+                                     const double * periods,
+                                     const std::size_t num_rates,
+                                     double * factors) {
+    discount_factors_scalar(rates, periods, num_rates, factors);
+}
+
+void detail::discount_growths_avx512(const double * rates,
+                                     const double * periods,
+                                     const std::size_t num_rates,
+                                     double * growths) {
+    discount_growths_scalar(rates, periods, num_rates, growths);
+}
+
+void detail::exponentials_avx512(const double * args,
+                                 const std::size_t num_args,
+                                 double * results) {
+    exponentials_scalar(args, num_args, results);
+}
+
+#endif
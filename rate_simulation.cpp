@@ -0,0 +1,251 @@
+/*!
+ * \file        rate_simulation.cpp
+ * \brief       Monte Carlo interest rate simulation implementation.
+ * \details     Monte Carlo interest rate simulation implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include <stdint.h>
+#include "cashflow_schedule.h"
+#include "philox.h"
+#include "pv_kernels.h"
+#include "thread_pool.h"
+#include "yield_curve.h"
+#include "rate_simulation.h"
+
+using namespace financial;
+
+const std::size_t RateSimulation::chunk_size;
+
+namespace {
+
+//! Number of cash flows discounted by each kernel call.
+
+const std::size_t block_size = 256;
+
+//! Checks the parameters common to both models.
+
+void check_model(const double mean_reversion, const double volatility) {
+    if ( !(mean_reversion > 0) ) {
+        throw std::domain_error("Short rate mean reversion must be "
+                                "positive");
+    }
+    if ( !(volatility >= 0) ) {
+        throw std::domain_error("Short rate volatility must not be "
+                                "negative");
+    }
+}
+
+}           //  namespace
+
+ShortRateModel::ShortRateModel(const double initial_rate,
+                               const double mean_reversion,
+                               const double long_run_rate,
+                               const double volatility) :
+    m_mean_reversion(mean_reversion),
+    m_volatility(volatility),
+    m_initial_rate(initial_rate),
+    m_long_run_rate(long_run_rate),
+    m_curve() {
+    check_model(mean_reversion, volatility);
+}
+
+ShortRateModel::ShortRateModel(const YieldCurve& curve,
+                               const double mean_reversion,
+                               const double volatility) :
+    m_mean_reversion(mean_reversion),
+    m_volatility(volatility),
+    m_initial_rate(0),
+    m_long_run_rate(0),
+    m_curve(new YieldCurve(curve)) {
+    check_model(mean_reversion, volatility);
+}
+
+double ShortRateModel::integrated_drift(const double start,
+                                        const double end) const {
+    const double a = m_mean_reversion;
+    const double decay_start = std::exp(-a * start);
+    const double decay_end = std::exp(-a * end);
+
+    if ( !m_curve ) {
+        return m_long_run_rate * (end - start) +
+               (m_initial_rate - m_long_run_rate) *
+               (decay_start - decay_end) / a;
+    }
+
+    //  The integral of the forward rate is the change in -log(DF), and
+    //  the convexity term integrates in closed form.
+
+    const double convexity = (end - start) +
+                             2 * (decay_end - decay_start) / a -
+                             (decay_end * decay_end -
+                              decay_start * decay_start) / (2 * a);
+    return m_curve->log_discount(end) - m_curve->log_discount(start) +
+           m_volatility * m_volatility / (2 * a * a) * convexity;
+}
+
+double PvDistribution::quantile(const double probability) const {
+    if ( values.empty() ) {
+        throw std::domain_error("Distribution has no values");
+    }
+    if ( !(probability >= 0 && probability <= 1) ) {
+        throw std::domain_error("Quantile probability must be between "
+                                "zero and one");
+    }
+
+    std::vector<double> sorted(values);
+    const double rank = std::ceil(probability * sorted.size());
+    const std::size_t index = ( rank > 1 ) ?
+                              static_cast<std::size_t>(rank) - 1 : 0;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+RateSimulation::RateSimulation(const ShortRateModel& model,
+                               const double horizon,
+                               const int steps_per_period,
+                               const std::size_t num_paths,
+                               const uint64_t seed) :
+    m_step(0), m_decay(0), m_shock(0), m_num_paths(num_paths),
+    m_seed(seed), m_drift() {
+    if ( !(horizon > 0) || steps_per_period <= 0 || num_paths == 0 ) {
+        throw std::domain_error("Simulation horizon, steps and paths must "
+                                "be positive");
+    }
+
+    m_step = 1.0 / steps_per_period;
+    const double a = model.mean_reversion();
+    const double sigma = model.volatility();
+    m_decay = std::exp(-a * m_step);
+    m_shock = sigma * std::sqrt(-std::expm1(-2 * a * m_step) / (2 * a));
+
+    const std::size_t num_steps = static_cast<std::size_t>(
+            std::ceil(horizon * steps_per_period - 1e-9));
+    m_drift.resize(num_steps);
+    for ( std::size_t k = 0; k < num_steps; ++k ) {
+        m_drift[k] = model.integrated_drift(k * m_step, (k + 1) * m_step);
+    }
+}
+
+void RateSimulation::path_log_discounts(const std::size_t path,
+                                        double * log_discounts) const {
+    const Philox4x32 rng(m_seed);
+    const uint32_t path_lo = static_cast<uint32_t>(path);
+    const uint32_t path_hi = static_cast<uint32_t>(
+            static_cast<uint64_t>(path) >> 32);
+    const double half_step = m_step / 2;
+
+    double normals[2] = {0, 0};
+    double x = 0;
+    double integral = 0;
+    log_discounts[0] = 0;
+    for ( std::size_t k = 0; k < m_drift.size(); ++k ) {
+        if ( k % 2 == 0 ) {
+            rng.normals(static_cast<uint32_t>(k / 2), 0, path_lo, path_hi,
+                        normals);
+        }
+        const double next = x * m_decay + m_shock * normals[k % 2];
+        integral += m_drift[k] + half_step * (x + next);
+        log_discounts[k + 1] = integral;
+        x = next;
+    }
+}
+
+void RateSimulation::path_discount_factors(const std::size_t path,
+                                           double * discount_factors) const {
+    path_log_discounts(path, discount_factors);
+    for ( std::size_t k = 0; k <= m_drift.size(); ++k ) {
+        discount_factors[k] = std::exp(-discount_factors[k]);
+    }
+}
+
+PvDistribution RateSimulation::pv_stream(const CashFlowView& cashflows) const {
+    return run(cashflows, 0);
+}
+
+PvDistribution RateSimulation::pv_stream(const CashFlowView& cashflows,
+                                         ThreadPool& pool) const {
+    return run(cashflows, &pool);
+}
+
+PvDistribution RateSimulation::run(const CashFlowView& cashflows,
+                                   ThreadPool * pool) const {
+
+    //  Locate each cash flow on the grid once, for all the paths.
+
+    const std::size_t num_cashflows = cashflows.size();
+    const std::size_t num_steps = m_drift.size();
+    std::vector<std::size_t> indices(num_cashflows);
+    std::vector<double> weights(num_cashflows);
+    for ( std::size_t i = 0; i < num_cashflows; ++i ) {
+        const double position = cashflows.times()[i] / m_step;
+        if ( !(position >= 0 && position <= num_steps + 1e-9) ) {
+            throw std::domain_error("Cash flow is outside the simulation "
+                                    "grid");
+        }
+        const std::size_t index = std::min(
+                static_cast<std::size_t>(position), num_steps - 1);
+        indices[i] = index;
+        weights[i] = position - index;
+    }
+
+    PvDistribution dist;
+    dist.values.resize(m_num_paths);
+    const std::size_t num_chunks = (m_num_paths + chunk_size - 1) /
+                                   chunk_size;
+    for_each_chunk(pool, num_chunks, [&](const std::size_t chunk) {
+        std::vector<double> log_discounts(num_steps + 1);
+        double exponents[block_size];
+        const std::size_t begin = chunk * chunk_size;
+        const std::size_t end = std::min(begin + chunk_size, m_num_paths);
+        for ( std::size_t path = begin; path < end; ++path ) {
+            path_log_discounts(path, log_discounts.data());
+            double pv = 0;
+            for ( std::size_t b = 0; b < num_cashflows; b += block_size ) {
+                const std::size_t n = std::min(block_size,
+                                               num_cashflows - b);
+                for ( std::size_t i = 0; i < n; ++i ) {
+                    const std::size_t k = indices[b + i];
+                    const double lo = log_discounts[k];
+                    exponents[i] = lo + weights[b + i] *
+                                   (log_discounts[k + 1] - lo);
+                }
+                pv += detail::pv_sum(cashflows.amounts() + b, exponents,
+                                     n, 1.0);
+            }
+            dist.values[path] = pv;
+        }
+    });
+
+    //  Summarize serially, in path order, so the statistics do not
+    //  depend on the number of threads.
+
+    double sum = 0;
+    dist.min = dist.values[0];
+    dist.max = dist.values[0];
+    for ( std::size_t p = 0; p < m_num_paths; ++p ) {
+        sum += dist.values[p];
+        dist.min = std::min(dist.min, dist.values[p]);
+        dist.max = std::max(dist.max, dist.values[p]);
+    }
+    dist.mean = sum / m_num_paths;
+
+    double sum_sq = 0;
+    for ( std::size_t p = 0; p < m_num_paths; ++p ) {
+        const double diff = dist.values[p] - dist.mean;
+        sum_sq += diff * diff;
+    }
+    dist.std_dev = ( m_num_paths > 1 ) ?
+                   std::sqrt(sum_sq / (m_num_paths - 1)) : 0;
+    dist.std_error = dist.std_dev / std::sqrt(m_num_paths);
+
+    return dist;
+}
@@ -0,0 +1,273 @@
+/*!
+ * \file        rate_simulation.h
+ * \brief       Monte Carlo interest rate simulation interface.
+ * \details     Short rate models, and a Monte Carlo engine which values
+ * cash flows under simulated interest rate paths.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_RATE_SIMULATION_H
+#define PG_FINANCIAL_RATE_SIMULATION_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <stdint.h>
+#include "cashflow_schedule.h"
+#include "thread_pool.h"
+#include "yield_curve.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! One-factor Gaussian short rate model class.
+
+/*!
+ * Models the instantaneous short rate, per period, as `r(t) = x(t) +
+ * phi(t)`, where `x` is an Ornstein-Uhlenbeck process with `x(0) = 0`,
+ * `dx = -a * x * dt + sigma * dW`, and `phi` is a deterministic drift.
+ *
+ * In the Vasicek model, `phi(t) = b + (r0 - b) * exp(-a * t)`, so the
+ * short rate starts at `r0` and reverts to the long run rate `b`.
+ *
+ * In the Hull-White model, `phi` is chosen so that the expected
+ * discount factor for every time equals that of an initial yield curve,
+ * `phi(t) = f(0, t) + sigma^2 / (2 * a^2) * (1 - exp(-a * t))^2`, where
+ * `f(0, t)` is the curve's instantaneous forward rate.
+ */
+
+class ShortRateModel {
+    public:
+
+        //! Creates a Vasicek model.
+
+        /*!
+         * \param initial_rate the short rate at time zero.
+         * \param mean_reversion the speed of mean reversion, per period.
+         * \param long_run_rate the rate the short rate reverts to.
+         * \param volatility the volatility of the short rate.
+         * \throws std::domain_error if `mean_reversion` is not positive
+         * or `volatility` is negative.
+         */
+
+        ShortRateModel(const double initial_rate,
+                       const double mean_reversion,
+                       const double long_run_rate,
+                       const double volatility);
+
+
+        //! Creates a Hull-White model fitted to a yield curve.
+
+        /*!
+         * \param curve the initial yield curve.
+         * \param mean_reversion the speed of mean reversion, per period.
+         * \param volatility the volatility of the short rate.
+         * \throws std::domain_error if `mean_reversion` is not positive
+         * or `volatility` is negative.
+         */
+
+        ShortRateModel(const YieldCurve& curve,
+                       const double mean_reversion,
+                       const double volatility);
+
+
+        //! Returns the speed of mean reversion.
+
+        double mean_reversion() const { return m_mean_reversion; }
+
+
+        //! Returns the volatility of the short rate.
+
+        double volatility() const { return m_volatility; }
+
+
+        //! Returns the integral of the drift `phi` over an interval.
+
+        /*!
+         * \param start the start of the interval, in periods.
+         * \param end the end of the interval, in periods.
+         * \return the integral of `phi(t)` from `start` to `end`.
+         */
+
+        double integrated_drift(const double start, const double end) const;
+
+
+    private:
+        double m_mean_reversion;    /*!< speed of mean reversion */
+        double m_volatility;        /*!< short rate volatility */
+        double m_initial_rate;      /*!< Vasicek initial rate */
+        double m_long_run_rate;     /*!< Vasicek long run rate */
+        std::shared_ptr<const YieldCurve> m_curve;  /*!< Hull-White curve,
+                                                         or null */
+};
+
+
+//! Distribution of present values across simulated paths.
+
+struct PvDistribution {
+
+    //! Default constructor
+
+    PvDistribution() : values(), mean(0), std_dev(0), std_error(0),
+                       min(0), max(0) {}
+
+    std::vector<double> values; /*!< the present value on each path */
+    double mean;                /*!< the mean present value */
+    double std_dev;             /*!< the standard deviation */
+    double std_error;           /*!< the standard error of the mean */
+    double min;                 /*!< the smallest present value */
+    double max;                 /*!< the largest present value */
+
+
+    //! Returns a quantile of the present values.
+
+    /*!
+     * \param probability the probability, from zero to one.
+     * \return the smallest present value such that at least a fraction
+     * `probability` of the paths have a value no greater than it.
+     * \throws std::domain_error if there are no paths, or
+     * `probability` is outside `[0, 1]`.
+     */
+
+    double quantile(const double probability) const;
+};
+
+
+//! Monte Carlo interest rate simulation class.
+
+/*!
+ * Simulates paths of a short rate model on a uniform time grid, and
+ * values streams of cash flows by discounting them along each path.
+ *
+ * The Ornstein-Uhlenbeck factor is stepped exactly, and its integral is
+ * taken by the trapezoidal rule, while the drift is integrated exactly,
+ * giving a discount factor at each grid time. Cash flows between grid
+ * times are discounted log-linearly between them. The discount factors
+ * of each block of cash flows are evaluated with the same SIMD kernels
+ * as `pv_stream()`.
+ *
+ * The normal deviates for each path are drawn from a `Philox4x32`
+ * generator whose counters are the path number and the step number,
+ * so each path is reproducible on its own, and the results depend only
+ * on the seed and not on the number of threads. Paths are shared among
+ * the threads of a `ThreadPool` in fixed-size chunks, with no shared
+ * state but the output array, so throughput scales with the number of
+ * cores.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * const financial::ShortRateModel model(curve, 0.1, 0.01);
+ * const financial::RateSimulation sim(model, 30, 12, 50000, 42);
+ * financial::ThreadPool pool;
+ * const financial::PvDistribution dist = sim.pv_stream(sched, pool);
+ * double var_99 = dist.mean - dist.quantile(0.01);
+ * ~~~~
+ */
+
+class RateSimulation {
+    public:
+
+        //! Number of paths in each chunk of work.
+
+        static const std::size_t chunk_size = 256;
+
+
+        //! Constructor
+
+        /*!
+         * \param model the short rate model.
+         * \param horizon the time of the end of the grid, in periods.
+         * \param steps_per_period the number of grid steps per period.
+         * \param num_paths the number of paths to simulate.
+         * \param seed the seed of the random number generator.
+         * \throws std::domain_error if `horizon`, `steps_per_period` or
+         * `num_paths` is not positive.
+         */
+
+        RateSimulation(const ShortRateModel& model,
+                       const double horizon,
+                       const int steps_per_period,
+                       const std::size_t num_paths,
+                       const uint64_t seed);
+
+
+        //! Returns the number of paths.
+
+        std::size_t num_paths() const { return m_num_paths; }
+
+
+        //! Returns the number of grid steps.
+
+        std::size_t num_steps() const { return m_drift.size(); }
+
+
+        //! Returns the length of each grid step, in periods.
+
+        double step() const { return m_step; }
+
+
+        //! Calculates the discount factors along one path.
+
+        /*!
+         * \param path the path number.
+         * \param discount_factors an array of `num_steps() + 1` doubles
+         * to receive the discount factor at each grid time, starting
+         * with time zero.
+         */
+
+        void path_discount_factors(const std::size_t path,
+                                   double * discount_factors) const;
+
+
+        //! Values cash flows on every path.
+
+        /*!
+         * \param cashflows the cash flows, as a schedule or a view, with
+         * time periods from zero to the horizon.
+         * \return the distribution of the present values.
+         * \throws std::domain_error if a cash flow is outside the grid.
+         */
+
+        PvDistribution pv_stream(const CashFlowView& cashflows) const;
+
+
+        //! Values cash flows on every path in parallel.
+
+        /*!
+         * \param cashflows the cash flows, as a schedule or a view, with
+         * time periods from zero to the horizon.
+         * \param pool the thread pool to run the paths on.
+         * \return the distribution of the present values, identical to
+         * that returned by the single threaded overload.
+         * \throws std::domain_error if a cash flow is outside the grid.
+         */
+
+        PvDistribution pv_stream(const CashFlowView& cashflows,
+                                 ThreadPool& pool) const;
+
+
+    private:
+
+        //! Calculates `-log` of the discount factors along one path.
+        void path_log_discounts(const std::size_t path,
+                                double * log_discounts) const;
+
+        //! Values cash flows, with or without a thread pool.
+        PvDistribution run(const CashFlowView& cashflows,
+                           ThreadPool * pool) const;
+
+        double m_step;                  /*!< grid step, in periods */
+        double m_decay;                 /*!< exp(-a * step) */
+        double m_shock;                 /*!< standard deviation of x step */
+        std::size_t m_num_paths;        /*!< number of paths */
+        uint64_t m_seed;                /*!< random number seed */
+        std::vector<double> m_drift;    /*!< integrated drift per step */
+};
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_RATE_SIMULATION_H
@@ -0,0 +1,64 @@
+/*
+ *  alloc_counter.cpp
+ *  =================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Heap allocation counter for unit tests. Replaces the global
+ *  operator new and operator delete for the whole test executable.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "alloc_counter.h"
+
+namespace {
+
+std::atomic<std::size_t> allocation_count(0);
+std::atomic<bool> fail_next(false);
+
+}           //  namespace
+
+std::size_t alloc_counter::allocations() {
+    return allocation_count.load();
+}
+
+void alloc_counter::fail_next_allocation() {
+    fail_next.store(true);
+}
+
+void * operator new(std::size_t size) {
+    ++allocation_count;
+    if ( fail_next.exchange(false) ) {
+        throw std::bad_alloc();
+    }
+    void * p = std::malloc(size ? size : 1);
+    if ( !p ) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void * operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void * p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void * p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void * p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void * p, std::size_t) noexcept {
+    std::free(p);
+}
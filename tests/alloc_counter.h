@@ -0,0 +1,30 @@
+/*
+ *  alloc_counter.h
+ *  ===============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Interface to heap allocation counter for unit tests.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#ifndef PG_FINANCIAL_TESTS_ALLOC_COUNTER_H
+#define PG_FINANCIAL_TESTS_ALLOC_COUNTER_H
+
+#include <cstddef>
+
+namespace alloc_counter {
+
+//  Returns the number of calls to global operator new so far.
+
+std::size_t allocations();
+
+//  Makes the next call to global operator new throw std::bad_alloc.
+
+void fail_next_allocation();
+
+}               //  namespace alloc_counter
+
+#endif          //  PG_FINANCIAL_TESTS_ALLOC_COUNTER_H
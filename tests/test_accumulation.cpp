@@ -0,0 +1,180 @@
+/*
+ *  test_accumulation.cpp
+ *  =====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Unit tests for summation policies and the pv_stream() templates.
+ *
+ *  Uses Boost unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../accumulation.h"
+#include "../basic_dcf.h"
+#include "../cashflow_schedule.h"
+#include "../thread_pool.h"
+
+namespace {
+
+//  Returns a stream of mixed sign cash flows which largely cancel.
+
+std::vector<financial::TimedCashFlow> make_cancelling(const int n) {
+    std::vector<financial::TimedCashFlow> cashflows;
+    for ( int i = 0; i < n; ++i ) {
+        const double amount = ( i % 2 ? -1 : 1 ) * (1000.0 + i % 7) / 3;
+        cashflows.push_back(financial::TimedCashFlow(amount, 0.01 * i));
+    }
+    return cashflows;
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(accumulation_suite)
+
+BOOST_AUTO_TEST_CASE(accumulation_test1) {
+
+    //  A million tenths, whose sum in extended precision rounds to
+    //  the correctly rounded result.
+
+    const int n = 1000000;
+    const long double exact = static_cast<long double>(0.1) * n;
+    financial::NaiveSum naive;
+    financial::NeumaierSum neumaier;
+    financial::PairwiseSum pairwise;
+    for ( int i = 0; i < n; ++i ) {
+        naive.add(0.1);
+        neumaier.add(0.1);
+        pairwise.add(0.1);
+    }
+    const double naive_error = std::fabs(naive.result() - exact);
+    const double pairwise_error = std::fabs(pairwise.result() - exact);
+    BOOST_CHECK_EQUAL(neumaier.result(), static_cast<double>(exact));
+    BOOST_CHECK(pairwise_error < naive_error / 100);
+    BOOST_CHECK_SMALL(pairwise_error, 1e-9);
+
+    //  Small values between two large ones which cancel are lost by
+    //  naive summation, but not by compensated summation.
+
+    financial::NeumaierSum cancelling;
+    cancelling.add(1e16);
+    for ( int i = 0; i < 1000; ++i ) {
+        cancelling.add(1.0);
+    }
+    cancelling.add(-1e16);
+    BOOST_CHECK_EQUAL(cancelling.result(), 1000);
+    BOOST_CHECK_EQUAL(financial::NeumaierSum().result(), 0);
+    BOOST_CHECK_EQUAL(financial::PairwiseSum().result(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(accumulation_test2) {
+
+    //  Adding an array gives the same result as adding its values one
+    //  at a time, wherever the array falls relative to a block.
+
+    std::vector<double> values;
+    for ( int i = 0; i < 1000; ++i ) {
+        values.push_back(std::sin(i) * 1e6);
+    }
+    const std::size_t splits[] = {0, 1, 31, 32, 33, 500, 999, 1000};
+    for ( int k = 0; k < 8; ++k ) {
+        financial::PairwiseSum by_value;
+        financial::PairwiseSum by_array;
+        financial::NeumaierSum neumaier_by_value;
+        financial::NeumaierSum neumaier_by_array;
+        for ( std::size_t i = 0; i < values.size(); ++i ) {
+            by_value.add(values[i]);
+            neumaier_by_value.add(values[i]);
+        }
+        by_array.add(values.data(), splits[k]);
+        by_array.add(values.data() + splits[k], values.size() - splits[k]);
+        neumaier_by_array.add(values.data(), splits[k]);
+        neumaier_by_array.add(values.data() + splits[k],
+                              values.size() - splits[k]);
+        BOOST_CHECK_EQUAL(by_value.result(), by_array.result());
+        BOOST_CHECK_EQUAL(neumaier_by_value.result(),
+                          neumaier_by_array.result());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(accumulation_pv_stream_test1) {
+
+    //  The naive policy is the existing summation, and the others agree
+    //  with it to within its summation error.
+
+    const double tolerance = 0.0000001;
+    const std::vector<financial::TimedCashFlow> cashflows =
+        make_cancelling(100001);
+    const financial::CashFlowSchedule sched(cashflows);
+
+    BOOST_CHECK_EQUAL(financial::pv_stream<financial::NaiveSum>(cashflows,
+                                                                0.03),
+                      financial::pv_stream(cashflows, 0.03));
+    BOOST_CHECK_EQUAL(financial::pv_stream<financial::NaiveSum>(sched,
+                                                                0.03),
+                      financial::pv_stream(sched, 0.03));
+
+    const double expected_result =
+        financial::pv_stream<financial::NeumaierSum>(cashflows, 0.03);
+    BOOST_CHECK_CLOSE(financial::pv_stream<financial::PairwiseSum>(
+                          cashflows, 0.03), expected_result, tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_stream<financial::NeumaierSum>(
+                          sched, 0.03), expected_result, tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_stream<financial::PairwiseSum>(
+                          sched, 0.03), expected_result, tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_stream<financial::NeumaierSum>(
+                          sched, 0.03, financial::disc_type::continuous),
+                      financial::pv_stream(sched, 0.03,
+                          financial::disc_type::continuous), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(accumulation_pv_stream_test2) {
+
+    //  Cash flows due now are summed exactly by the compensated
+    //  policy.
+
+    financial::CashFlowSchedule sched;
+    sched.add(1e16, 0);
+    for ( int i = 0; i < 1000; ++i ) {
+        sched.add(1.0, 0);
+    }
+    sched.add(-1e16, 0);
+    BOOST_CHECK_EQUAL(financial::pv_stream<financial::NeumaierSum>(sched,
+                                                                   0.05),
+                      1000);
+
+    //  On a thread pool, each policy gives the same result on any
+    //  number of threads.
+
+    const financial::CashFlowSchedule long_sched(make_cancelling(300007));
+    financial::ThreadPool single(1);
+    const double naive_result =
+        financial::pv_stream<financial::NaiveSum>(long_sched, 0.03, single);
+    const double neumaier_result =
+        financial::pv_stream<financial::NeumaierSum>(long_sched, 0.03,
+                                                     single);
+    const double pairwise_result =
+        financial::pv_stream<financial::PairwiseSum>(long_sched, 0.03,
+                                                     single);
+    BOOST_CHECK_EQUAL(naive_result,
+                      financial::pv_stream(long_sched, 0.03, single));
+
+    const unsigned thread_counts[] = {2, 3, 4};
+    for ( int k = 0; k < 3; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        BOOST_CHECK_EQUAL(financial::pv_stream<financial::NaiveSum>(
+                              long_sched, 0.03, pool), naive_result);
+        BOOST_CHECK_EQUAL(financial::pv_stream<financial::NeumaierSum>(
+                              long_sched, 0.03, pool), neumaier_result);
+        BOOST_CHECK_EQUAL(financial::pv_stream<financial::PairwiseSum>(
+                              long_sched, 0.03, pool), pairwise_result);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
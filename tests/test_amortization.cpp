@@ -0,0 +1,144 @@
+/*
+ *  test_amortization.cpp
+ *  =====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for loan amortization schedules.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../amortization.h"
+#include "alloc_counter.h"
+
+BOOST_AUTO_TEST_SUITE(amortization_suite)
+
+BOOST_AUTO_TEST_CASE(amortization_test1) {
+    const double tolerance = 0.000001;
+    const financial::LoanAmortization loan(250000, 0.0035, 360);
+    BOOST_CHECK_CLOSE(financial::loan_repayment(250000, 0.0035, 360),
+                      loan.payment(), tolerance);
+
+    std::vector<financial::AmortizationRow> rows(loan.size());
+    BOOST_CHECK_EQUAL(360U, loan.write(rows.data()));
+
+    double balance = 250000;
+    double total_principal = 0;
+    for ( int i = 0; i < 360; ++i ) {
+        const financial::AmortizationRow& row = rows[i];
+        BOOST_CHECK_EQUAL(i + 1, row.period);
+        BOOST_CHECK_CLOSE(balance * 0.0035, row.interest, tolerance);
+        BOOST_CHECK_CLOSE(row.interest + row.principal, row.payment,
+                          tolerance);
+        balance = row.balance;
+        total_principal += row.principal;
+    }
+    BOOST_CHECK_EQUAL(0, rows.back().balance);
+    BOOST_CHECK_CLOSE(250000, total_principal, tolerance);
+    BOOST_CHECK_CLOSE(loan.payment(), rows.back().payment, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(amortization_test2) {
+
+    //  The buffer, callback and iterator forms agree, and the callback
+    //  and iterator forms do not allocate.
+
+    const financial::LoanAmortization loan(80000, 0.0075, 120);
+    std::vector<financial::AmortizationRow> rows(loan.size());
+    loan.write(rows.data());
+
+    const std::size_t allocations = alloc_counter::allocations();
+
+    std::size_t i = 0;
+    bool callback_matches = true;
+    loan.for_each_row([&](const financial::AmortizationRow& row) {
+        callback_matches = callback_matches &&
+                           row.period == rows[i].period &&
+                           row.balance == rows[i].balance;
+        ++i;
+    });
+
+    std::size_t j = 0;
+    bool iterator_matches = true;
+    for ( financial::LoanAmortization::const_iterator itr = loan.begin();
+          itr != loan.end(); ++itr ) {
+        iterator_matches = iterator_matches &&
+                           itr->period == rows[j].period &&
+                           itr->interest == rows[j].interest;
+        ++j;
+    }
+
+    BOOST_CHECK_EQUAL(allocations, alloc_counter::allocations());
+    BOOST_CHECK_EQUAL(loan.size(), i);
+    BOOST_CHECK_EQUAL(loan.size(), j);
+    BOOST_CHECK(callback_matches);
+    BOOST_CHECK(iterator_matches);
+}
+
+BOOST_AUTO_TEST_CASE(amortization_test3) {
+
+    //  Zero rate, single period and empty schedules.
+
+    const financial::LoanAmortization zero_rate(1200, 0, 12);
+    BOOST_CHECK_EQUAL(100, zero_rate.payment());
+    BOOST_CHECK_EQUAL(0, zero_rate.begin()->interest);
+
+    const financial::LoanAmortization single(1000, 0.05, 1);
+    BOOST_CHECK_CLOSE(1050, single.begin()->payment, 0.000001);
+    BOOST_CHECK_EQUAL(0, single.begin()->balance);
+
+    const financial::LoanAmortization empty(1000, 0.05, 0);
+    BOOST_CHECK(empty.begin() == empty.end());
+
+    BOOST_CHECK_THROW(financial::LoanAmortization(1000, 0.05, -1),
+                      std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(amortization_test4) {
+
+    //  The batched form gives identical results to the single loan form.
+
+    const std::size_t num_loans = 37;
+    const int num_periods = 180;
+    std::vector<double> amounts;
+    std::vector<double> rates;
+    for ( std::size_t i = 0; i < num_loans; ++i ) {
+        amounts.push_back(50000 + 1000 * i);
+        rates.push_back(0.002 + 0.0001 * i);
+    }
+    rates[5] = 0;
+
+    const std::size_t size = num_loans * num_periods;
+    std::vector<double> payments(size);
+    std::vector<double> interest(size);
+    std::vector<double> principal(size);
+    std::vector<double> balances(size);
+    financial::amortize_loans(amounts.data(), rates.data(), num_loans,
+                              num_periods, payments.data(), interest.data(),
+                              principal.data(), balances.data());
+
+    bool matches = true;
+    for ( std::size_t i = 0; i < num_loans; ++i ) {
+        const financial::LoanAmortization loan(amounts[i], rates[i],
+                                               num_periods);
+        loan.for_each_row([&](const financial::AmortizationRow& row) {
+            const std::size_t k = (row.period - 1) * num_loans + i;
+            matches = matches && payments[k] == row.payment &&
+                      interest[k] == row.interest &&
+                      principal[k] == row.principal &&
+                      balances[k] == row.balance;
+        });
+    }
+    BOOST_CHECK(matches);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
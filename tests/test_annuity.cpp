@@ -62,4 +62,16 @@ BOOST_AUTO_TEST_CASE(annuity_due_test2) {
     BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
 }
 
+BOOST_AUTO_TEST_CASE(annuity_small_rate_test) {
+
+    //  Close to a zero rate, the value tends to the sum of the payments,
+    //  less the first order interest n * (n + 1) / 2 * r.
+
+    const double tolerance = 0.0000000001;
+    const double rate = 1e-9;
+    const double expected_result = 100 * (360 - 360 * 361 / 2.0 * rate);
+    const double test_result = financial::pv_annuity(100, rate, 360);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+/*
+ *  test_arena.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for the arena allocator.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../arena.h"
+#include "../bond.h"
+#include "../cashflow_range.h"
+#include "../cashflow_schedule.h"
+#include "alloc_counter.h"
+
+BOOST_AUTO_TEST_SUITE(arena_suite)
+
+BOOST_AUTO_TEST_CASE(arena_test1) {
+
+    //  Allocations are aligned and do not overlap, and the arena grows
+    //  by doubling blocks.
+
+    financial::MonotonicArena arena(256);
+    BOOST_CHECK_EQUAL(0u, arena.capacity());
+    BOOST_CHECK_EQUAL(0u, arena.bytes_used());
+
+    char * a = static_cast<char *>(arena.allocate(3, 1));
+    char * b = static_cast<char *>(arena.allocate(8, 8));
+    char * c = static_cast<char *>(arena.allocate(64, 64));
+    BOOST_CHECK_EQUAL(0u, reinterpret_cast<std::size_t>(b) % 8);
+    BOOST_CHECK_EQUAL(0u, reinterpret_cast<std::size_t>(c) % 64);
+    BOOST_CHECK(a + 3 <= b);
+    BOOST_CHECK(b + 8 <= c);
+    BOOST_CHECK_EQUAL(256u, arena.capacity());
+
+    arena.allocate(200, 8);
+    BOOST_CHECK_EQUAL(256u + 512u, arena.capacity());
+    arena.allocate(1000, 8);
+    BOOST_CHECK_EQUAL(256u + 512u + 1024u, arena.capacity());
+    BOOST_CHECK(arena.bytes_used() >= 3 + 8 + 64 + 200 + 1000);
+
+    //  Releasing coalesces the blocks, so the same allocations then fit
+    //  without touching the heap.
+
+    arena.release();
+    BOOST_CHECK_EQUAL(256u + 512u + 1024u, arena.capacity());
+    BOOST_CHECK_EQUAL(0u, arena.bytes_used());
+    const std::size_t allocations = alloc_counter::allocations();
+    arena.allocate(3, 1);
+    arena.allocate(8, 8);
+    arena.allocate(64, 64);
+    arena.allocate(200, 8);
+    arena.allocate(1000, 8);
+    BOOST_CHECK_EQUAL(allocations, alloc_counter::allocations());
+    arena.release();
+    BOOST_CHECK_EQUAL(256u + 512u + 1024u, arena.capacity());
+}
+
+BOOST_AUTO_TEST_CASE(arena_test2) {
+
+    //  Schedules drawn from an arena value as those on the heap, and
+    //  once the arena has grown, need no heap allocation at all.
+
+    const financial::SimpleBond bond(1000, 0.06, 12, 30);
+    const double expected = financial::pv_stream(bond.schedule(), 0.05);
+
+    financial::MonotonicArena arena(1024);
+    for ( int request = 0; request < 3; ++request ) {
+        const std::size_t allocations = alloc_counter::allocations();
+        const financial::ArenaAllocator<double> alloc(arena);
+        const financial::ArenaCashFlowSchedule sched = bond.schedule(alloc);
+
+        financial::ArenaCashFlowSchedule copy(alloc);
+        copy.reserve(sched.size());
+        for ( std::size_t i = 0; i < sched.size(); ++i ) {
+            copy.add(sched[i].amount, sched[i].time_period);
+        }
+
+        std::vector<financial::TimedCashFlow,
+                    financial::ArenaAllocator<financial::TimedCashFlow> >
+            flows(alloc);
+        flows.reserve(sched.size());
+        for ( std::size_t i = 0; i < sched.size(); ++i ) {
+            flows.push_back(sched[i]);
+        }
+
+        const double sched_pv = financial::pv_stream(sched, 0.05);
+        const double copy_pv = financial::pv_stream(copy, 0.05);
+        const double flows_pv = financial::pv_stream(flows.begin(),
+                                                     flows.end(), 0.05);
+        if ( request > 0 ) {
+            BOOST_CHECK_EQUAL(allocations, alloc_counter::allocations());
+        }
+
+        BOOST_CHECK_EQUAL(expected, sched_pv);
+        BOOST_CHECK_EQUAL(expected, copy_pv);
+        BOOST_CHECK_CLOSE(expected, flows_pv, 0.0000001);
+        BOOST_CHECK(sched.get_allocator() == copy.get_allocator());
+        arena.release();
+    }
+}
+
+BOOST_AUTO_TEST_CASE(arena_test3) {
+
+    //  If release() cannot allocate the coalesced block, the arena is
+    //  left empty, and the next allocation takes a new block rather
+    //  than reusing freed memory.
+
+    financial::MonotonicArena arena(256);
+    arena.allocate(200, 8);
+    arena.allocate(300, 8);
+    BOOST_REQUIRE_EQUAL(256u + 512u, arena.capacity());
+
+    alloc_counter::fail_next_allocation();
+    BOOST_CHECK_THROW(arena.release(), std::bad_alloc);
+    BOOST_CHECK_EQUAL(0u, arena.capacity());
+    BOOST_CHECK_EQUAL(0u, arena.bytes_used());
+
+    const std::size_t allocations = alloc_counter::allocations();
+    arena.allocate(100, 8);
+    BOOST_CHECK_EQUAL(allocations + 1, alloc_counter::allocations());
+    BOOST_CHECK(arena.capacity() >= 100u);
+    BOOST_CHECK_EQUAL(100u, arena.bytes_used());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,383 @@
+/*
+ *  test_batch_dcf.cpp
+ *  ==================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Unit tests for batch discounted cash flow functions.
+ *
+ *  Uses Boost unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../pv_kernels.h"
+#include "../thread_pool.h"
+#include "../batch_dcf.h"
+
+namespace {
+
+//  Columnar inputs for a batch of quotes, with mixed types.
+
+struct Quotes {
+    explicit Quotes(const std::size_t count) :
+        amounts(count), rates(count), periods(count), int_periods(count),
+        types(count) {
+        for ( std::size_t i = 0; i < count; ++i ) {
+            amounts[i] = 1000 + 37 * (i % 101);
+            rates[i] = ( i % 3 == 0 ? -0.0002 : 0.0005 ) * (1 + i % 211);
+            if ( i % 7 == 0 ) {
+
+                //  Small rates, at which the annuity factor is close to
+                //  the number of periods.
+
+                rates[i] *= 1e-6;
+            }
+            int_periods[i] = static_cast<int>(1 + i % 360);
+            periods[i] = int_periods[i];
+            types[i] = ( i % 5 < 2 ) ? financial::annuity_type::due :
+                                       financial::annuity_type::immediate;
+        }
+    }
+
+    std::vector<double> amounts;
+    std::vector<double> rates;
+    std::vector<double> periods;
+    std::vector<int> int_periods;
+    std::vector<financial::annuity_type> types;
+};
+
+//  Returns the difference between two values in units in the last
+//  place of the first.
+
+double ulp_difference(const double expected, const double actual) {
+    const double ulp = std::nextafter(std::fabs(expected), 1e300) -
+                       std::fabs(expected);
+    return std::fabs(expected - actual) / ulp;
+}
+
+//  Returns the number of ulp within which a batch annuity calculation
+//  should agree with the scalar function. Both amplify the rounding of
+//  log1p(r) by about n * log1p(r).
+
+double annuity_ulp_bound(const double rate, const double periods) {
+    return 8 + 4 * std::fabs(periods * std::log1p(rate));
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(batch_dcf_suite)
+
+BOOST_AUTO_TEST_CASE(batch_dcf_factor_test) {
+    const double tolerance = 0.0000001;
+    const std::size_t count = 1000;
+    const Quotes q(count);
+    const financial::disc_type disc_types[] = {
+        financial::disc_type::discrete, financial::disc_type::continuous
+    };
+    financial::ThreadPool pool(4);
+
+    for ( int k = 0; k < 2; ++k ) {
+        const financial::disc_type dt = disc_types[k];
+        std::vector<double> compound_factors(count);
+        std::vector<double> parallel_factors(count);
+        financial::compound_factor(q.rates.data(), q.periods.data(), count,
+                                   compound_factors.data(), dt);
+        financial::compound_factor(q.rates.data(), q.periods.data(), count,
+                                   parallel_factors.data(), pool, dt);
+        BOOST_CHECK(compound_factors == parallel_factors);
+
+        //  Write the discount factors over the periods, which is allowed.
+
+        std::vector<double> discount_factors(q.periods);
+        financial::discount_factor(q.rates.data(), discount_factors.data(),
+                                   count, discount_factors.data(), dt);
+
+        for ( std::size_t i = 0; i < count; ++i ) {
+            BOOST_CHECK_CLOSE(financial::compound_factor(q.rates[i],
+                                                         q.periods[i], dt),
+                              compound_factors[i], tolerance);
+            BOOST_CHECK_CLOSE(financial::discount_factor(q.rates[i],
+                                                         q.periods[i], dt),
+                              discount_factors[i], tolerance);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_annuity_test) {
+    const std::size_t count = 1000;
+    const Quotes q(count);
+
+    std::vector<double> annuities(count);
+    std::vector<double> immediates(count);
+    std::vector<double> perpetuities(count);
+    financial::pv_annuity(q.amounts.data(), q.rates.data(),
+                          q.int_periods.data(), q.types.data(), count,
+                          annuities.data());
+    financial::pv_annuity(q.amounts.data(), q.rates.data(),
+                          q.int_periods.data(), 0, count,
+                          immediates.data());
+    financial::pv_perpetuity(q.amounts.data(), q.rates.data(),
+                             q.types.data(), count, perpetuities.data());
+
+    for ( std::size_t i = 0; i < count; ++i ) {
+        const double bound = annuity_ulp_bound(q.rates[i], q.periods[i]);
+        BOOST_CHECK_LE(ulp_difference(
+                    financial::pv_annuity(q.amounts[i], q.rates[i],
+                                          q.int_periods[i], q.types[i]),
+                    annuities[i]), bound);
+        BOOST_CHECK_LE(ulp_difference(
+                    financial::pv_annuity(q.amounts[i], q.rates[i],
+                                          q.int_periods[i]),
+                    immediates[i]), bound);
+        BOOST_CHECK_LE(ulp_difference(
+                    financial::pv_perpetuity(q.amounts[i], q.rates[i],
+                                             q.types[i]),
+                    perpetuities[i]), 1);
+    }
+
+    //  A very small rate leaves the annuity close to the undiscounted
+    //  total, with no cancellation.
+
+    const double rate = 1e-9;
+    const int periods = 10;
+    const double amount = 100;
+    double annuity = 0;
+    financial::pv_annuity(&amount, &rate, &periods, 0, 1, &annuity);
+    BOOST_CHECK_LE(ulp_difference(financial::pv_annuity(amount, rate,
+                                                        periods),
+                                  annuity), 8);
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_payment_test) {
+    const std::size_t count = 1000;
+    const Quotes q(count);
+
+    std::vector<double> sinking_funds(count);
+    financial::sinking_fund_payment(q.amounts.data(), q.rates.data(),
+                                    q.periods.data(), count,
+                                    sinking_funds.data());
+
+    //  Write the repayments over the rates, which is allowed.
+
+    std::vector<double> repayments(q.rates);
+    financial::loan_repayment(q.amounts.data(), repayments.data(),
+                              q.periods.data(), count, repayments.data());
+
+    for ( std::size_t i = 0; i < count; ++i ) {
+        const double bound = annuity_ulp_bound(q.rates[i], q.periods[i]);
+        BOOST_CHECK_LE(ulp_difference(
+                    financial::sinking_fund_payment(q.amounts[i],
+                                                    q.rates[i],
+                                                    q.periods[i]),
+                    sinking_funds[i]), bound);
+        BOOST_CHECK_LE(ulp_difference(
+                    financial::loan_repayment(q.amounts[i], q.rates[i],
+                                              q.periods[i]),
+                    repayments[i]), bound);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_parallel_test) {
+    const std::size_t count = 3 * financial::batch_chunk_size + 77;
+    const Quotes q(count);
+    financial::ThreadPool pool(4);
+
+    std::vector<double> serial(count);
+    std::vector<double> parallel(count);
+    std::size_t mismatches = 0;
+
+    financial::pv_annuity(q.amounts.data(), q.rates.data(),
+                          q.int_periods.data(), q.types.data(), count,
+                          serial.data());
+    financial::pv_annuity(q.amounts.data(), q.rates.data(),
+                          q.int_periods.data(), q.types.data(), count,
+                          parallel.data(), pool);
+    mismatches += serial != parallel;
+
+    financial::pv_perpetuity(q.amounts.data(), q.rates.data(),
+                             q.types.data(), count, serial.data());
+    financial::pv_perpetuity(q.amounts.data(), q.rates.data(),
+                             q.types.data(), count, parallel.data(), pool);
+    mismatches += serial != parallel;
+
+    financial::sinking_fund_payment(q.amounts.data(), q.rates.data(),
+                                    q.periods.data(), count, serial.data());
+    financial::sinking_fund_payment(q.amounts.data(), q.rates.data(),
+                                    q.periods.data(), count,
+                                    parallel.data(), pool);
+    mismatches += serial != parallel;
+
+    financial::loan_repayment(q.amounts.data(), q.rates.data(),
+                              q.periods.data(), count, serial.data());
+    financial::loan_repayment(q.amounts.data(), q.rates.data(),
+                              q.periods.data(), count, parallel.data(),
+                              pool);
+    mismatches += serial != parallel;
+
+    BOOST_CHECK_EQUAL(mismatches, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_kernels_test) {
+    using namespace financial::detail;
+
+    const simd_isa isas[] = {simd_isa::scalar, simd_isa::avx2,
+                             simd_isa::avx512};
+
+    for ( std::size_t n = 0; n < 20; ++n ) {
+        std::vector<double> rates;
+        std::vector<double> periods;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            rates.push_back(( i == 5 ) ? -1 : 0.013 * i - 0.05);
+            periods.push_back(0.75 * i);
+        }
+
+        for ( int k = 0; k < 3; ++k ) {
+            if ( !isa_available(isas[k]) ) {
+                continue;
+            }
+            std::vector<double> test_results(n + 1, -1);
+            discount_factors(isas[k], rates.data(), periods.data(), n,
+                             test_results.data());
+            for ( std::size_t i = 0; i < n; ++i ) {
+                if ( i == 5 ) {
+                    BOOST_CHECK(std::isnan(test_results[i]));
+                } else {
+                    const double expected_result =
+                        financial::discount_factor(rates[i], periods[i]);
+                    BOOST_CHECK_SMALL(expected_result - test_results[i],
+                                      1e-14 * expected_result);
+                }
+            }
+            BOOST_CHECK_EQUAL(test_results[n], -1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_growths_kernels_test) {
+    using namespace financial::detail;
+
+    const simd_isa isas[] = {simd_isa::scalar, simd_isa::avx2,
+                             simd_isa::avx512};
+
+    for ( std::size_t n = 0; n < 20; ++n ) {
+        std::vector<double> rates;
+        std::vector<double> periods;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            const double magnitude = std::pow(10.0, -12.0 + i % 12);
+            rates.push_back(( i == 5 ) ? -1 :
+                            magnitude * ( i % 2 ? 1 : -0.5 ));
+            periods.push_back(( i == 7 ) ? 40000 : 0.75 * i + 0.5);
+        }
+
+        for ( int k = 0; k < 3; ++k ) {
+            if ( !isa_available(isas[k]) ) {
+                continue;
+            }
+            std::vector<double> test_results(n + 1, -1);
+            discount_growths(isas[k], rates.data(), periods.data(), n,
+                             test_results.data());
+            for ( std::size_t i = 0; i < n; ++i ) {
+                if ( i == 5 ) {
+                    BOOST_CHECK(std::isnan(test_results[i]));
+                } else {
+                    const double x = -periods[i] * std::log1p(rates[i]);
+                    BOOST_CHECK_LE(ulp_difference(std::expm1(x),
+                                                  test_results[i]),
+                                   4 + 2 * std::fabs(x));
+                }
+            }
+            BOOST_CHECK_EQUAL(test_results[n], -1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_expm1_ulp_test) {
+    int failures = 0;
+    for ( double x = 1e-300; x < 800; x *= 1.0137 ) {
+        failures += ulp_difference(std::expm1(x),
+                                   financial::detail::kernel_expm1(x)) > 3;
+        failures += ulp_difference(std::expm1(-x),
+                                   financial::detail::kernel_expm1(-x)) > 3;
+    }
+    BOOST_CHECK_EQUAL(failures, 0);
+    BOOST_CHECK(std::isinf(financial::detail::kernel_expm1(800)));
+    BOOST_CHECK_EQUAL(financial::detail::kernel_expm1(-800), -1);
+    BOOST_CHECK(std::isnan(financial::detail::kernel_expm1(
+                    std::numeric_limits<double>::quiet_NaN())));
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_exponentials_test) {
+    using namespace financial::detail;
+
+    const simd_isa isas[] = {simd_isa::scalar, simd_isa::avx2,
+                             simd_isa::avx512};
+
+    for ( std::size_t n = 0; n < 20; ++n ) {
+        std::vector<double> args;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            args.push_back(1.7 * i - 15);
+        }
+
+        for ( int k = 0; k < 3; ++k ) {
+            if ( !isa_available(isas[k]) ) {
+                continue;
+            }
+            std::vector<double> test_results(n + 1, -1);
+            exponentials(isas[k], args.data(), n, test_results.data());
+            for ( std::size_t i = 0; i < n; ++i ) {
+                const double expected_result = std::exp(args[i]);
+                BOOST_CHECK_SMALL(expected_result - test_results[i],
+                                  4e-16 * expected_result);
+            }
+            BOOST_CHECK_EQUAL(test_results[n], -1);
+        }
+    }
+
+    //  Factors which overflow or underflow do so as the scalar
+    //  functions' do.
+
+    const double rates[] = {1.0, 1.0};
+    const double periods[] = {1100, -1100};
+    double factors[2];
+    financial::compound_factor(rates, periods, 2, factors);
+    for ( int i = 0; i < 2; ++i ) {
+        BOOST_CHECK_EQUAL(factors[i],
+                          financial::compound_factor(rates[i], periods[i]));
+    }
+    BOOST_CHECK(std::isinf(factors[0]));
+    BOOST_CHECK_EQUAL(factors[1], 0);
+}
+
+BOOST_AUTO_TEST_CASE(batch_dcf_log1p_ulp_test) {
+    int failures = 0;
+    for ( double u = 0.001; u < 40; u *= 1.0137 ) {
+        const double x = u - 1;
+        const double expected_result = std::log1p(x);
+        const double test_result = financial::detail::kernel_log1p(x);
+        const double ulp = std::nextafter(std::fabs(expected_result),
+                                          1e300) -
+                           std::fabs(expected_result);
+        if ( std::fabs(expected_result - test_result) > 2 * ulp ) {
+            ++failures;
+        }
+    }
+    for ( double x = 1e-300; x < 1e-3; x *= 7.3 ) {
+        failures += std::fabs(std::log1p(-x) -
+                              financial::detail::kernel_log1p(-x)) >
+                    2e-16 * x;
+        failures += std::fabs(std::log1p(x) -
+                              financial::detail::kernel_log1p(x)) >
+                    2e-16 * x;
+    }
+    BOOST_CHECK_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+/*
+ *  test_bootstrap.cpp
+ *  ==================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for yield curve bootstrapping.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../bond.h"
+#include "../yield_curve.h"
+#include "../bootstrap.h"
+
+namespace {
+
+//  Returns semi-annual bonds maturing in one to thirty years, with
+//  coupons rising with maturity, and a one year zero coupon bond
+//  replacing the shortest.
+
+std::vector<financial::SimpleBond> make_bonds() {
+    std::vector<financial::SimpleBond> bonds;
+    bonds.push_back(financial::SimpleBond(100, 0, 0, 1));
+    for ( int m = 2; m <= 30; ++m ) {
+        bonds.push_back(financial::SimpleBond(100, 0.03 + 0.0005 * m,
+                                              2, m));
+    }
+    return bonds;
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(bootstrap_suite)
+
+BOOST_AUTO_TEST_CASE(bootstrap_test1) {
+
+    //  Bonds priced at a flat rate give a flat curve.
+
+    const double tolerance = 0.0000001;
+    const std::vector<financial::SimpleBond> bonds = make_bonds();
+    std::vector<double> prices;
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        prices.push_back(bonds[i].value(0.05));
+    }
+
+    const financial::CurveBootstrapper bootstrapper(bonds, prices);
+    const financial::YieldCurve& curve = bootstrapper.curve();
+    BOOST_CHECK_EQUAL(bonds.size(), bootstrapper.size());
+    BOOST_CHECK_EQUAL(bonds.size(), curve.size());
+    const double test_times[] = {0.5, 1, 1.5, 7, 12.5, 30};
+    for ( int i = 0; i < 6; ++i ) {
+        BOOST_CHECK_CLOSE(financial::discount_factor(0.05, test_times[i]),
+                          curve.discount_factor(test_times[i]), tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bootstrap_test2) {
+
+    //  The curve reprices every bond at par, whatever order the bonds
+    //  are given in.
+
+    const double tolerance = 0.0000001;
+    std::vector<financial::SimpleBond> bonds = make_bonds();
+    std::vector<financial::SimpleBond> reversed(bonds.rbegin(),
+                                                bonds.rend());
+    std::vector<double> prices(bonds.size(), 100);
+    prices[0] = 96;
+
+    const financial::CurveBootstrapper bootstrapper(bonds, prices);
+    std::vector<double> reversed_prices(prices.rbegin(), prices.rend());
+    const financial::CurveBootstrapper other(reversed, reversed_prices);
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        BOOST_CHECK_CLOSE(prices[i], bonds[i].value(bootstrapper.curve()),
+                          tolerance);
+        BOOST_CHECK_EQUAL(prices[i], bootstrapper.price(i));
+        BOOST_CHECK_CLOSE(bootstrapper.curve().pillar_discount_factor(i),
+                          other.curve().pillar_discount_factor(i),
+                          tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bootstrap_test3) {
+
+    //  Changing one price leaves the earlier pillars exactly as they
+    //  were, and gives the same curve as bootstrapping from scratch.
+
+    const double tolerance = 0.0000001;
+    const std::vector<financial::SimpleBond> bonds = make_bonds();
+    std::vector<double> prices(bonds.size(), 100);
+    prices[0] = 96;
+
+    financial::CurveBootstrapper bootstrapper(bonds, prices);
+    const financial::YieldCurve before = bootstrapper.curve();
+
+    prices[9] = 101.5;
+    BOOST_CHECK_EQUAL(bonds.size() - 9, bootstrapper.set_price(9, 101.5));
+    BOOST_CHECK_EQUAL(101.5, bootstrapper.price(9));
+    const financial::CurveBootstrapper fresh(bonds, prices);
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        if ( i < 9 ) {
+            BOOST_CHECK_EQUAL(before.pillar_discount_factor(i),
+                              bootstrapper.curve().pillar_discount_factor(i));
+        } else {
+            BOOST_CHECK(before.pillar_discount_factor(i) !=
+                        bootstrapper.curve().pillar_discount_factor(i));
+        }
+        BOOST_CHECK_CLOSE(fresh.curve().pillar_discount_factor(i),
+                          bootstrapper.curve().pillar_discount_factor(i),
+                          tolerance);
+        BOOST_CHECK_CLOSE(prices[i], bonds[i].value(bootstrapper.curve()),
+                          tolerance);
+    }
+
+    BOOST_CHECK_EQUAL(1u, bootstrapper.set_price(bonds.size() - 1, 99));
+}
+
+BOOST_AUTO_TEST_CASE(bootstrap_test4) {
+
+    //  Invalid inputs throw, and a price which cannot be repriced
+    //  leaves the curve unchanged.
+
+    const std::vector<financial::SimpleBond> none;
+    const std::vector<double> no_prices;
+    std::vector<financial::SimpleBond> bonds = make_bonds();
+    std::vector<double> prices(bonds.size(), 100);
+    BOOST_CHECK_THROW(financial::CurveBootstrapper(none, no_prices),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::CurveBootstrapper(bonds, no_prices),
+                      std::domain_error);
+
+    std::vector<financial::SimpleBond> duplicated(bonds);
+    duplicated.push_back(bonds[4]);
+    std::vector<double> duplicated_prices(prices);
+    duplicated_prices.push_back(100);
+    BOOST_CHECK_THROW(financial::CurveBootstrapper(duplicated,
+                                                   duplicated_prices),
+                      std::domain_error);
+
+    financial::CurveBootstrapper bootstrapper(bonds, prices);
+    const double df = bootstrapper.curve().pillar_discount_factor(20);
+    BOOST_CHECK_THROW(bootstrapper.set_price(20, 0), std::domain_error);
+    BOOST_CHECK_THROW(bootstrapper.set_price(20, 50), std::domain_error);
+    BOOST_CHECK_EQUAL(100, bootstrapper.price(20));
+    BOOST_CHECK_EQUAL(df, bootstrapper.curve().pillar_discount_factor(20));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+/*
+ *  test_calendar.cpp
+ *  =================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Unit tests for holiday calendars.
+ *
+ *  Uses Boost unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../calendar.h"
+#include "../cashflow_schedule.h"
+#include "../dates.h"
+
+using financial::business_day;
+using financial::Date;
+
+namespace {
+
+//  Returns a calendar with Independence Day and Christmas Day 2013
+//  as holidays.
+
+financial::HolidayCalendar make_calendar() {
+    std::vector<Date> holidays;
+    holidays.push_back(Date(2013, 12, 25));
+    holidays.push_back(Date(2013, 7, 4));
+    return financial::HolidayCalendar(holidays);
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(calendar_suite)
+
+BOOST_AUTO_TEST_CASE(calendar_test1) {
+    const financial::HolidayCalendar cal = make_calendar();
+    BOOST_CHECK(cal.is_business_day(Date(2013, 7, 3)));
+    BOOST_CHECK(!cal.is_business_day(Date(2013, 7, 4)));
+    BOOST_CHECK(!cal.is_business_day(Date(2013, 6, 29)));
+    BOOST_CHECK(!cal.is_business_day(Date(2013, 6, 30)));
+
+    //  Saturday 29 June 2013, whose following business day is in
+    //  July.
+
+    const Date saturday(2013, 6, 29);
+    BOOST_CHECK_EQUAL(cal.adjust(saturday, business_day::unadjusted),
+                      saturday);
+    BOOST_CHECK_EQUAL(cal.adjust(saturday, business_day::following),
+                      Date(2013, 7, 1));
+    BOOST_CHECK_EQUAL(cal.adjust(saturday, business_day::preceding),
+                      Date(2013, 6, 28));
+    BOOST_CHECK_EQUAL(cal.adjust(saturday,
+                                 business_day::modified_following),
+                      Date(2013, 6, 28));
+    BOOST_CHECK_EQUAL(cal.adjust(Date(2013, 6, 3),
+                                 business_day::following),
+                      Date(2013, 6, 3));
+
+    //  Saturday 31 August and Sunday 1 September 2013 are adjusted
+    //  within their months.
+
+    BOOST_CHECK_EQUAL(cal.adjust(Date(2013, 8, 31),
+                                 business_day::modified_following),
+                      Date(2013, 8, 30));
+    BOOST_CHECK_EQUAL(cal.adjust(Date(2013, 9, 1),
+                                 business_day::modified_preceding),
+                      Date(2013, 9, 2));
+}
+
+BOOST_AUTO_TEST_CASE(calendar_test2) {
+    const financial::HolidayCalendar cal = make_calendar();
+    BOOST_CHECK_EQUAL(cal.add_business_days(Date(2013, 7, 3), 1),
+                      Date(2013, 7, 5));
+    BOOST_CHECK_EQUAL(cal.add_business_days(Date(2013, 7, 4), 1),
+                      Date(2013, 7, 5));
+    BOOST_CHECK_EQUAL(cal.add_business_days(Date(2013, 7, 5), -1),
+                      Date(2013, 7, 3));
+    BOOST_CHECK_EQUAL(cal.add_business_days(Date(2013, 6, 29), 2),
+                      Date(2013, 7, 2));
+    BOOST_CHECK_EQUAL(cal.add_business_days(Date(2013, 6, 29), 0),
+                      Date(2013, 6, 29));
+    BOOST_CHECK_EQUAL(cal.business_days_between(Date(2013, 7, 1),
+                                                Date(2013, 7, 8)), 4);
+    BOOST_CHECK_EQUAL(cal.business_days_between(Date(2013, 7, 8),
+                                                Date(2013, 7, 1)), -4);
+    BOOST_CHECK_CLOSE(cal.year_fraction(Date(2013, 1, 1),
+                                        Date(2014, 1, 1)),
+                      (261 - 2) / 252.0, 0.0000001);
+
+    //  The tables agree with counting days one at a time.
+
+    const Date start(2013, 1, 1);
+    int count = 0;
+    for ( int d = 0; d < 400; ++d ) {
+        const Date date = start.add_days(d);
+        BOOST_REQUIRE_EQUAL(cal.business_days_between(start, date), count);
+        if ( date.weekday() < 5 && date != Date(2013, 7, 4) &&
+             date != Date(2013, 12, 25) ) {
+            ++count;
+        }
+    }
+
+    BOOST_CHECK_THROW(cal.add_business_days(Date(2199, 12, 31), 1),
+                      std::domain_error);
+    BOOST_CHECK_THROW(cal.add_business_days(Date(1900, 1, 1), -1),
+                      std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(calendar_schedule_test) {
+
+    //  Payments due on non-business days are moved before being
+    //  converted to year fractions.
+
+    const financial::HolidayCalendar cal = make_calendar();
+    const Date valuation(2013, 6, 3);
+    std::vector<financial::DatedCashFlow> flows;
+    flows.push_back(financial::DatedCashFlow(100, Date(2013, 7, 4)));
+    flows.push_back(financial::DatedCashFlow(100, Date(2013, 8, 31)));
+    flows.push_back(financial::DatedCashFlow(100, Date(2013, 9, 3)));
+
+    const financial::CashFlowSchedule sched =
+        financial::dated_schedule(flows, valuation,
+                                  financial::day_count::act_360, cal,
+                                  business_day::modified_following);
+    BOOST_REQUIRE_EQUAL(sched.size(), 3u);
+    BOOST_CHECK_EQUAL(sched[0].time_period,
+                      (Date(2013, 7, 5) - valuation) / 360.0);
+    BOOST_CHECK_EQUAL(sched[1].time_period,
+                      (Date(2013, 8, 30) - valuation) / 360.0);
+    BOOST_CHECK_EQUAL(sched[2].time_period,
+                      (Date(2013, 9, 3) - valuation) / 360.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
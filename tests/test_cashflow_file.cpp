@@ -0,0 +1,109 @@
+/*
+ *  test_cashflow_file.cpp
+ *  ======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for binary cash flow files.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <stdint.h>
+#include <unistd.h>
+#include <boost/test/unit_test.hpp>
+#include "../cashflow_schedule.h"
+#include "../cashflow_file.h"
+
+namespace {
+
+//  Returns a file name unique to this test process.
+
+std::string temp_filename(const std::string& name) {
+    return "/tmp/financial_" + name + "_" + std::to_string(getpid());
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(cashflow_file_suite)
+
+BOOST_AUTO_TEST_CASE(cashflow_file_test1) {
+    financial::CashFlowSchedule sched;
+    for ( int i = 0; i < 1001; ++i ) {
+        sched.add(100 + i % 13, 0.25 * (i + 1));
+    }
+
+    const std::string filename = temp_filename("roundtrip");
+    financial::write_cashflow_file(filename, sched);
+
+    {
+        const financial::MappedCashFlowFile file(filename);
+        BOOST_CHECK_EQUAL(sched.size(), file.size());
+
+        const financial::CashFlowView view = file.view();
+        BOOST_CHECK_EQUAL(0U, reinterpret_cast<uintptr_t>(view.amounts()) %
+                              64);
+        BOOST_CHECK_EQUAL(0U, reinterpret_cast<uintptr_t>(view.times()) % 64);
+
+        bool matches = true;
+        for ( std::size_t i = 0; i < sched.size(); ++i ) {
+            matches = matches && view[i].amount == sched[i].amount &&
+                      view[i].time_period == sched[i].time_period;
+        }
+        BOOST_CHECK(matches);
+
+        BOOST_CHECK_EQUAL(financial::pv_stream(sched, 0.05),
+                          financial::pv_stream(view, 0.05));
+    }
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_file_test2) {
+    const std::string filename = temp_filename("empty");
+    financial::write_cashflow_file(filename, financial::CashFlowSchedule());
+    {
+        const financial::MappedCashFlowFile file(filename);
+        BOOST_CHECK(file.view().empty());
+        BOOST_CHECK_EQUAL(0, financial::pv_stream(file.view(), 0.05));
+    }
+    std::remove(filename.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_file_test3) {
+
+    //  Missing, foreign and truncated files are rejected.
+
+    BOOST_CHECK_THROW(financial::MappedCashFlowFile(temp_filename("none")),
+                      std::runtime_error);
+
+    const std::string foreign = temp_filename("foreign");
+    {
+        std::ofstream out(foreign.c_str());
+        for ( int i = 0; i < 20; ++i ) {
+            out << "amount,time_period\n";
+        }
+    }
+    BOOST_CHECK_THROW(financial::MappedCashFlowFile file(foreign),
+                      std::runtime_error);
+    std::remove(foreign.c_str());
+
+    financial::CashFlowSchedule sched;
+    for ( int i = 0; i < 100; ++i ) {
+        sched.add(100, i);
+    }
+    const std::string truncated = temp_filename("truncated");
+    financial::write_cashflow_file(truncated, sched);
+    BOOST_CHECK_EQUAL(0, truncate(truncated.c_str(), 64 + 100 * 8));
+    BOOST_CHECK_THROW(financial::MappedCashFlowFile file(truncated),
+                      std::runtime_error);
+    std::remove(truncated.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+/*
+ *  test_cashflow_range.cpp
+ *  =======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for cash flow range and strided view functions.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <list>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../cashflow_range.h"
+#include "alloc_counter.h"
+
+namespace {
+
+//  A record carrying a cash flow among other fields.
+
+struct Position {
+    int id;
+    double amount;
+    char desk[12];
+    double time;
+};
+
+std::vector<Position> make_positions(const int num_positions) {
+    std::vector<Position> positions(num_positions);
+    for ( int i = 0; i < num_positions; ++i ) {
+        positions[i].id = i;
+        positions[i].amount = 100 + i % 11;
+        positions[i].time = 0.5 * (1 + i % 40);
+    }
+    return positions;
+}
+
+double expected_pv(const std::vector<Position>& positions,
+                   const double interest_rate) {
+    std::vector<financial::TimedCashFlow> cashflows;
+    for ( std::size_t i = 0; i < positions.size(); ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(positions[i].amount,
+                                                     positions[i].time));
+    }
+    return financial::pv_stream(cashflows, interest_rate);
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(cashflow_range_suite)
+
+BOOST_AUTO_TEST_CASE(cashflow_range_test1) {
+
+    //  Accessor functions and member pointers over a vector, with more
+    //  records than one gathered block.
+
+    const double tolerance = 0.0000001;
+    const std::vector<Position> positions = make_positions(1001);
+    const double expected_result = expected_pv(positions, 0.04);
+
+    const std::size_t allocations = alloc_counter::allocations();
+    const double test_result1 = financial::pv_stream(positions.begin(),
+            positions.end(), 0.04,
+            [](const Position& p) { return p.amount; },
+            [](const Position& p) { return p.time; });
+    const double test_result2 = financial::pv_stream(positions.begin(),
+            positions.end(), 0.04, &Position::amount, &Position::time);
+    BOOST_CHECK_EQUAL(allocations, alloc_counter::allocations());
+
+    BOOST_CHECK_CLOSE(expected_result, test_result1, tolerance);
+    BOOST_CHECK_EQUAL(test_result1, test_result2);
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_range_test2) {
+
+    //  Strided views give the same result as the equivalent ranges.
+
+    const std::vector<Position> positions = make_positions(777);
+    const financial::StridedCashFlowView view =
+        financial::make_strided_view(positions.data(), positions.size(),
+                                     &Position::amount, &Position::time);
+    BOOST_CHECK_EQUAL(positions.size(), view.size());
+    BOOST_CHECK_EQUAL(sizeof(Position), view.stride());
+    BOOST_CHECK_EQUAL(positions[500].time, view[500].time_period);
+
+    const std::size_t allocations = alloc_counter::allocations();
+    const double test_result = financial::pv_stream(view, 0.07);
+    BOOST_CHECK_EQUAL(allocations, alloc_counter::allocations());
+
+    BOOST_CHECK_EQUAL(financial::pv_stream(positions.begin(),
+                          positions.end(), 0.07, &Position::amount,
+                          &Position::time), test_result);
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_range_test3) {
+
+    //  TimedCashFlow ranges from non-contiguous containers, and
+    //  continuous discounting.
+
+    const double tolerance = 0.0000001;
+    std::list<financial::TimedCashFlow> cashflows;
+    std::vector<financial::TimedCashFlow> expected;
+    for ( int i = 1; i <= 30; ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(50, i));
+        expected.push_back(financial::TimedCashFlow(50, i));
+    }
+    const financial::disc_type dt = financial::disc_type::continuous;
+    BOOST_CHECK_CLOSE(financial::pv_stream(financial::CashFlowSchedule(
+                          expected), 0.03, dt),
+                      financial::pv_stream(cashflows.begin(),
+                          cashflows.end(), 0.03, dt), tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_stream(expected, 0.03),
+                      financial::pv_stream(cashflows.begin(),
+                          cashflows.end(), 0.03), tolerance);
+    BOOST_CHECK_EQUAL(0, financial::pv_stream(cashflows.end(),
+                                              cashflows.end(), 0.03));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,302 @@
+/*
+ *  test_cashflow_schedule.cpp
+ *  ==========================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for cash flow schedules and the vectorized pv_stream()
+ *  kernels.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "../basic_dcf.h"
+#include "../cashflow_schedule.h"
+#include "../pv_kernels.h"
+#include "../thread_pool.h"
+
+BOOST_AUTO_TEST_SUITE(cashflow_schedule_suite)
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_test1) {
+    const double tolerance = 0.000001;
+    const double expected_result = 772.173493;
+
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i < 11; ++i ) {
+        sched.add(100, i);
+    }
+
+    const double test_result = financial::pv_stream(sched, 0.05);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_test2) {
+    const double tolerance = 0.0000001;
+
+    std::vector<financial::TimedCashFlow> cfs;
+    for ( int i = 0; i < 1003; ++i ) {
+        cfs.push_back(financial::TimedCashFlow(50 + i % 7, 0.25 * i));
+    }
+    const financial::CashFlowSchedule sched(cfs);
+    BOOST_CHECK_EQUAL(sched.size(), cfs.size());
+
+    const double expected_result = financial::pv_stream(cfs, 0.0125);
+    const double test_result = financial::pv_stream(sched, 0.0125);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_test3) {
+    const double tolerance = 0.000001;
+    const double expected_result = 100 * std::exp(-0.05 * 3.5);
+
+    financial::CashFlowSchedule sched;
+    sched.add(100, 3.5);
+
+    const double test_result = financial::pv_stream(sched, 0.05,
+            financial::disc_type::continuous);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_at_test) {
+
+    //  Valuing at a later time values only the cash flows after it,
+    //  discounted back to that time rather than to time zero.
+
+    const double tolerance = 0.0000001;
+
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i <= 40; ++i ) {
+        sched.add(25 + i % 3, 0.25 * i);
+    }
+    const financial::CashFlowView view(sched);
+    BOOST_CHECK_EQUAL(view.after(0).size(), 40u);
+    BOOST_CHECK_EQUAL(view.after(0.25).size(), 39u);
+    BOOST_CHECK_EQUAL(view.after(2.6).size(), 30u);
+    BOOST_CHECK_EQUAL(view.after(2.6).times()[0], 2.75);
+    BOOST_CHECK_EQUAL(view.after(10).size(), 0u);
+
+    const double valuation_times[] = {0, 0.25, 2.6, 7.9};
+    const financial::disc_type types[] = {financial::disc_type::discrete,
+                                          financial::disc_type::continuous};
+    for ( int d = 0; d < 2; ++d ) {
+        for ( int v = 0; v < 4; ++v ) {
+            const double vt = valuation_times[v];
+            double expected_result = 0;
+            for ( std::size_t i = 0; i < sched.size(); ++i ) {
+                if ( sched[i].time_period > vt ) {
+                    expected_result += financial::pv(sched[i].amount, 0.04,
+                                                     sched[i].time_period -
+                                                     vt, types[d]);
+                }
+            }
+            BOOST_CHECK_CLOSE(expected_result,
+                              financial::pv_stream_at(sched, 0.04, vt,
+                                                      types[d]),
+                              tolerance);
+        }
+    }
+    BOOST_CHECK_EQUAL(financial::pv_stream_at(sched, 0.04, 10), 0);
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_kernels_test) {
+    using namespace financial::detail;
+
+    const simd_isa isas[] = {simd_isa::scalar, simd_isa::avx2,
+                             simd_isa::avx512};
+    const double log_growth = std::log1p(0.07);
+
+    for ( int n = 0; n < 40; ++n ) {
+        std::vector<double> amounts;
+        std::vector<double> times;
+        for ( int i = 0; i < n; ++i ) {
+            amounts.push_back(1000 - 13 * i);
+            times.push_back(0.5 * i + 0.125);
+        }
+
+        double expected_result = 0;
+        for ( int i = 0; i < n; ++i ) {
+            expected_result += financial::pv(amounts[i], 0.07, times[i]);
+        }
+
+        for ( int k = 0; k < 3; ++k ) {
+            if ( !isa_available(isas[k]) ) {
+                continue;
+            }
+            const double test_result = pv_sum(isas[k], amounts.data(),
+                    times.data(), amounts.size(), log_growth);
+            BOOST_CHECK_SMALL(expected_result - test_result,
+                              1e-12 * (1 + std::fabs(expected_result)));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_ulp_test) {
+    const double rates[] = {-0.3, 0.0001, 0.01, 0.05, 0.35};
+
+    for ( int r = 0; r < 5; ++r ) {
+        const double log_growth = std::log1p(rates[r]);
+        for ( double t = 0; t < 60; t += 0.37 ) {
+            const double expected_result = financial::discount_factor(
+                    rates[r], t);
+            const double test_result = financial::detail::kernel_exp(
+                    -t * log_growth);
+            const double ulp = std::nextafter(expected_result, 1e300) -
+                               expected_result;
+            const double bound = 5 + 4 * std::fabs(t * log_growth);
+            BOOST_CHECK_SMALL((expected_result - test_result) / ulp, bound);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_exp_range_test) {
+    using namespace financial::detail;
+
+    //  Each kernel overflows, underflows and passes NaN through as
+    //  std::exp() does, and scales subnormal results correctly. Each
+    //  argument is repeated so that it reaches every vector lane.
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double special[] = {
+        800, 709.78, 709.5, 700, -700, -708.5, -720, -740, -745.1,
+        -746, -1e300, 1e300, inf, -inf, nan
+    };
+    const std::size_t num_special = sizeof(special) / sizeof(special[0]);
+    std::vector<double> args;
+    for ( int rep = 0; rep < 9; ++rep ) {
+        args.insert(args.end(), special, special + num_special);
+    }
+
+    const simd_isa isas[] = {simd_isa::scalar, simd_isa::avx2,
+                             simd_isa::avx512};
+    for ( int k = 0; k < 3; ++k ) {
+        if ( !isa_available(isas[k]) ) {
+            continue;
+        }
+        std::vector<double> results(args.size());
+        exponentials(isas[k], args.data(), args.size(), results.data());
+        for ( std::size_t i = 0; i < args.size(); ++i ) {
+            const double expected = std::exp(args[i]);
+            if ( std::isnan(expected) ) {
+                BOOST_CHECK(std::isnan(results[i]));
+            } else if ( std::isinf(expected) || expected == 0 ) {
+                BOOST_CHECK_EQUAL(results[i], expected);
+            } else {
+                const double denorm = std::numeric_limits<double>::
+                                      denorm_min();
+                BOOST_CHECK_SMALL(results[i] - expected,
+                                  std::max(2e-15 * expected, denorm));
+            }
+        }
+    }
+
+    //  The public functions give the scalar functions' limits.
+
+    financial::CashFlowSchedule sched;
+    sched.add(1000, 1100);
+    BOOST_CHECK_EQUAL(financial::pv_stream(sched, 1.0),
+                      financial::pv(1000, 1.0, 1100));
+    BOOST_CHECK_EQUAL(financial::pv_stream(sched, 1.0), 0);
+    BOOST_CHECK(std::isnan(financial::pv_stream(sched, nan)));
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_multi_rate_test1) {
+    const double tolerance = 0.0000001;
+
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i <= 1100; ++i ) {
+        sched.add(25 + i % 11, i / 12.0);
+    }
+
+    std::vector<double> rates;
+    for ( int bp = -20; bp <= 20; ++bp ) {
+        rates.push_back(0.04 + bp * 0.0005);
+    }
+
+    const std::vector<double> test_results = financial::pv_stream(sched,
+            rates);
+    BOOST_REQUIRE_EQUAL(test_results.size(), rates.size());
+    for ( std::size_t j = 0; j < rates.size(); ++j ) {
+        const double expected_result = financial::pv_stream(sched, rates[j]);
+        BOOST_CHECK_CLOSE(expected_result, test_results[j], tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_multi_rate_kernels_test) {
+    using namespace financial::detail;
+
+    const simd_isa isas[] = {simd_isa::scalar, simd_isa::avx2,
+                             simd_isa::avx512};
+    const double amounts[] = {40, 40, 40, 40, 40, 1040};
+    const double times[] = {0.5, 1, 1.5, 2, 2.5, 3};
+
+    for ( std::size_t n = 0; n < 37; ++n ) {
+        std::vector<double> log_growths;
+        for ( std::size_t j = 0; j < n; ++j ) {
+            log_growths.push_back(std::log1p(0.001 * j));
+        }
+
+        for ( int k = 0; k < 3; ++k ) {
+            if ( !isa_available(isas[k]) ) {
+                continue;
+            }
+            std::vector<double> test_results(n + 1, -1);
+            pv_sum_multi(isas[k], amounts, times, 6, log_growths.data(), n,
+                         test_results.data());
+            for ( std::size_t j = 0; j < n; ++j ) {
+                const double expected_result = pv_sum_scalar(amounts, times,
+                        6, log_growths[j]);
+                BOOST_CHECK_SMALL(expected_result - test_results[j], 1e-10);
+            }
+            BOOST_CHECK_EQUAL(test_results[n], -1);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cashflow_schedule_parallel_test) {
+
+    //  A long stream of mixed sign cash flows has the same present
+    //  value on any number of threads, close to the single threaded
+    //  one, and a single chunk has exactly the single threaded value.
+
+    const double tolerance = 0.0000001;
+    financial::CashFlowSchedule sched;
+    for ( int i = 0; i < 1000003; ++i ) {
+        sched.add(( i % 3 == 0 ? -250.0 : 100.0 ) + (i % 17),
+                  0.0001 * i);
+    }
+
+    financial::ThreadPool single(1);
+    const double expected_result = financial::pv_stream(sched, 0.03,
+                                                        single);
+    BOOST_CHECK_CLOSE(financial::pv_stream(sched, 0.03), expected_result,
+                      tolerance);
+
+    const unsigned thread_counts[] = {2, 3, 4};
+    for ( int k = 0; k < 3; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        BOOST_CHECK_EQUAL(financial::pv_stream(sched, 0.03, pool),
+                          expected_result);
+        BOOST_CHECK_EQUAL(financial::pv_stream(sched, 0.03, pool,
+                          financial::disc_type::continuous),
+                          financial::pv_stream(sched, 0.03, single,
+                          financial::disc_type::continuous));
+    }
+
+    const financial::CashFlowView view(sched);
+    const financial::CashFlowView chunk(view.amounts(), view.times(),
+                                        financial::pv_stream_chunk_size);
+    financial::ThreadPool pool(4);
+    BOOST_CHECK_EQUAL(financial::pv_stream(chunk, 0.03, pool),
+                      financial::pv_stream(chunk, 0.03));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
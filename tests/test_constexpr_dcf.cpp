@@ -0,0 +1,119 @@
+/*
+ *  test_constexpr_dcf.cpp
+ *  ======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for compile-time discounted cash flow functions.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../constexpr_dcf.h"
+
+//  These must fold at compile time.
+
+static_assert(financial::ipow(2, 10) == 1024, "ipow failed");
+static_assert(financial::compound_factor<0>(0.05) == 1, "cf failed");
+static_assert(financial::compound_factor<3>(1) == 8, "cf failed");
+static_assert(financial::discount_factor<2>(1) == 0.25, "df failed");
+static_assert(financial::discount_factor_int(1, -2) == 4, "df failed");
+static_assert(financial::pv_perpetuity<financial::annuity_type::due>(
+              100, 0.25) == 500, "perpetuity failed");
+
+BOOST_AUTO_TEST_SUITE(constexpr_dcf_suite)
+
+BOOST_AUTO_TEST_CASE(constexpr_dcf_test1) {
+    const double tolerance = 0.000001;
+    constexpr double test_result = financial::discount_factor<4>(0.12);
+    const double expected_result = financial::discount_factor(0.12, 4);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_dcf_test2) {
+    const double tolerance = 0.000001;
+    constexpr double test_pv = financial::pv<-3>(100, 0.05);
+    constexpr double test_fv = financial::fv<7>(100, 0.1);
+    BOOST_CHECK_CLOSE(financial::pv(100, 0.05, -3), test_pv, tolerance);
+    BOOST_CHECK_CLOSE(financial::fv(100, 0.1, 7), test_fv, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_dcf_test3) {
+    const double tolerance = 0.000001;
+    constexpr double test_result = financial::pv_annuity<15,
+              financial::annuity_type::due>(150, 0.08);
+    BOOST_CHECK_CLOSE(1386.635547, test_result, tolerance);
+
+    constexpr double test_result2 = financial::pv_annuity<10>(100, 0.05);
+    BOOST_CHECK_CLOSE(772.173493, test_result2, tolerance);
+
+    const double test_result3 = financial::pv_annuity<
+        financial::annuity_type::immediate>(100, 0.05, 10);
+    BOOST_CHECK_CLOSE(772.173493, test_result3, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_dcf_test4) {
+    const double tolerance = 0.0000001;
+    constexpr double test_lp = financial::loan_repayment<360>(80000, 0.0075);
+    BOOST_CHECK_CLOSE(643.698094, test_lp, tolerance);
+
+    constexpr double test_sf = financial::sinking_fund_payment<5>(10000,
+                                                                  0.05);
+    BOOST_CHECK_CLOSE(financial::sinking_fund_payment(10000, 0.05, 5),
+                      test_sf, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_dcf_test5) {
+    const double tolerance = 0.000001;
+    const double periods[] = {0.5, 1, 2.5, 10};
+
+    for ( int i = 0; i < 4; ++i ) {
+        BOOST_CHECK_CLOSE(financial::compound_factor(0.07, periods[i],
+                              financial::disc_type::continuous),
+                          financial::compound_factor<
+                              financial::disc_type::continuous>(0.07,
+                              periods[i]), tolerance);
+        BOOST_CHECK_CLOSE(financial::pv(100, 0.07, periods[i]),
+                          financial::pv<financial::disc_type::discrete>(
+                              100, 0.07, periods[i]), tolerance);
+        BOOST_CHECK_CLOSE(financial::fv(100, 0.07, periods[i],
+                              financial::disc_type::continuous),
+                          financial::fv<financial::disc_type::continuous>(
+                              100, 0.07, periods[i]), tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(constexpr_dcf_test6) {
+
+    //  At a tiny rate the factors are close to one, and the annuity
+    //  functions must agree with their runtime twins, which have no
+    //  cancellation, to close to the last bit.
+
+    const double tolerance = 0.00000000001;
+    const double rate = 1e-9;
+
+    BOOST_CHECK_CLOSE(financial::compound_factor(rate, 360),
+                      financial::compound_factor<360>(rate), tolerance);
+    BOOST_CHECK_CLOSE(financial::discount_factor(rate, 360),
+                      financial::discount_factor<360>(rate), tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_annuity(100, rate, 360),
+                      financial::pv_annuity<360>(100, rate), tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_annuity(100, rate, 360,
+                          financial::annuity_type::due),
+                      financial::pv_annuity<
+                          financial::annuity_type::due>(100, rate, 360),
+                      tolerance);
+    BOOST_CHECK_CLOSE(financial::loan_repayment(100000, rate, 360),
+                      financial::loan_repayment<360>(100000, rate),
+                      tolerance);
+    BOOST_CHECK_CLOSE(financial::sinking_fund_payment(100000, rate, 360),
+                      financial::sinking_fund_payment<360>(100000, rate),
+                      tolerance);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
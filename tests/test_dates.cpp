@@ -0,0 +1,193 @@
+/*
+ *  test_dates.cpp
+ *  ==============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Unit tests for dates, day count conventions and dated cash flows.
+ *
+ *  Uses Boost unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../cashflow_schedule.h"
+#include "../dates.h"
+
+using financial::Date;
+using financial::day_count;
+
+namespace {
+
+//  Converts a serial date to its calendar fields arithmetically, to
+//  check the date table against.
+
+void civil_from_serial(const int serial, int& year, int& month, int& day) {
+    const int z = serial + 693901;      //  days since 1 March, year 0
+    const int era = z / 146097;
+    const int doe = z - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = yoe + era * 400 + (month <= 2 ? 1 : 0);
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(dates_suite)
+
+BOOST_AUTO_TEST_CASE(dates_test1) {
+
+    //  Every date in the range round trips through its calendar
+    //  fields, which agree with the arithmetic conversion.
+
+    const Date last(financial::last_year, 12, 31);
+    BOOST_CHECK_EQUAL(last.serial(), 109572);
+    for ( int serial = 0; serial <= last.serial(); ++serial ) {
+        const Date date = Date::from_serial(serial);
+        int year, month, day;
+        civil_from_serial(serial, year, month, day);
+        if ( date.year() != year || date.month() != month ||
+             date.day() != day ||
+             Date(year, month, day).serial() != serial ) {
+            BOOST_ERROR("date table wrong at serial " << serial);
+            break;
+        }
+    }
+
+    BOOST_CHECK_EQUAL(Date(1900, 1, 1).weekday(), 0);
+    BOOST_CHECK_EQUAL(Date(2013, 6, 28).weekday(), 4);
+    BOOST_CHECK_EQUAL(Date(2000, 2, 29).add_days(1), Date(2000, 3, 1));
+    BOOST_CHECK_EQUAL(Date(2004, 1, 1) - Date(2003, 1, 1), 365);
+    BOOST_CHECK(Date(2013, 6, 28) < Date(2013, 6, 29));
+}
+
+BOOST_AUTO_TEST_CASE(dates_test2) {
+    BOOST_CHECK_THROW(Date(1899, 12, 31), std::domain_error);
+    BOOST_CHECK_THROW(Date(2200, 1, 1), std::domain_error);
+    BOOST_CHECK_THROW(Date(2013, 13, 1), std::domain_error);
+    BOOST_CHECK_THROW(Date(2013, 2, 29), std::domain_error);
+    BOOST_CHECK_THROW(Date(1900, 2, 29), std::domain_error);
+    BOOST_CHECK_THROW(Date(2013, 4, 0), std::domain_error);
+    BOOST_CHECK_NO_THROW(Date(2000, 2, 29));
+    BOOST_CHECK_THROW(Date::from_serial(-1), std::domain_error);
+    BOOST_CHECK_THROW(Date(2199, 12, 31).add_days(1), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(day_count_test1) {
+
+    //  The ISDA example period from 1 November 2003 to 1 May 2004.
+
+    const double tolerance = 0.0000001;
+    const Date start(2003, 11, 1);
+    const Date end(2004, 5, 1);
+    BOOST_CHECK_CLOSE(financial::year_fraction(start, end,
+                                               day_count::act_act_isda),
+                      61.0 / 365 + 121.0 / 366, tolerance);
+    BOOST_CHECK_CLOSE(financial::year_fraction(start, end,
+                                               day_count::act_360),
+                      182.0 / 360, tolerance);
+    BOOST_CHECK_CLOSE(financial::year_fraction(start, end,
+                                               day_count::act_365_fixed),
+                      182.0 / 365, tolerance);
+    BOOST_CHECK_CLOSE(financial::year_fraction(start, end,
+                                               day_count::thirty_360),
+                      0.5, tolerance);
+    BOOST_CHECK_CLOSE(financial::year_fraction(end, start,
+                                               day_count::act_act_isda),
+                      -(61.0 / 365 + 121.0 / 366), tolerance);
+    BOOST_CHECK_CLOSE(financial::year_fraction(Date(2003, 6, 1),
+                                               Date(2008, 6, 1),
+                                               day_count::act_act_isda),
+                      214.0 / 365 + 4 + 152.0 / 366, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(day_count_test2) {
+
+    //  The 30/360 conventions differ only in their treatment of an end
+    //  date on the 31st.
+
+    const double tolerance = 0.0000001;
+    const struct {
+        Date start;
+        Date end;
+        double us_days;
+        double eurobond_days;
+    } cases[] = {
+        {Date(2007, 1, 31), Date(2007, 2, 28), 28, 28},
+        {Date(2007, 1, 30), Date(2007, 3, 31), 60, 60},
+        {Date(2007, 1, 31), Date(2007, 3, 31), 60, 60},
+        {Date(2007, 1, 15), Date(2007, 3, 31), 76, 75},
+        {Date(2006, 8, 31), Date(2008, 2, 29), 539, 539}
+    };
+    for ( int i = 0; i < 5; ++i ) {
+        BOOST_CHECK_CLOSE(financial::year_fraction(cases[i].start,
+                                                   cases[i].end,
+                                                   day_count::thirty_360),
+                          cases[i].us_days / 360, tolerance);
+        BOOST_CHECK_CLOSE(financial::year_fraction(cases[i].start,
+                                                   cases[i].end,
+                                                   day_count::thirty_e_360),
+                          cases[i].eurobond_days / 360, tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(day_count_batch_test) {
+
+    //  The batch conversion gives exactly the scalar year fractions.
+
+    const Date start(2013, 6, 28);
+    std::vector<Date> dates;
+    for ( int i = 0; i < 5000; ++i ) {
+        dates.push_back(start.add_days(-3000 + (i * 7919) % 20000));
+    }
+    const day_count conventions[] = {day_count::act_360,
+                                     day_count::act_365_fixed,
+                                     day_count::act_act_isda,
+                                     day_count::thirty_360,
+                                     day_count::thirty_e_360};
+    std::vector<double> fractions(dates.size());
+    for ( int c = 0; c < 5; ++c ) {
+        financial::year_fractions(start, dates.data(), dates.size(),
+                                  conventions[c], fractions.data());
+        for ( std::size_t i = 0; i < dates.size(); ++i ) {
+            BOOST_REQUIRE_EQUAL(fractions[i],
+                                financial::year_fraction(start, dates[i],
+                                                         conventions[c]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dated_schedule_test) {
+    const double tolerance = 0.0000001;
+    const Date valuation(2013, 6, 28);
+    std::vector<financial::DatedCashFlow> flows;
+    for ( int year = 2014; year <= 2023; ++year ) {
+        flows.push_back(financial::DatedCashFlow(50, Date(year, 3, 15)));
+    }
+    flows.back().amount += 1000;
+
+    const financial::CashFlowSchedule sched =
+        financial::dated_schedule(flows, valuation,
+                                  day_count::act_365_fixed);
+    BOOST_REQUIRE_EQUAL(sched.size(), flows.size());
+
+    double expected_result = 0;
+    for ( std::size_t i = 0; i < flows.size(); ++i ) {
+        const double t = (flows[i].date - valuation) / 365.0;
+        BOOST_CHECK_EQUAL(sched[i].time_period, t);
+        expected_result += financial::pv(flows[i].amount, 0.04, t);
+    }
+    BOOST_CHECK_CLOSE(financial::pv_stream(sched, 0.04), expected_result,
+                      tolerance);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -4,7 +4,7 @@
  *  Copyright 2013 Paul Griffiths
  *  Email: mail@paulgriffiths.net
  *  
- *  Unit tests for discount_factor() function.
+ *  Unit tests for discount_factor() and compound_factor() functions.
  *
  *  Uses Boost unit testing framework.
  *  
@@ -12,6 +12,7 @@
  *  http://www.gnu.org/licenses/
  */
 
+#include <cmath>
 #include <boost/test/unit_test.hpp>
 #include "../basic_dcf.h"
 
@@ -92,4 +93,43 @@ BOOST_AUTO_TEST_CASE(df_cont_test5) {
     BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
 }
 
+BOOST_AUTO_TEST_CASE(df_accuracy_test) {
+
+    //  Every class of input, against a long double reference, within
+    //  an error bound which grows with the size of the exponent.
+
+    int failures = 0;
+    for ( double r = 0.0001; r < 0.2; r = r * 1.37 + 0.0001 ) {
+        for ( double n = -40; n <= 400; n += ( n < 8 ) ? 0.25 : 7.5 ) {
+            const long double y = n * std::log1p(static_cast<long double>(r));
+            const double max_ulps = 3 + 2 * std::fabs(static_cast<double>(y));
+
+            const double expected_cf = static_cast<double>(std::exp(y));
+            const double cf_ulp = std::nextafter(expected_cf, 1e300) -
+                                  expected_cf;
+            failures += std::fabs(financial::compound_factor(r, n) -
+                                  expected_cf) > max_ulps * cf_ulp;
+
+            const double expected_df = static_cast<double>(std::exp(-y));
+            const double df_ulp = std::nextafter(expected_df, 1e300) -
+                                  expected_df;
+            failures += std::fabs(financial::discount_factor(r, n) -
+                                  expected_df) > max_ulps * df_ulp;
+        }
+    }
+    BOOST_CHECK_EQUAL(failures, 0);
+}
+
+BOOST_AUTO_TEST_CASE(df_special_values_test) {
+    BOOST_CHECK_EQUAL(financial::compound_factor(0.05, 0), 1);
+    BOOST_CHECK_EQUAL(financial::compound_factor(0.05, 1), 1.05);
+    BOOST_CHECK_EQUAL(financial::compound_factor(-1, 3), 0);
+    BOOST_CHECK_EQUAL(financial::compound_factor(-1.5, 2), 0.25);
+    BOOST_CHECK(std::isnan(financial::compound_factor(-1.5, 2.5)));
+    BOOST_CHECK_EQUAL(financial::compound_factor(0.05, 2,
+                          financial::disc_type::continuous), std::exp(0.1));
+    BOOST_CHECK_EQUAL(financial::discount_factor(0.05, 2,
+                          financial::disc_type::continuous), std::exp(-0.1));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
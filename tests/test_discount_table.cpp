@@ -0,0 +1,84 @@
+/*
+ *  test_discount_table.cpp
+ *  =======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for precomputed discount factor tables.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../discount_table.h"
+
+BOOST_AUTO_TEST_SUITE(discount_table_suite)
+
+BOOST_AUTO_TEST_CASE(discount_table_test1) {
+
+    //  Factors on the grid match the direct calculation exactly.
+
+    const financial::DiscountTable table(0.0035, 360);
+    for ( int i = 0; i <= 360; ++i ) {
+        BOOST_CHECK_EQUAL(financial::discount_factor(0.0035, i),
+                          table.discount_factor(i));
+        BOOST_CHECK_EQUAL(financial::compound_factor(0.0035, i),
+                          table.compound_factor(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(discount_table_test2) {
+
+    //  Factors between grid points, beyond the grid and before
+    //  the start of the grid.
+
+    const double tolerance = 0.000000001;
+    const financial::DiscountTable table(0.05, 30, 2);
+    const double periods[] = {0.25, 0.5, 7.3, 12.75, 29.9, 30, 45.5, -2.5};
+    for ( std::size_t i = 0; i < sizeof(periods) / sizeof(periods[0]); ++i ) {
+        BOOST_CHECK_CLOSE(financial::discount_factor(0.05, periods[i]),
+                          table.discount_factor(periods[i]), tolerance);
+        BOOST_CHECK_CLOSE(financial::compound_factor(0.05, periods[i]),
+                          table.compound_factor(periods[i]), tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(discount_table_test3) {
+    const double tolerance = 0.000000001;
+    const financial::disc_type dt = financial::disc_type::continuous;
+    const financial::DiscountTable table(0.08, 10, 4, dt);
+    BOOST_CHECK_CLOSE(financial::pv(100, 0.08, 3.6, dt),
+                      table.pv(100, 3.6), tolerance);
+    BOOST_CHECK_CLOSE(financial::fv(100, 0.08, 9.1, dt),
+                      table.fv(100, 9.1), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(discount_table_test4) {
+    const double tolerance = 0.000000001;
+    std::vector<financial::TimedCashFlow> cashflows;
+    for ( int i = 1; i <= 20; ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(25, i * 0.5));
+    }
+    cashflows.push_back(financial::TimedCashFlow(1000, 10));
+
+    const financial::DiscountTable table(0.06, 10);
+    BOOST_CHECK_CLOSE(financial::pv_stream(cashflows, 0.06),
+                      table.pv_stream(cashflows), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(discount_table_test5) {
+    BOOST_CHECK_THROW(financial::DiscountTable(0.05, -1),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::DiscountTable(0.05, 10, 0),
+                      std::domain_error);
+    const financial::DiscountTable table(0.05, 0);
+    BOOST_CHECK_EQUAL(1, table.discount_factor(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,227 @@
+/*
+ *  test_instrumentation.cpp
+ *  ========================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Unit tests for the hot path instrumentation, which pass whether or
+ *  not the library was built with the instrumentation compiled in.
+ *
+ *  Uses Boost unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../instrumentation.h"
+#include "../basic_dcf.h"
+#include "../bond.h"
+#include "../cashflow_range.h"
+#include "../cashflow_schedule.h"
+#include "../thread_pool.h"
+
+using financial::probe;
+
+namespace {
+
+//  Number of calls the trace hook has seen.
+
+std::size_t hook_calls = 0;
+
+//  Trace hook which counts calls to pv_stream().
+
+void count_pv_stream(const probe entry_point, const uint64_t,
+                     const uint64_t) {
+    if ( entry_point == probe::pv_stream ) {
+        ++hook_calls;
+    }
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(instrumentation_suite)
+
+BOOST_AUTO_TEST_CASE(instrumentation_names_test) {
+    BOOST_CHECK_EQUAL(std::string("compound_factor"),
+                      financial::probe_name(probe::compound_factor));
+    BOOST_CHECK_EQUAL(std::string("pv_stream"),
+                      financial::probe_name(probe::pv_stream));
+    BOOST_CHECK_EQUAL(std::string("schedule_build"),
+                      financial::probe_name(probe::schedule_build));
+}
+
+BOOST_AUTO_TEST_CASE(instrumentation_counts_test) {
+    financial::reset_stats();
+
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i <= 10; ++i ) {
+        sched.add(100, i);
+    }
+    const double rates[] = {0.03, 0.04, 0.05};
+    double pvs[3];
+    financial::pv_stream(sched, 0.05);
+    financial::pv_stream(sched, rates, 3, pvs);
+    financial::pv_annuity(100, 0.05, 10);
+    financial::loan_repayment(1000, 0.05, 10);
+
+    const financial::SimpleBond bond(1000, 0.05, 2, 10);
+    bond.value(0.05);
+    bond.schedule();
+
+    const financial::ProbeStats streams =
+        financial::total_stats(probe::pv_stream);
+    const financial::ProbeStats annuities =
+        financial::total_stats(probe::pv_annuity);
+    const financial::ProbeStats loans =
+        financial::total_stats(probe::loan_repayment);
+    const financial::ProbeStats values =
+        financial::total_stats(probe::bond_value);
+    const financial::ProbeStats builds =
+        financial::total_stats(probe::schedule_build);
+
+    if ( financial::instrumentation_enabled() ) {
+        BOOST_CHECK_EQUAL(2u, streams.calls);
+        BOOST_CHECK_EQUAL(10u + 30u, streams.cashflows);
+        BOOST_CHECK_EQUAL(1u, annuities.calls);
+        BOOST_CHECK_EQUAL(10u, annuities.cashflows);
+        BOOST_CHECK_EQUAL(1u, loans.calls);
+        BOOST_CHECK_EQUAL(1u, values.calls);
+        BOOST_CHECK_EQUAL(20u, values.cashflows);
+        BOOST_CHECK_EQUAL(1u, builds.calls);
+        BOOST_CHECK_EQUAL(20u, builds.cashflows);
+
+        std::ostringstream out;
+        financial::write_stats(out);
+        BOOST_CHECK(out.str().find("financial_probe_cashflows{probe="
+                                   "\"pv_stream\",thread=\"") !=
+                    std::string::npos);
+    } else {
+        BOOST_CHECK_EQUAL(0u, streams.calls);
+        BOOST_CHECK_EQUAL(0u, values.calls);
+        BOOST_CHECK_EQUAL(0u, builds.calls);
+    }
+
+    financial::reset_stats();
+    BOOST_CHECK_EQUAL(0u, financial::total_stats(probe::pv_stream).calls);
+    BOOST_CHECK_EQUAL(0u, financial::total_stats(probe::pv_stream).cashflows);
+}
+
+BOOST_AUTO_TEST_CASE(instrumentation_annuity_test) {
+
+    //  An annuity over a negative number of periods records no cash
+    //  flows, rather than a count wrapped around from a negative one.
+
+    financial::reset_stats();
+    financial::pv_annuity(100, 0.05, -5);
+    const financial::ProbeStats annuities =
+        financial::total_stats(probe::pv_annuity);
+
+    if ( financial::instrumentation_enabled() ) {
+        BOOST_CHECK_EQUAL(1u, annuities.calls);
+        BOOST_CHECK_EQUAL(0u, annuities.cashflows);
+    } else {
+        BOOST_CHECK_EQUAL(0u, annuities.calls);
+    }
+    financial::reset_stats();
+}
+
+BOOST_AUTO_TEST_CASE(instrumentation_range_test) {
+
+    //  The range and strided view overloads gather their cash flows in
+    //  blocks, but record a single call for all of them.
+
+    std::vector<financial::TimedCashFlow> flows;
+    for ( int i = 0; i < 1000; ++i ) {
+        flows.push_back(financial::TimedCashFlow(100, 0.25 * i));
+    }
+
+    financial::reset_stats();
+    financial::pv_stream(flows.begin(), flows.end(), 0.05);
+    const financial::ProbeStats range_stats =
+        financial::total_stats(probe::pv_stream);
+
+    financial::reset_stats();
+    financial::pv_stream(
+        financial::make_strided_view(flows.data(), flows.size(),
+                                     &financial::TimedCashFlow::amount,
+                                     &financial::TimedCashFlow::time_period),
+        0.05);
+    const financial::ProbeStats strided_stats =
+        financial::total_stats(probe::pv_stream);
+
+    if ( financial::instrumentation_enabled() ) {
+        BOOST_CHECK_EQUAL(1u, range_stats.calls);
+        BOOST_CHECK_EQUAL(1000u, range_stats.cashflows);
+        BOOST_CHECK_EQUAL(1u, strided_stats.calls);
+        BOOST_CHECK_EQUAL(1000u, strided_stats.cashflows);
+    } else {
+        BOOST_CHECK_EQUAL(0u, range_stats.calls);
+        BOOST_CHECK_EQUAL(0u, strided_stats.calls);
+    }
+    financial::reset_stats();
+}
+
+BOOST_AUTO_TEST_CASE(instrumentation_threads_test) {
+
+    //  Each pool thread counts its own calls, and the totals add up
+    //  over the threads.
+
+    financial::reset_stats();
+
+    financial::CashFlowSchedule sched;
+    sched.add(100, 1);
+    sched.add(100, 2);
+    const std::size_t num_tasks = 64;
+    financial::ThreadPool pool(4);
+    pool.parallel_for(num_tasks, [&](const std::size_t) {
+        financial::pv_stream(sched, 0.05);
+    });
+
+    const std::vector<financial::ThreadStats> stats =
+        financial::thread_stats();
+    const std::size_t index = static_cast<std::size_t>(probe::pv_stream);
+    uint64_t calls = 0;
+    std::size_t busy_threads = 0;
+    for ( std::size_t t = 0; t < stats.size(); ++t ) {
+        calls += stats[t].probes[index].calls;
+        if ( stats[t].probes[index].calls ) {
+            ++busy_threads;
+            BOOST_CHECK(stats[t].thread_number > 0);
+        }
+    }
+
+    if ( financial::instrumentation_enabled() ) {
+        BOOST_CHECK_EQUAL(num_tasks, calls);
+        BOOST_CHECK(busy_threads >= 1);
+        BOOST_CHECK_EQUAL(2 * num_tasks,
+                  financial::total_stats(probe::pv_stream).cashflows);
+    } else {
+        BOOST_CHECK_EQUAL(0u, calls);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(instrumentation_hook_test) {
+    financial::CashFlowSchedule sched;
+    sched.add(100, 1);
+
+    hook_calls = 0;
+    financial::set_trace_hook(count_pv_stream);
+    financial::pv_stream(sched, 0.05);
+    financial::pv_stream(sched, 0.06);
+    financial::pv(100, 0.05, 1);
+    financial::set_trace_hook(0);
+    financial::pv_stream(sched, 0.07);
+
+    if ( financial::instrumentation_enabled() ) {
+        BOOST_CHECK_EQUAL(2u, hook_calls);
+    } else {
+        BOOST_CHECK_EQUAL(0u, hook_calls);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
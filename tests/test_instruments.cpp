@@ -0,0 +1,292 @@
+/*
+ *  test_instruments.cpp
+ *  ====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *
+ *  Unit tests for the coupon bond instrument family and book.
+ *
+ *  Uses Boost unit testing framework.
+ *
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../bond.h"
+#include "../cashflow_schedule.h"
+#include "../instruments.h"
+#include "../thread_pool.h"
+#include "../yield_curve.h"
+
+namespace {
+
+//  Returns an upward sloping yield curve.
+
+financial::YieldCurve make_curve() {
+    std::vector<double> times;
+    std::vector<double> zero_rates;
+    for ( int i = 1; i <= 30; ++i ) {
+        times.push_back(i);
+        zero_rates.push_back(0.02 + 0.001 * i);
+    }
+    return financial::YieldCurve::from_zero_rates(times, zero_rates);
+}
+
+//  Returns a step-up bond whose coupon rises each period.
+
+financial::StepUpBond make_step_up(const int maturity) {
+    std::vector<double> coupons;
+    coupons.push_back(0.03);
+    coupons.push_back(0.035);
+    coupons.push_back(0.04);
+    return financial::StepUpBond(1000, coupons, 2, maturity);
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(instruments_suite)
+
+BOOST_AUTO_TEST_CASE(fixed_rate_bond_test1) {
+
+    //  A fixed rate bond is valued exactly as the simple bond on the
+    //  same terms, and its generic schedule agrees with the closed
+    //  form.
+
+    const double tolerance = 0.0000001;
+    const financial::YieldCurve curve = make_curve();
+    const int frequencies[] = {0, 1, 2, 12};
+    for ( int k = 0; k < 4; ++k ) {
+        const financial::SimpleBond simple(2500, 0.075, frequencies[k], 20);
+        const financial::FixedRateBond bond(simple);
+        BOOST_CHECK_EQUAL(bond.value(0.06), simple.value(0.06));
+        BOOST_CHECK_EQUAL(bond.value(curve), simple.value(curve));
+        BOOST_CHECK_CLOSE(financial::pv_stream(bond.schedule(0.06), 0.06),
+                          simple.value(0.06), tolerance);
+        BOOST_CHECK_EQUAL(bond.schedule(0.06).size(),
+                          simple.schedule().size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(value_on_grid_test1) {
+
+    //  Valuing from a grid filled from a curve gives exactly the value
+    //  against the curve itself.
+
+    const financial::YieldCurve curve = make_curve();
+    std::vector<double> grid;
+    for ( int k = 1; k <= 40; ++k ) {
+        grid.push_back(curve.discount_factor(static_cast<double>(k) / 4));
+    }
+    const financial::FixedRateBond fixed(1000, 0.05, 4, 10);
+    const financial::FloatingRateNote frn(1000, 0.003, 4, 10);
+    const financial::AmortizingBond amortizing(1000, 0.05, 4, 10);
+    BOOST_CHECK_EQUAL(fixed.value_on_grid(grid.data()), fixed.value(curve));
+    BOOST_CHECK_EQUAL(frn.value_on_grid(grid.data()), frn.value(curve));
+    BOOST_CHECK_EQUAL(amortizing.value_on_grid(grid.data()),
+                      amortizing.value(curve));
+}
+
+BOOST_AUTO_TEST_CASE(floating_rate_note_test1) {
+
+    //  With no spread, a floating rate note is worth par on any
+    //  curve, and a spread adds an annuity of the spread.
+
+    const double tolerance = 0.0000001;
+    const financial::YieldCurve curve = make_curve();
+    const financial::FloatingRateNote frn(1000, 0, 4, 10);
+    BOOST_CHECK_CLOSE(frn.value(0.05), 1000, tolerance);
+    BOOST_CHECK_CLOSE(frn.value(curve), 1000, tolerance);
+
+    const financial::FloatingRateNote spread_frn(1000, 0.004, 4, 10);
+    const financial::FixedRateBond spread_annuity(1000, 0.004, 4, 10);
+    BOOST_CHECK_CLOSE(spread_frn.value(curve),
+                      1000 + spread_annuity.value(curve) -
+                      1000 * curve.discount_factor(10), tolerance);
+
+    //  Coupons are the forward rates, which for a flat rate are
+    //  level.
+
+    const financial::CashFlowSchedule sched = frn.schedule(0.05);
+    BOOST_REQUIRE_EQUAL(sched.size(), 40u);
+    const double coupon = 1000 * (std::pow(1.05, 0.25) - 1);
+    BOOST_CHECK_CLOSE(sched[0].amount, coupon, tolerance);
+    BOOST_CHECK_CLOSE(sched[39].amount, coupon + 1000, tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_stream(frn.schedule(curve), curve),
+                      frn.value(curve), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(step_up_bond_test1) {
+    const double tolerance = 0.0000001;
+    const financial::StepUpBond bond = make_step_up(5);
+    const financial::CashFlowSchedule sched = bond.schedule(0.05);
+    BOOST_REQUIRE_EQUAL(sched.size(), 10u);
+    BOOST_CHECK_CLOSE(sched[1].amount, 15, tolerance);
+    BOOST_CHECK_CLOSE(sched[2].amount, 17.5, tolerance);
+    BOOST_CHECK_CLOSE(sched[5].amount, 20, tolerance);
+    BOOST_CHECK_CLOSE(sched[9].amount, 1020, tolerance);
+    BOOST_CHECK_CLOSE(financial::pv_stream(sched, 0.05), bond.value(0.05),
+                      tolerance);
+
+    //  With a single rate, a step-up bond is a fixed rate bond.
+
+    const financial::StepUpBond level(1000, std::vector<double>(1, 0.045),
+                                      2, 7);
+    const financial::FixedRateBond fixed(1000, 0.045, 2, 7);
+    BOOST_CHECK_CLOSE(level.value(0.05), fixed.value(0.05), tolerance);
+    BOOST_CHECK_CLOSE(level.value(make_curve()), fixed.value(make_curve()),
+                      tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(amortizing_bond_test1) {
+
+    //  The notional is repaid in equal instalments, with the coupon
+    //  paid on the notional outstanding.
+
+    const double tolerance = 0.0000001;
+    const financial::AmortizingBond bond(1200, 0.06, 4, 3);
+    const financial::CashFlowSchedule sched = bond.schedule(0.05);
+    BOOST_REQUIRE_EQUAL(sched.size(), 12u);
+    for ( int i = 0; i < 12; ++i ) {
+        const double outstanding = 1200 - 100 * i;
+        BOOST_CHECK_CLOSE(sched[i].amount, 100 + outstanding * 0.06 / 4,
+                          tolerance);
+        BOOST_CHECK_CLOSE(sched[i].time_period, (i + 1) / 4.0, tolerance);
+    }
+    BOOST_CHECK_CLOSE(financial::pv_stream(sched, 0.05), bond.value(0.05),
+                      tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(instruments_error_test1) {
+    BOOST_CHECK_THROW(financial::FloatingRateNote(1000, 0.001, 0, 5),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::AmortizingBond(1000, 0.05, 0, 5),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::StepUpBond(1000, std::vector<double>(),
+                                            2, 5),
+                      std::domain_error);
+    BOOST_CHECK_NO_THROW(financial::FixedRateBond(1000, 0.05, 0, 5));
+}
+
+BOOST_AUTO_TEST_CASE(instruments_error_test2) {
+
+    //  A bond maturing at issuance, or with a negative coupon
+    //  frequency, would be valued from an empty or nonexistent grid,
+    //  so is rejected, and a book holding other bonds is unaffected.
+
+    BOOST_CHECK_THROW(financial::FixedRateBond(1000, 0.05, 2, 0),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::FixedRateBond(1000, 0.05, 0, 0),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::FixedRateBond(1000, 0.05, -1, 5),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::FloatingRateNote(1000, 0.001, 4, 0),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::AmortizingBond(1000, 0.05, 12, -1),
+                      std::domain_error);
+    const std::vector<double> coupons(1, 0.05);
+    BOOST_CHECK_THROW(financial::StepUpBond(1000, coupons, -2, 5),
+                      std::domain_error);
+
+    const financial::YieldCurve curve = make_curve();
+    financial::InstrumentBook book;
+    book.add(financial::FixedRateBond(1000, 0.05, 2, 5));
+    BOOST_CHECK_THROW(book.add(financial::SimpleBond(1000, 0.05, 2, 0)),
+                      std::domain_error);
+    BOOST_CHECK_THROW(book.add(financial::SimpleBond(1000, 0.05, -1, 5)),
+                      std::domain_error);
+    BOOST_CHECK_EQUAL(1u, book.size());
+
+    const financial::PortfolioValuation val = book.value(curve);
+    BOOST_CHECK_EQUAL(1u, val.positions.size());
+    BOOST_CHECK_CLOSE(financial::FixedRateBond(1000, 0.05, 2, 5)
+                          .value(curve),
+                      val.total, 0.0000001);
+}
+
+BOOST_AUTO_TEST_CASE(instrument_book_test1) {
+
+    //  A mixed book gives each position exactly the quantity times
+    //  the bond's own value, in the order the positions were added,
+    //  on any number of threads.
+
+    const double tolerance = 0.0000001;
+    const financial::YieldCurve curve = make_curve();
+    financial::InstrumentBook book;
+    std::vector<double> expected_rate;
+    std::vector<double> expected_curve;
+    for ( int i = 0; i < 10000; ++i ) {
+        const double quantity = 1 + i % 4;
+        const int maturity = 1 + i % 25;
+        std::size_t index = 0;
+        switch ( i % 5 ) {
+            case 0: {
+                const financial::FixedRateBond bond(1000, 0.01 * (i % 9),
+                                                    2, maturity);
+                index = book.add(bond, quantity);
+                expected_rate.push_back(quantity * bond.value(0.045));
+                expected_curve.push_back(quantity * bond.value(curve));
+                break;
+            }
+            case 1: {
+                const financial::SimpleBond bond(1000, 0.05, 1, maturity);
+                index = book.add(bond, quantity);
+                expected_rate.push_back(quantity * bond.value(0.045));
+                expected_curve.push_back(quantity * bond.value(curve));
+                break;
+            }
+            case 2: {
+                const financial::FloatingRateNote bond(1000, 0.001 * (i % 5),
+                                                       4, maturity);
+                index = book.add(bond, quantity);
+                expected_rate.push_back(quantity * bond.value(0.045));
+                expected_curve.push_back(quantity * bond.value(curve));
+                break;
+            }
+            case 3: {
+                const financial::StepUpBond bond = make_step_up(maturity);
+                index = book.add(bond, quantity);
+                expected_rate.push_back(quantity * bond.value(0.045));
+                expected_curve.push_back(quantity * bond.value(curve));
+                break;
+            }
+            default: {
+                const financial::AmortizingBond bond(1000, 0.04, 12,
+                                                     maturity);
+                index = book.add(bond, quantity);
+                expected_rate.push_back(quantity * bond.value(0.045));
+                expected_curve.push_back(quantity * bond.value(curve));
+                break;
+            }
+        }
+        BOOST_REQUIRE_EQUAL(index, static_cast<std::size_t>(i));
+    }
+    BOOST_CHECK_EQUAL(book.size(), 10000u);
+
+    const financial::PortfolioValuation val = book.value(0.045);
+    const financial::PortfolioValuation curve_val = book.value(curve);
+    BOOST_REQUIRE_EQUAL(val.positions.size(), 10000u);
+    double expected_total = 0;
+    for ( std::size_t i = 0; i < expected_rate.size(); ++i ) {
+        BOOST_REQUIRE_EQUAL(val.positions[i], expected_rate[i]);
+        BOOST_REQUIRE_EQUAL(curve_val.positions[i], expected_curve[i]);
+        expected_total += expected_rate[i];
+    }
+    BOOST_CHECK_CLOSE(val.total, expected_total, tolerance);
+
+    const unsigned thread_counts[] = {2, 3, 4};
+    for ( int k = 0; k < 3; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        const financial::PortfolioValuation pval = book.value(0.045, pool);
+        BOOST_CHECK_EQUAL(pval.total, val.total);
+        BOOST_CHECK(pval.positions == val.positions);
+        BOOST_CHECK_EQUAL(book.value(curve, pool).total, curve_val.total);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
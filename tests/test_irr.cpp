@@ -0,0 +1,139 @@
+/*
+ *  test_irr.cpp
+ *  ============
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for internal rate of return functions.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../cashflow_schedule.h"
+#include "../thread_pool.h"
+#include "../irr.h"
+
+namespace {
+
+//  Returns a loan of 10000 repaid over the given number of periods at
+//  the given rate, from the lender's point of view.
+
+std::vector<financial::TimedCashFlow> make_loan(const double rate,
+                                                const int periods) {
+    const double payment = financial::loan_repayment(10000, rate, periods);
+    std::vector<financial::TimedCashFlow> cashflows;
+    cashflows.push_back(financial::TimedCashFlow(-10000, 0));
+    for ( int i = 1; i <= periods; ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(payment, i));
+    }
+    return cashflows;
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(irr_suite)
+
+BOOST_AUTO_TEST_CASE(irr_test1) {
+    const double tolerance = 0.0000001;
+
+    std::vector<financial::TimedCashFlow> simple;
+    simple.push_back(financial::TimedCashFlow(-1000, 0));
+    simple.push_back(financial::TimedCashFlow(1100, 1));
+    BOOST_CHECK_CLOSE(0.1, financial::irr(simple), tolerance);
+
+    const double rates[] = {-0.05, 0.001, 0.05, 0.25, 2.5};
+    const double guesses[] = {-0.9, 0, 0.1, 5};
+    for ( int i = 0; i < 5; ++i ) {
+        const std::vector<financial::TimedCashFlow> loan =
+            make_loan(rates[i], 20);
+        const financial::CashFlowSchedule sched(loan);
+        for ( int g = 0; g < 4; ++g ) {
+            BOOST_CHECK_CLOSE(rates[i], financial::irr(loan, guesses[g]),
+                              tolerance);
+            BOOST_CHECK_CLOSE(rates[i], financial::irr(sched, guesses[g]),
+                              tolerance);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(irr_test2) {
+
+    //  The usual spreadsheet XIRR example, with days counted from
+    //  1 January 2008.
+
+    const double tolerance = 0.000001;
+    std::vector<financial::TimedCashFlow> dated;
+    dated.push_back(financial::TimedCashFlow(-10000, 0));
+    dated.push_back(financial::TimedCashFlow(2750, 60));
+    dated.push_back(financial::TimedCashFlow(4250, 303));
+    dated.push_back(financial::TimedCashFlow(3250, 411));
+    dated.push_back(financial::TimedCashFlow(2750, 456));
+    BOOST_CHECK_CLOSE(0.373362535, financial::xirr(dated), tolerance);
+
+    //  Only the differences between days matter.
+
+    std::vector<financial::TimedCashFlow> shifted(dated);
+    for ( std::size_t i = 0; i < shifted.size(); ++i ) {
+        shifted[i].time_period += 39448;
+    }
+    BOOST_CHECK_CLOSE(financial::xirr(dated), financial::xirr(shifted),
+                      tolerance);
+    BOOST_CHECK_CLOSE(financial::xirr(dated),
+                      financial::xirr(financial::CashFlowSchedule(shifted)),
+                      tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(irr_test3) {
+    std::vector<financial::TimedCashFlow> positive;
+    positive.push_back(financial::TimedCashFlow(100, 0));
+    positive.push_back(financial::TimedCashFlow(100, 1));
+    std::vector<financial::TimedCashFlow> same_time;
+    same_time.push_back(financial::TimedCashFlow(-100, 1));
+    same_time.push_back(financial::TimedCashFlow(100, 1));
+    const std::vector<financial::TimedCashFlow> none;
+    BOOST_CHECK_THROW(financial::irr(positive), std::domain_error);
+    BOOST_CHECK_THROW(financial::irr(same_time), std::domain_error);
+    BOOST_CHECK_THROW(financial::xirr(none), std::domain_error);
+    BOOST_CHECK_THROW(financial::irr(make_loan(0.05, 10), -1),
+                      std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(irr_test4) {
+
+    //  Batched solves match single solves, with a NaN for a stream
+    //  which has no rate, on any number of threads.
+
+    std::vector<std::vector<financial::TimedCashFlow> > streams;
+    for ( int i = 0; i < 500; ++i ) {
+        streams.push_back(make_loan(0.001 * (1 + i % 97), 5 + i % 31));
+    }
+    streams[123].clear();
+
+    const unsigned thread_counts[] = {1, 2, 3};
+    for ( int k = 0; k < 3; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        const std::vector<double> rates = financial::irr(streams, pool);
+        const std::vector<double> xrates = financial::xirr(streams, pool);
+        BOOST_CHECK_EQUAL(streams.size(), rates.size());
+        for ( std::size_t i = 0; i < streams.size(); ++i ) {
+            if ( i == 123 ) {
+                BOOST_CHECK(std::isnan(rates[i]));
+                BOOST_CHECK(std::isnan(xrates[i]));
+            } else {
+                BOOST_CHECK_EQUAL(financial::irr(streams[i]), rates[i]);
+                BOOST_CHECK_EQUAL(financial::xirr(streams[i]), xrates[i]);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+/*
+ *  test_portfolio.cpp
+ *  ==================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for bond portfolio pricing engine.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include "../bond.h"
+#include "../portfolio.h"
+#include "../thread_pool.h"
+
+namespace {
+
+//  Returns a varied collection of bonds.
+
+std::vector<financial::SimpleBond> make_bonds(const int num_bonds) {
+    const int frequencies[] = {0, 1, 2, 4, 12};
+    std::vector<financial::SimpleBond> bonds;
+    for ( int i = 0; i < num_bonds; ++i ) {
+        bonds.push_back(financial::SimpleBond(1000 + 10 * (i % 17),
+                                              0.01 * (i % 9),
+                                              frequencies[i % 5],
+                                              1 + i % 30));
+    }
+    return bonds;
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(portfolio_suite)
+
+BOOST_AUTO_TEST_CASE(portfolio_test1) {
+    const double tolerance = 0.0000001;
+    const std::vector<financial::SimpleBond> bonds = make_bonds(500);
+
+    financial::Portfolio book;
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        BOOST_CHECK_EQUAL(book.add(bonds[i], 1 + i % 4), i);
+    }
+    BOOST_CHECK_EQUAL(book.size(), bonds.size());
+
+    const financial::PortfolioValuation val = book.value(0.055);
+    BOOST_REQUIRE_EQUAL(val.positions.size(), bonds.size());
+
+    double expected_total = 0;
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        const double expected_result = bonds[i].value(0.055) * (1 + i % 4);
+        BOOST_CHECK_CLOSE(expected_result, val.positions[i], tolerance);
+        expected_total += expected_result;
+    }
+    BOOST_CHECK_CLOSE(expected_total, val.total, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(portfolio_test2) {
+    const std::vector<financial::SimpleBond> bonds = make_bonds(60000);
+
+    financial::Portfolio book;
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        book.add(bonds[i], 0.5 + i % 3);
+    }
+
+    const financial::PortfolioValuation expected = book.value(0.0425);
+    const unsigned thread_counts[] = {1, 2, 3, 8};
+    for ( int k = 0; k < 4; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        const financial::PortfolioValuation test = book.value(0.0425, pool);
+        BOOST_CHECK_EQUAL(expected.total, test.total);
+        BOOST_CHECK(expected.positions == test.positions);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(portfolio_test3) {
+    const financial::Portfolio book;
+    financial::ThreadPool pool(2);
+    const financial::PortfolioValuation val = book.value(0.05, pool);
+    BOOST_CHECK_EQUAL(val.total, 0);
+    BOOST_CHECK(val.positions.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,123 @@
+/*
+ *  test_price_and_risk.cpp
+ *  =======================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for price_and_risk() functions.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <vector>
+#include "../basic_dcf.h"
+#include "../bond.h"
+#include "../cashflow_schedule.h"
+#include "../portfolio.h"
+#include "../thread_pool.h"
+
+BOOST_AUTO_TEST_SUITE(price_and_risk_suite)
+
+BOOST_AUTO_TEST_CASE(price_and_risk_test1) {
+    const double tolerance = 0.0001;
+    const financial::SimpleBond bond(4000, 0.05, 1, 5);
+    const financial::RiskMeasures risk = bond.price_and_risk(0.05);
+    BOOST_CHECK_CLOSE(risk.pv, 4000, tolerance);
+    BOOST_CHECK_CLOSE(risk.macaulay_duration, 4.545951, tolerance);
+    BOOST_CHECK_CLOSE(risk.modified_duration, 4.329477, tolerance);
+    BOOST_CHECK_CLOSE(risk.dv01, 4000 * 4.329477 * 0.0001, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(price_and_risk_test2) {
+    const double tolerance = 0.0001;
+    const double r = 0.065;
+    const double h = 0.00001;
+
+    std::vector<financial::TimedCashFlow> cfs;
+    for ( int i = 1; i <= 24; ++i ) {
+        cfs.push_back(financial::TimedCashFlow(i % 5 ? 30 : -45, 0.5 * i));
+    }
+    cfs.push_back(financial::TimedCashFlow(1000, 12));
+
+    const double pv = financial::pv_stream(cfs, r);
+    const double pv_up = financial::pv_stream(cfs, r + h);
+    const double pv_down = financial::pv_stream(cfs, r - h);
+    const double first = (pv_up - pv_down) / (2 * h);
+    const double second = (pv_up - 2 * pv + pv_down) / (h * h);
+
+    const financial::RiskMeasures risk = financial::price_and_risk(cfs, r);
+    BOOST_CHECK_CLOSE(risk.pv, pv, tolerance);
+    BOOST_CHECK_CLOSE(risk.modified_duration, -first / pv, tolerance);
+    BOOST_CHECK_CLOSE(risk.macaulay_duration, -first * (1 + r) / pv,
+                      tolerance);
+    BOOST_CHECK_CLOSE(risk.convexity, second / pv, 0.01);
+    BOOST_CHECK_CLOSE(risk.dv01, -first * 0.0001, tolerance);
+
+    const financial::CashFlowSchedule sched(cfs);
+    const financial::RiskMeasures sched_risk = financial::price_and_risk(
+            sched, r);
+    BOOST_CHECK_CLOSE(sched_risk.pv, risk.pv, 0.0000001);
+    BOOST_CHECK_CLOSE(sched_risk.modified_duration, risk.modified_duration,
+                      0.0000001);
+    BOOST_CHECK_CLOSE(sched_risk.convexity, risk.convexity, 0.0000001);
+}
+
+BOOST_AUTO_TEST_CASE(price_and_risk_test3) {
+    const double tolerance = 0.0000001;
+    const financial::SimpleBond bonds[] = {
+        financial::SimpleBond(2500, 0.075, 2, 20),
+        financial::SimpleBond(7500, 0, 0, 10),
+        financial::SimpleBond(1000, 0.04, 12, 3)
+    };
+
+    for ( int i = 0; i < 3; ++i ) {
+        const financial::RiskMeasures expected = financial::price_and_risk(
+                bonds[i].schedule(), 0.06);
+        const financial::RiskMeasures test = bonds[i].price_and_risk(0.06);
+        BOOST_CHECK_CLOSE(expected.pv, test.pv, tolerance);
+        BOOST_CHECK_CLOSE(expected.pv, bonds[i].value(0.06), tolerance);
+        BOOST_CHECK_CLOSE(expected.macaulay_duration,
+                          test.macaulay_duration, tolerance);
+        BOOST_CHECK_CLOSE(expected.convexity, test.convexity, tolerance);
+        BOOST_CHECK_CLOSE(expected.dv01, test.dv01, tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(price_and_risk_portfolio_test) {
+    const double tolerance = 0.0000001;
+    const int frequencies[] = {0, 1, 2, 4};
+
+    financial::Portfolio book;
+    std::vector<financial::SimpleBond> bonds;
+    for ( int i = 0; i < 9000; ++i ) {
+        bonds.push_back(financial::SimpleBond(1000, 0.01 * (i % 7),
+                                              frequencies[i % 4],
+                                              1 + i % 11));
+        book.add(bonds.back(), 2);
+    }
+
+    const financial::PortfolioRisk risk = book.price_and_risk(0.05);
+    BOOST_REQUIRE_EQUAL(risk.positions.size(), bonds.size());
+
+    double dv01_total = 0;
+    for ( std::size_t i = 0; i < bonds.size(); ++i ) {
+        const financial::RiskMeasures expected = bonds[i].price_and_risk(0.05);
+        BOOST_CHECK_CLOSE(2 * expected.pv, risk.positions[i].pv, tolerance);
+        BOOST_CHECK_CLOSE(expected.modified_duration,
+                          risk.positions[i].modified_duration, tolerance);
+        dv01_total += 2 * expected.dv01;
+    }
+    BOOST_CHECK_CLOSE(risk.total.pv, book.value(0.05).total, tolerance);
+    BOOST_CHECK_CLOSE(risk.total.dv01, dv01_total, tolerance);
+
+    financial::ThreadPool pool(3);
+    const financial::PortfolioRisk prisk = book.price_and_risk(0.05, pool);
+    BOOST_CHECK_EQUAL(prisk.total.pv, risk.total.pv);
+    BOOST_CHECK_EQUAL(prisk.total.convexity, risk.total.convexity);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
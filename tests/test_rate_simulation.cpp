@@ -0,0 +1,158 @@
+/*
+ *  test_rate_simulation.cpp
+ *  ========================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for Monte Carlo interest rate simulation.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <stdint.h>
+#include <boost/test/unit_test.hpp>
+#include "../cashflow_schedule.h"
+#include "../philox.h"
+#include "../thread_pool.h"
+#include "../yield_curve.h"
+#include "../rate_simulation.h"
+
+namespace {
+
+financial::YieldCurve make_curve() {
+    const std::vector<double> times = {0.5, 1, 2, 3, 5, 7, 10, 20, 30};
+    const std::vector<double> zeros = {0.031, 0.033, 0.036, 0.038, 0.041,
+                                       0.043, 0.044, 0.046, 0.045};
+    return financial::YieldCurve::from_zero_rates(times, zeros);
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(rate_simulation_suite)
+
+BOOST_AUTO_TEST_CASE(rate_simulation_test1) {
+
+    //  Known answers for Philox4x32-10 from the Random123 distribution.
+
+    uint32_t out[4];
+    financial::Philox4x32(0)(0, 0, 0, 0, out);
+    BOOST_CHECK_EQUAL(0x6627e8d5u, out[0]);
+    BOOST_CHECK_EQUAL(0xe169c58du, out[1]);
+    BOOST_CHECK_EQUAL(0xbc57ac4cu, out[2]);
+    BOOST_CHECK_EQUAL(0x9b00dbd8u, out[3]);
+
+    financial::Philox4x32(0xffffffffffffffffULL)(0xffffffff, 0xffffffff,
+                                                 0xffffffff, 0xffffffff,
+                                                 out);
+    BOOST_CHECK_EQUAL(0x408f276du, out[0]);
+    BOOST_CHECK_EQUAL(0x41c83b0eu, out[1]);
+    BOOST_CHECK_EQUAL(0xa20bc7c6u, out[2]);
+    BOOST_CHECK_EQUAL(0x6d5451fdu, out[3]);
+}
+
+BOOST_AUTO_TEST_CASE(rate_simulation_test2) {
+
+    //  With no volatility, a Vasicek path discounts at the integral of
+    //  the deterministic short rate.
+
+    const double tolerance = 0.0000001;
+    const double r0 = 0.02;
+    const double a = 0.3;
+    const double b = 0.05;
+    const financial::ShortRateModel model(r0, a, b, 0);
+    const financial::RateSimulation sim(model, 10, 4, 100, 7);
+    BOOST_CHECK_EQUAL(40u, sim.num_steps());
+
+    std::vector<double> dfs(sim.num_steps() + 1);
+    sim.path_discount_factors(17, dfs.data());
+    for ( std::size_t k = 0; k < dfs.size(); ++k ) {
+        const double t = k * sim.step();
+        const double integral = b * t + (r0 - b) * (1 - std::exp(-a * t)) / a;
+        BOOST_CHECK_CLOSE(std::exp(-integral), dfs[k], tolerance);
+    }
+
+    financial::CashFlowSchedule sched;
+    sched.add(100, 0);
+    sched.add(100, 2.6);
+    sched.add(100, 10);
+    const financial::PvDistribution dist = sim.pv_stream(sched);
+    BOOST_CHECK_EQUAL(100u, dist.values.size());
+    BOOST_CHECK_SMALL(dist.std_dev, 0.0000001);
+    BOOST_CHECK_CLOSE(dist.min, dist.max, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(rate_simulation_test3) {
+
+    //  A Hull-White model reprices its initial curve on average.
+
+    const financial::YieldCurve curve = make_curve();
+    const financial::ShortRateModel model(curve, 0.1, 0.01);
+    const financial::RateSimulation sim(model, 20, 12, 20000, 2013);
+
+    const double maturities[] = {1, 5, 12.5, 20};
+    for ( int i = 0; i < 4; ++i ) {
+        financial::CashFlowSchedule sched;
+        sched.add(1, maturities[i]);
+        const financial::PvDistribution dist = sim.pv_stream(sched);
+        BOOST_CHECK_SMALL(dist.mean - curve.discount_factor(maturities[i]),
+                          4 * dist.std_error);
+        BOOST_CHECK(dist.std_dev > 0);
+        BOOST_CHECK(dist.min <= dist.quantile(0.01));
+        BOOST_CHECK(dist.quantile(0.01) < dist.quantile(0.5));
+        BOOST_CHECK(dist.quantile(0.5) < dist.quantile(0.99));
+        BOOST_CHECK_EQUAL(dist.max, dist.quantile(1));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(rate_simulation_test4) {
+
+    //  Results depend only on the seed, not on the number of threads.
+
+    const financial::ShortRateModel model(make_curve(), 0.05, 0.012);
+    const financial::RateSimulation sim(model, 30, 12, 3000, 99);
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i <= 60; ++i ) {
+        sched.add(25, 0.5 * i);
+    }
+
+    const financial::PvDistribution expected = sim.pv_stream(sched);
+    const unsigned thread_counts[] = {1, 2, 3};
+    for ( int k = 0; k < 3; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        const financial::PvDistribution test = sim.pv_stream(sched, pool);
+        BOOST_CHECK(expected.values == test.values);
+        BOOST_CHECK_EQUAL(expected.mean, test.mean);
+        BOOST_CHECK_EQUAL(expected.std_dev, test.std_dev);
+    }
+
+    const financial::RateSimulation other(model, 30, 12, 3000, 100);
+    BOOST_CHECK(expected.values != other.pv_stream(sched).values);
+}
+
+BOOST_AUTO_TEST_CASE(rate_simulation_test5) {
+    const financial::ShortRateModel model(0.03, 0.2, 0.04, 0.01);
+    BOOST_CHECK_THROW(financial::ShortRateModel(0.03, 0, 0.04, 0.01),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::ShortRateModel(0.03, 0.2, 0.04, -0.01),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::RateSimulation(model, 0, 12, 10, 1),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::RateSimulation(model, 5, 12, 0, 1),
+                      std::domain_error);
+
+    const financial::RateSimulation sim(model, 5, 12, 10, 1);
+    financial::CashFlowSchedule sched;
+    sched.add(100, 5.5);
+    BOOST_CHECK_THROW(sim.pv_stream(sched), std::domain_error);
+    BOOST_CHECK_THROW(financial::PvDistribution().quantile(0.5),
+                      std::domain_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -13,7 +13,12 @@
  */
 
 #include <boost/test/unit_test.hpp>
+#include <cmath>
+#include <stdexcept>
+#include "../basic_dcf.h"
 #include "../bond.h"
+#include "../cashflow_schedule.h"
+#include "alloc_counter.h"
 
 BOOST_AUTO_TEST_SUITE(simple_bond_suite)
 
@@ -41,4 +46,190 @@ BOOST_AUTO_TEST_CASE(simple_bond_test3) {
     BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
 }
 
+BOOST_AUTO_TEST_CASE(simple_bond_test4) {
+    const double tolerance = 0.0000001;
+    const double expected_result = 2500;
+    const financial::SimpleBond bond(2500, 0.06, 4, 7);
+    const double test_result = bond.value(0.06136355);
+    BOOST_CHECK_CLOSE(expected_result, test_result, 0.000001);
+    BOOST_CHECK_CLOSE(bond.value(0), 2500 * (1 + 0.06 * 7), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_schedule_test1) {
+    const double tolerance = 0.0000001;
+    const financial::SimpleBond bond(2500, 0.075, 2, 20);
+
+    const financial::CashFlowSchedule& sched = bond.schedule();
+    BOOST_REQUIRE_EQUAL(sched.size(), 40u);
+    BOOST_CHECK_CLOSE(sched[0].amount, 93.75, tolerance);
+    BOOST_CHECK_CLOSE(sched[0].time_period, 0.5, tolerance);
+    BOOST_CHECK_CLOSE(sched[39].amount, 2593.75, tolerance);
+    BOOST_CHECK_CLOSE(sched[39].time_period, 20, tolerance);
+
+    const double expected_result = bond.value(0.06);
+    const double test_result = financial::pv_stream(sched, 0.06);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_schedule_test2) {
+    const financial::SimpleBond bond(7500, 0, 0, 10);
+    const financial::CashFlowSchedule& sched = bond.schedule();
+    BOOST_REQUIRE_EQUAL(sched.size(), 1u);
+    BOOST_CHECK_EQUAL(sched[0].amount, 7500);
+    BOOST_CHECK_EQUAL(sched[0].time_period, 10);
+
+    const std::size_t before = alloc_counter::allocations();
+    BOOST_CHECK_EQUAL(&bond.schedule(), &sched);
+    BOOST_CHECK_EQUAL(alloc_counter::allocations(), before);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_schedule_test3) {
+
+    //  The schedule values to the same price as the bond, for every
+    //  coupon frequency and maturity the bond accepts.
+
+    const double tolerance = 0.0000001;
+    const int frequencies[] = {0, 1, 2, 4, 12};
+    const int maturities[] = {1, 2, 7, 30};
+    for ( int f = 0; f < 5; ++f ) {
+        for ( int m = 0; m < 4; ++m ) {
+            const financial::SimpleBond bond(1000, 0.05, frequencies[f],
+                                             maturities[m]);
+            const double test_result =
+                financial::pv_stream(bond.schedule(), 0.06);
+            BOOST_CHECK_CLOSE(bond.value(0.06), test_result, tolerance);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_error_test) {
+    BOOST_CHECK_THROW(financial::SimpleBond(1000, 0.05, 2, 0),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::SimpleBond(1000, 0.05, 0, 0),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::SimpleBond(1000, 0.05, 2, -1),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::SimpleBond(1000, 0.05, -2, 3),
+                      std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_allocation_test) {
+    const financial::SimpleBond bond(2500, 0.075, 2, 20);
+
+    const std::size_t before = alloc_counter::allocations();
+    double total = 0;
+    for ( int i = 0; i < 10000; ++i ) {
+        total += bond.value(0.04 + i * 0.000001);
+    }
+    const std::size_t after = alloc_counter::allocations();
+
+    BOOST_CHECK_EQUAL(after - before, 0u);
+    BOOST_CHECK(total > 0);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_settlement_test1) {
+
+    //  At issuance the dirty and clean prices are the value, and on
+    //  a coupon date there is no accrued interest, so a bond with its
+    //  coupon equal to the discount rate prices at par.
+
+    const double tolerance = 0.0000001;
+    const financial::SimpleBond bond(2500, 0.075, 2, 20);
+    BOOST_CHECK_CLOSE(bond.value(0.06), bond.dirty_price(0.06, 0),
+                      tolerance);
+    BOOST_CHECK_CLOSE(bond.value(0.06), bond.clean_price(0.06, 0),
+                      tolerance);
+
+    const double par_rate = std::pow(1 + 0.075 / 2, 2) - 1;
+    const double coupon_dates[] = {0, 0.5, 7, 13.5, 19.5};
+    for ( int i = 0; i < 5; ++i ) {
+        BOOST_CHECK_EQUAL(bond.accrued_interest(coupon_dates[i]), 0);
+        BOOST_CHECK_CLOSE(bond.clean_price(par_rate, coupon_dates[i]),
+                          2500, tolerance);
+    }
+    BOOST_CHECK_EQUAL(bond.dirty_price(0.06, 20), 0);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_settlement_test2) {
+
+    //  Between coupon dates, the dirty price is the value at
+    //  settlement of the remaining cash flows, and the accrued interest
+    //  is the coupon accrued since the last coupon date.
+
+    const double tolerance = 0.0000001;
+    const financial::SimpleBond bond(1000, 0.05, 4, 10);
+    const double settlement = 3.1;
+
+    double expected_dirty = 0;
+    for ( int cp = 13; cp <= 40; ++cp ) {
+        const double amount = ( cp == 40 ) ? 1012.5 : 12.5;
+        expected_dirty += financial::pv(amount, 0.045,
+                                        cp / 4.0 - settlement);
+    }
+    const double expected_accrued = 12.5 * 0.4;
+
+    BOOST_CHECK_CLOSE(expected_dirty, bond.dirty_price(0.045, settlement),
+                      tolerance);
+    BOOST_CHECK_CLOSE(expected_accrued, bond.accrued_interest(settlement),
+                      tolerance);
+    BOOST_CHECK_CLOSE(expected_dirty - expected_accrued,
+                      bond.clean_price(0.045, settlement), tolerance);
+
+    const financial::SimpleBond zero(7500, 0, 0, 10);
+    BOOST_CHECK_EQUAL(zero.accrued_interest(4.3), 0);
+    BOOST_CHECK_CLOSE(zero.dirty_price(0.06, 4.3),
+                      financial::pv(7500, 0.06, 5.7), tolerance);
+
+    BOOST_CHECK_THROW(bond.dirty_price(0.045, -0.1), std::domain_error);
+    BOOST_CHECK_THROW(bond.clean_price(0.045, 10.1), std::domain_error);
+    BOOST_CHECK_THROW(bond.accrued_interest(11), std::domain_error);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_settlement_allocation_test) {
+
+    //  Once the schedule is built, daily revaluation of an aging bond
+    //  allocates nothing.
+
+    const financial::SimpleBond bond(2500, 0.075, 2, 20);
+    bond.schedule();
+
+    const std::size_t before = alloc_counter::allocations();
+    double total = 0;
+    for ( int day = 0; day < 20 * 365; ++day ) {
+        total += bond.clean_price(0.06, day / 365.0);
+    }
+    const std::size_t after = alloc_counter::allocations();
+
+    BOOST_CHECK_EQUAL(after - before, 0u);
+    BOOST_CHECK(total > 0);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_ytm_test1) {
+    const double tolerance = 0.0000001;
+    const double expected_result = 0.06;
+    const financial::SimpleBond bond(2500, 0.075, 2, 20);
+    const double test_result = bond.yield_to_maturity(2961.911306);
+    BOOST_CHECK_CLOSE(expected_result, test_result, 0.00001);
+    BOOST_CHECK_CLOSE(bond.value(test_result), 2961.911306, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_ytm_test2) {
+    const double tolerance = 0.0000001;
+    const double expected_result = 0.06;
+    const financial::SimpleBond bond(7500, 0, 0, 10);
+    const double test_result = bond.yield_to_maturity(4187.960827);
+    BOOST_CHECK_CLOSE(expected_result, test_result, tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(simple_bond_ytm_test3) {
+    const double tolerance = 0.0000001;
+    const financial::SimpleBond bond(1000, 0.05, 4, 30);
+    const double prices[] = {1, 150, 800, 1000, 1600, 5000, 6900};
+    for ( int i = 0; i < 7; ++i ) {
+        const double ytm = bond.yield_to_maturity(prices[i]);
+        BOOST_CHECK_CLOSE(bond.value(ytm), prices[i], tolerance);
+    }
+    BOOST_CHECK_THROW(bond.yield_to_maturity(0), std::domain_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,97 @@
+/*
+ *  test_thread_pool.cpp
+ *  ====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for work-stealing thread pool.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+#include "../thread_pool.h"
+
+BOOST_AUTO_TEST_SUITE(thread_pool_suite)
+
+BOOST_AUTO_TEST_CASE(thread_pool_test1) {
+    const unsigned thread_counts[] = {1, 2, 4, 7};
+
+    for ( int k = 0; k < 4; ++k ) {
+        financial::ThreadPool pool(thread_counts[k]);
+        BOOST_CHECK_EQUAL(pool.size(), thread_counts[k]);
+
+        for ( std::size_t n = 0; n < 50; n += 7 ) {
+            std::vector<int> runs(n, 0);
+            pool.parallel_for(n, [&](std::size_t i) { ++runs[i]; });
+            for ( std::size_t i = 0; i < n; ++i ) {
+                BOOST_CHECK_EQUAL(runs[i], 1);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_test2) {
+    financial::ThreadPool pool(4);
+    std::atomic<unsigned long> total(0);
+
+    //  Make the first tasks much slower than the rest, so that
+    //  the threads which own them must have work stolen from them.
+
+    pool.parallel_for(1000, [&](std::size_t i) {
+        unsigned long sum = 0;
+        const unsigned long work = i < 250 ? 20000 : 10;
+        for ( unsigned long j = 0; j < work; ++j ) {
+            sum += j % 3;
+        }
+        total += (sum > 0 ? i : 0);
+    });
+    BOOST_CHECK_EQUAL(total.load(), 999ul * 1000 / 2);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_test3) {
+    financial::ThreadPool pool(3);
+    BOOST_CHECK_THROW(pool.parallel_for(100, [](std::size_t i) {
+        if ( i == 42 ) {
+            throw std::runtime_error("task failed");
+        }
+    }), std::runtime_error);
+
+    std::atomic<int> count(0);
+    pool.parallel_for(100, [&](std::size_t) { ++count; });
+    BOOST_CHECK_EQUAL(count.load(), 100);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_test4) {
+
+    //  A task which calls back into its own pool runs the nested tasks
+    //  itself, rather than deadlocking, and nested exceptions reach
+    //  the outer call.
+
+    financial::ThreadPool pool(4);
+    std::atomic<unsigned long> total(0);
+    pool.parallel_for(20, [&](std::size_t i) {
+        pool.parallel_for(50, [&](std::size_t j) { total += i * 50 + j; });
+    });
+    BOOST_CHECK_EQUAL(total.load(), 999ul * 1000 / 2);
+
+    BOOST_CHECK_THROW(pool.parallel_for(10, [&](std::size_t) {
+        pool.parallel_for(10, [](std::size_t j) {
+            if ( j == 3 ) {
+                throw std::runtime_error("task failed");
+            }
+        });
+    }), std::runtime_error);
+
+    std::atomic<int> count(0);
+    pool.parallel_for(100, [&](std::size_t) { ++count; });
+    BOOST_CHECK_EQUAL(count.load(), 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,206 @@
+/*
+ *  test_yield_curve.cpp
+ *  ====================
+ *  Copyright 2013 Paul Griffiths
+ *  Email: mail@paulgriffiths.net
+ *  
+ *  Unit tests for yield curves.
+ *
+ *  Uses Boost unit testing framework.
+ *  
+ *  Distributed under the terms of the GNU General Public License.
+ *  http://www.gnu.org/licenses/
+ */
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include "../basic_dcf.h"
+#include "../bond.h"
+#include "../cashflow_schedule.h"
+#include "../yield_curve.h"
+
+namespace {
+
+const financial::curve_interpolation interpolations[] = {
+    financial::curve_interpolation::log_linear,
+    financial::curve_interpolation::monotone_cubic
+};
+
+std::vector<double> pillar_times() {
+    const double times[] = {0.25, 0.5, 1, 2, 3, 5, 7, 10, 20, 30};
+    return std::vector<double>(times, times + sizeof(times) / sizeof(*times));
+}
+
+std::vector<double> upward_zeros() {
+    const double zeros[] = {0.030, 0.031, 0.033, 0.036, 0.038,
+                            0.041, 0.043, 0.044, 0.046, 0.045};
+    return std::vector<double>(zeros, zeros + sizeof(zeros) / sizeof(*zeros));
+}
+
+}           //  namespace
+
+BOOST_AUTO_TEST_SUITE(yield_curve_suite)
+
+BOOST_AUTO_TEST_CASE(yield_curve_test1) {
+
+    //  A flat curve discounts as a flat rate, between, at and beyond
+    //  the pillars, with either interpolation method.
+
+    const double tolerance = 0.0000001;
+    const std::vector<double> times = pillar_times();
+    const std::vector<double> flat(times.size(), 0.05);
+
+    financial::CashFlowSchedule sched;
+    for ( int i = 1; i <= 80; ++i ) {
+        sched.add(40, 0.5 * i);
+    }
+    const financial::SimpleBond bond(1000, 0.06, 2, 25);
+
+    for ( int m = 0; m < 2; ++m ) {
+        const financial::YieldCurve curve =
+            financial::YieldCurve::from_zero_rates(times, flat,
+                                                   interpolations[m]);
+        const double test_times[] = {0.1, 0.25, 1.7, 4, 12.5, 30, 45};
+        for ( int i = 0; i < 7; ++i ) {
+            BOOST_CHECK_CLOSE(financial::discount_factor(0.05,
+                                                         test_times[i]),
+                              curve.discount_factor(test_times[i]),
+                              tolerance);
+            BOOST_CHECK_CLOSE(0.05, curve.zero_rate(test_times[i]),
+                              tolerance);
+        }
+        BOOST_CHECK_CLOSE(financial::pv_stream(sched, 0.05),
+                          financial::pv_stream(sched, curve), tolerance);
+        BOOST_CHECK_CLOSE(bond.value(0.05), bond.value(curve), tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(yield_curve_test2) {
+
+    //  Both methods reprice the pillars, and log-linear interpolation
+    //  is linear in log(DF) between them.
+
+    const double tolerance = 0.0000001;
+    const std::vector<double> times = pillar_times();
+    const std::vector<double> zeros = upward_zeros();
+
+    for ( int m = 0; m < 2; ++m ) {
+        const financial::YieldCurve curve =
+            financial::YieldCurve::from_zero_rates(times, zeros,
+                                                   interpolations[m]);
+        BOOST_CHECK_EQUAL(times.size(), curve.size());
+        for ( std::size_t i = 0; i < times.size(); ++i ) {
+            BOOST_CHECK_EQUAL(times[i], curve.pillar_time(i));
+            BOOST_CHECK_CLOSE(zeros[i], curve.zero_rate(times[i]),
+                              tolerance);
+        }
+    }
+
+    const financial::YieldCurve curve =
+        financial::YieldCurve::from_zero_rates(times, zeros);
+    const double mid = (std::log(curve.pillar_discount_factor(5)) +
+                        std::log(curve.pillar_discount_factor(6))) / 2;
+    BOOST_CHECK_CLOSE(std::exp(mid), curve.discount_factor(6), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(yield_curve_test3) {
+
+    //  Monotone cubic interpolation keeps discount factors decreasing
+    //  when forward rates are positive, and gives forward rates which
+    //  are continuous at the pillars.
+
+    const std::vector<double> times = pillar_times();
+    const financial::YieldCurve curve =
+        financial::YieldCurve::from_zero_rates(times, upward_zeros(),
+                financial::curve_interpolation::monotone_cubic);
+
+    bool decreasing = true;
+    double previous = 1;
+    for ( int i = 1; i <= 4000; ++i ) {
+        const double df = curve.discount_factor(0.01 * i);
+        decreasing = decreasing && df < previous;
+        previous = df;
+    }
+    BOOST_CHECK(decreasing);
+
+    const double h = 0.000001;
+    for ( std::size_t i = 0; i + 1 < times.size(); ++i ) {
+        const double t = times[i];
+        const double left = (curve.log_discount(t) -
+                             curve.log_discount(t - h)) / h;
+        const double right = (curve.log_discount(t + h) -
+                              curve.log_discount(t)) / h;
+        BOOST_CHECK_SMALL(left - right, 0.00001);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(yield_curve_test4) {
+    const double tolerance = 0.0000001;
+    const financial::YieldCurve curve =
+        financial::YieldCurve::from_zero_rates(pillar_times(),
+                upward_zeros(), financial::curve_interpolation::monotone_cubic,
+                financial::disc_type::continuous);
+    BOOST_CHECK_CLOSE(std::exp(-0.044 * 10), curve.discount_factor(10),
+                      tolerance);
+
+    std::vector<financial::TimedCashFlow> cashflows;
+    for ( int i = 0; i < 1000; ++i ) {
+        cashflows.push_back(financial::TimedCashFlow(10 + i % 9,
+                                                     0.037 * i));
+    }
+    BOOST_CHECK_CLOSE(financial::pv_stream(cashflows, curve),
+                      financial::pv_stream(financial::CashFlowSchedule(
+                                           cashflows), curve), tolerance);
+}
+
+BOOST_AUTO_TEST_CASE(yield_curve_at_test) {
+
+    //  Valuing at a later time discounts the remaining cash flows at
+    //  the curve's discount factors for their times after it.
+
+    const double tolerance = 0.0000001;
+    const financial::SimpleBond bond(1000, 0.06, 2, 25);
+    const financial::CashFlowSchedule& sched = bond.schedule();
+    const double valuation_times[] = {0, 0.5, 3.3, 24.9};
+    for ( int m = 0; m < 2; ++m ) {
+        const financial::YieldCurve curve =
+            financial::YieldCurve::from_zero_rates(pillar_times(),
+                                                   upward_zeros(),
+                                                   interpolations[m]);
+        for ( int v = 0; v < 4; ++v ) {
+            const double vt = valuation_times[v];
+            double expected_result = 0;
+            for ( std::size_t i = 0; i < sched.size(); ++i ) {
+                if ( sched[i].time_period > vt ) {
+                    expected_result += sched[i].amount *
+                        curve.discount_factor(sched[i].time_period - vt);
+                }
+            }
+            BOOST_CHECK_CLOSE(expected_result,
+                              financial::pv_stream_at(sched, curve, vt),
+                              tolerance);
+            BOOST_CHECK_CLOSE(expected_result, bond.dirty_price(curve, vt),
+                              tolerance);
+        }
+        BOOST_CHECK_CLOSE(bond.value(curve), bond.dirty_price(curve, 0),
+                          tolerance);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(yield_curve_test5) {
+    const std::vector<double> none;
+    const std::vector<double> times = {1, 2, 3};
+    const std::vector<double> unordered = {1, 3, 2};
+    const std::vector<double> dfs = {0.95, 0.9, 0.85};
+    const std::vector<double> bad_dfs = {0.95, 0, 0.85};
+    BOOST_CHECK_THROW(financial::YieldCurve(none, none), std::domain_error);
+    BOOST_CHECK_THROW(financial::YieldCurve(times, none), std::domain_error);
+    BOOST_CHECK_THROW(financial::YieldCurve(unordered, dfs),
+                      std::domain_error);
+    BOOST_CHECK_THROW(financial::YieldCurve(times, bad_dfs),
+                      std::domain_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,229 @@
+/*!
+ * \file        thread_pool.cpp
+ * \brief       Work-stealing thread pool implementation.
+ * \details     Work-stealing thread pool implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+#include "thread_pool.h"
+
+using namespace financial;
+
+namespace {
+
+//! The pool whose tasks the current thread is running, if any.
+
+thread_local const ThreadPool * running_pool = 0;
+
+//! Marks the current thread as running a pool's tasks.
+
+class RunningPool {
+    public:
+        explicit RunningPool(const ThreadPool * pool) :
+            m_previous(running_pool) {
+            running_pool = pool;
+        }
+
+        ~RunningPool() { running_pool = m_previous; }
+
+    private:
+        const ThreadPool * m_previous;
+
+        RunningPool(const RunningPool&);
+        RunningPool& operator=(const RunningPool&);
+};
+
+}           //  namespace
+
+ThreadPool::ThreadPool(const unsigned num_threads) :
+    m_num_threads(num_threads ? num_threads :
+                  std::thread::hardware_concurrency()),
+    m_workers(),
+    m_ranges(),
+    m_run_mutex(),
+    m_mutex(),
+    m_work_cv(),
+    m_done_cv(),
+    m_task(0),
+    m_generation(0),
+    m_active(0),
+    m_stop(false),
+    m_error() {
+    if ( m_num_threads == 0 ) {
+        m_num_threads = 1;
+    }
+
+    for ( unsigned i = 0; i < m_num_threads; ++i ) {
+        m_ranges.push_back(std::unique_ptr<TaskRange>(new TaskRange()));
+    }
+    for ( unsigned i = 1; i < m_num_threads; ++i ) {
+        m_workers.push_back(std::thread(&ThreadPool::worker_main, this, i));
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_cv.notify_all();
+    for ( std::size_t i = 0; i < m_workers.size(); ++i ) {
+        m_workers[i].join();
+    }
+}
+
+void ThreadPool::parallel_for(const std::size_t num_tasks,
+                              const std::function<void(std::size_t)>& task) {
+    if ( num_tasks == 0 ) {
+        return;
+    }
+
+    //  A task calling back into its own pool would wait forever for the
+    //  call running it to finish, so runs its tasks itself.
+
+    if ( running_pool == this ) {
+        run_inline(num_tasks, task);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run_lock(m_run_mutex);
+
+    //  Give each thread an equal contiguous range of the tasks.
+
+    for ( unsigned i = 0; i < m_num_threads; ++i ) {
+        TaskRange& range = *m_ranges[i];
+        std::lock_guard<std::mutex> range_lock(range.mutex);
+        range.begin = num_tasks * i / m_num_threads;
+        range.end = num_tasks * (i + 1) / m_num_threads;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_task = &task;
+        m_error = std::exception_ptr();
+        m_active = m_num_threads - 1;
+        ++m_generation;
+    }
+    m_work_cv.notify_all();
+
+    run_tasks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while ( m_active ) {
+            m_done_cv.wait(lock);
+        }
+        m_task = 0;
+        error = m_error;
+    }
+
+    if ( error ) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::run_inline(const std::size_t num_tasks,
+                            const std::function<void(std::size_t)>& task) {
+    std::exception_ptr error;
+    for ( std::size_t i = 0; i < num_tasks; ++i ) {
+        try {
+            task(i);
+        } catch ( ... ) {
+            if ( !error ) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if ( error ) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::worker_main(const unsigned index) {
+    std::size_t seen_generation = 0;
+
+    while ( true ) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while ( !m_stop && m_generation == seen_generation ) {
+                m_work_cv.wait(lock);
+            }
+            if ( m_stop ) {
+                return;
+            }
+            seen_generation = m_generation;
+        }
+
+        run_tasks(index);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( --m_active == 0 ) {
+                m_done_cv.notify_all();
+            }
+        }
+    }
+}
+
+void ThreadPool::run_tasks(const unsigned index) {
+    const RunningPool running(this);
+    std::size_t task;
+    while ( take_task(index, task) || (steal_tasks(index) &&
+                                       take_task(index, task)) ) {
+        try {
+            (*m_task)(task);
+        } catch ( ... ) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if ( !m_error ) {
+                m_error = std::current_exception();
+            }
+        }
+    }
+}
+
+bool ThreadPool::take_task(const unsigned index, std::size_t& task) {
+    TaskRange& range = *m_ranges[index];
+    std::lock_guard<std::mutex> lock(range.mutex);
+    if ( range.begin < range.end ) {
+        task = range.begin++;
+        return true;
+    } else {
+        return false;
+    }
+}
+
+bool ThreadPool::steal_tasks(const unsigned index) {
+    for ( unsigned offset = 1; offset < m_num_threads; ++offset ) {
+        TaskRange& victim = *m_ranges[(index + offset) % m_num_threads];
+        std::size_t begin = 0;
+        std::size_t end = 0;
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if ( victim.begin < victim.end ) {
+                const std::size_t remaining = victim.end - victim.begin;
+                begin = victim.end - (remaining + 1) / 2;
+                end = victim.end;
+                victim.end = begin;
+            }
+        }
+
+        if ( begin < end ) {
+            TaskRange& range = *m_ranges[index];
+            std::lock_guard<std::mutex> lock(range.mutex);
+            range.begin = begin;
+            range.end = end;
+            return true;
+        }
+    }
+    return false;
+}
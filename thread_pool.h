@@ -0,0 +1,180 @@
+/*!
+ * \file        thread_pool.h
+ * \brief       Work-stealing thread pool interface.
+ * \details     Work-stealing thread pool interface.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_THREAD_POOL_H
+#define PG_FINANCIAL_THREAD_POOL_H
+
+#include <cstddef>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+#include <memory>
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Work-stealing thread pool class.
+
+/*!
+ * Runs numbered tasks in parallel on a fixed set of worker threads.
+ * Each call to `parallel_for()` divides its tasks into one contiguous
+ * range per thread. A thread which runs out of tasks steals the back
+ * half of the remaining range of another thread, so uneven tasks are
+ * balanced without a shared queue. The calling thread takes part in
+ * running the tasks. A task may itself call `parallel_for()` on the
+ * same pool, and the nested tasks then run in turn on the thread which
+ * called it.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * financial::ThreadPool pool;
+ * std::vector<double> results(1000);
+ * pool.parallel_for(results.size(), [&](std::size_t i) {
+ *     results[i] = financial::discount_factor(0.05, i);
+ * });
+ * ~~~~
+ */
+
+class ThreadPool {
+    public:
+
+        //! Constructor
+
+        /*!
+         * Starts the worker threads.
+         *
+         * \param num_threads the total number of threads to run tasks
+         * on, including the calling thread. If zero, the number of
+         * hardware threads is used.
+         */
+
+        explicit ThreadPool(const unsigned num_threads = 0);
+
+
+        //! Destructor
+
+        /*!
+         * Stops and joins the worker threads.
+         */
+
+        ~ThreadPool();
+
+
+        //! Returns the number of threads which run tasks.
+
+        /*!
+         * \return the number of threads which run tasks, including the
+         * calling thread.
+         */
+
+        unsigned size() const { return m_num_threads; }
+
+
+        //! Runs a number of tasks in parallel.
+
+        /*!
+         * Calls `task(i)` once for each `i` in `[0, num_tasks)`, and
+         * returns when all the calls have completed. The order in which
+         * the tasks run, and the threads they run on, are unspecified.
+         * Calls from several threads are run one at a time. A call
+         * from within a task running on this pool runs its tasks in
+         * turn on the calling thread, rather than waiting for the
+         * call which is running that task. Calls which cycle between
+         * two pools, with a task on each calling into the other, are
+         * not detected, and may deadlock.
+         *
+         * \param num_tasks the number of tasks.
+         * \param task the function to call for each task.
+         * \throws any exception thrown by a task. If more than one task
+         * throws, one of the exceptions is rethrown after all the tasks
+         * have completed.
+         */
+
+        void parallel_for(const std::size_t num_tasks,
+                          const std::function<void(std::size_t)>& task);
+
+
+    private:
+
+        //! A range of tasks owned by one thread.
+
+        struct TaskRange {
+            TaskRange() : mutex(), begin(0), end(0) {}
+            std::mutex mutex;   /*!< guards the range */
+            std::size_t begin;  /*!< the next task to run */
+            std::size_t end;    /*!< one past the last task to run */
+        };
+
+        ThreadPool(const ThreadPool&);
+        ThreadPool& operator=(const ThreadPool&);
+
+        //! Runs tasks in turn on the calling thread.
+        void run_inline(const std::size_t num_tasks,
+                        const std::function<void(std::size_t)>& task);
+
+        //! Main function of each worker thread.
+        void worker_main(const unsigned index);
+
+        //! Runs tasks, stealing from other threads, until none remain.
+        void run_tasks(const unsigned index);
+
+        //! Takes the next task from a thread's own range.
+        bool take_task(const unsigned index, std::size_t& task);
+
+        //! Steals half of another thread's range.
+        bool steal_tasks(const unsigned index);
+
+        unsigned m_num_threads;                 /*!< total threads */
+        std::vector<std::thread> m_workers;     /*!< worker threads */
+        std::vector<std::unique_ptr<TaskRange> > m_ranges;  /*!< ranges */
+
+        std::mutex m_run_mutex;         /*!< serializes parallel_for() */
+        std::mutex m_mutex;             /*!< guards the state below */
+        std::condition_variable m_work_cv;  /*!< signals new work */
+        std::condition_variable m_done_cv;  /*!< signals completion */
+        const std::function<void(std::size_t)> * m_task;    /*!< task */
+        std::size_t m_generation;       /*!< number of parallel_for()s */
+        unsigned m_active;              /*!< workers running tasks */
+        bool m_stop;                    /*!< workers should exit */
+        std::exception_ptr m_error;     /*!< first exception thrown */
+};
+
+
+//! Runs a function for each chunk, on a thread pool if one is given.
+
+/*!
+ * Runs the chunks with `parallel_for()` if the pool has more than one
+ * thread, and otherwise calls the function for each chunk in turn on
+ * the calling thread, with no call through a `std::function`.
+ *
+ * \param pool the thread pool, or a null pointer.
+ * \param num_chunks the number of chunks.
+ * \param function the function to call for each chunk.
+ */
+
+template <class Function>
+void for_each_chunk(ThreadPool * pool, const std::size_t num_chunks,
+                    const Function& function) {
+    if ( pool && pool->size() > 1 ) {
+        pool->parallel_for(num_chunks, function);
+    } else {
+        for ( std::size_t i = 0; i < num_chunks; ++i ) {
+            function(i);
+        }
+    }
+}
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_THREAD_POOL_H
@@ -0,0 +1,244 @@
+/*!
+ * \file        yield_curve.cpp
+ * \brief       Yield curve implementation.
+ * \details     Yield curve implementation.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#include <cstddef>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "cashflow_schedule.h"
+#include "pv_kernels.h"
+#include "yield_curve.h"
+#include "instrumentation.h"
+
+using namespace financial;
+
+namespace {
+
+//! Number of cash flows for which the curve is evaluated at a time.
+
+const std::size_t curve_block_size = 256;
+
+//! Checks that pillar times and values are consistent.
+
+void check_pillars(const std::vector<double>& times,
+                   const std::vector<double>& values) {
+    if ( times.empty() ) {
+        throw std::domain_error("Yield curve must have at least one pillar");
+    }
+    if ( times.size() != values.size() ) {
+        throw std::domain_error("Yield curve pillar vectors differ in size");
+    }
+    double previous = 0;
+    for ( std::size_t i = 0; i < times.size(); ++i ) {
+        if ( !(times[i] > previous) ) {
+            throw std::domain_error("Yield curve pillar times must be "
+                                    "positive and strictly increasing");
+        }
+        previous = times[i];
+    }
+}
+
+//! Discounts cash flows on a curve whose time zero is `time_offset`.
+
+double discount_on_curve(const CashFlowView& cashflows,
+                         const YieldCurve& curve,
+                         const double time_offset) {
+    const double * amounts = cashflows.amounts();
+    const double * times = cashflows.times();
+    double log_discounts[curve_block_size];
+
+    //  The kernels calculate amount * exp(-t * log_growth), so passing
+    //  -log(DF) as the time with a unit log growth gives amount * DF.
+
+    double pv_total = 0;
+    for ( std::size_t begin = 0; begin < cashflows.size();
+          begin += curve_block_size ) {
+        const std::size_t remaining = cashflows.size() - begin;
+        const std::size_t n = remaining < curve_block_size ?
+                              remaining : curve_block_size;
+        for ( std::size_t i = 0; i < n; ++i ) {
+            log_discounts[i] = curve.log_discount(times[begin + i] -
+                                                  time_offset);
+        }
+        pv_total += detail::pv_sum(amounts + begin, log_discounts, n, 1.0);
+    }
+    return pv_total;
+}
+
+}           //  namespace
+
+YieldCurve::YieldCurve(const std::vector<double>& times,
+                       const std::vector<double>& discount_factors,
+                       const curve_interpolation interpolation) :
+    m_interpolation(interpolation),
+    m_pillar_dfs(discount_factors),
+    m_starts(),
+    m_segments() {
+    check_pillars(times, discount_factors);
+
+    std::vector<double> log_dfs(discount_factors.size());
+    for ( std::size_t i = 0; i < discount_factors.size(); ++i ) {
+        if ( !(discount_factors[i] > 0) ) {
+            throw std::domain_error("Yield curve discount factors must be "
+                                    "positive");
+        }
+        log_dfs[i] = -std::log(discount_factors[i]);
+    }
+    build_segments(times, log_dfs);
+}
+
+YieldCurve YieldCurve::from_zero_rates(const std::vector<double>& times,
+                                       const std::vector<double>& zero_rates,
+                                       const curve_interpolation
+                                       interpolation,
+                                       const enum disc_type dt) {
+    check_pillars(times, zero_rates);
+
+    std::vector<double> dfs(times.size());
+    for ( std::size_t i = 0; i < times.size(); ++i ) {
+        const double log_growth = ( dt == disc_type::continuous ) ?
+                                  zero_rates[i] : std::log1p(zero_rates[i]);
+        dfs[i] = std::exp(-times[i] * log_growth);
+    }
+    return YieldCurve(times, dfs, interpolation);
+}
+
+void YieldCurve::build_segments(const std::vector<double>& times,
+                                const std::vector<double>& log_dfs) {
+    const std::size_t n = times.size();
+
+    //  Knots, including the implied pillar at time zero.
+
+    std::vector<double> t(n + 1);
+    std::vector<double> y(n + 1);
+    t[0] = 0;
+    y[0] = 0;
+    for ( std::size_t i = 0; i < n; ++i ) {
+        t[i + 1] = times[i];
+        y[i + 1] = log_dfs[i];
+    }
+
+    //  Secant slopes, which are the forward rates of the log-linear
+    //  method, and the slopes at the knots.
+
+    std::vector<double> secants(n);
+    for ( std::size_t k = 0; k < n; ++k ) {
+        secants[k] = (y[k + 1] - y[k]) / (t[k + 1] - t[k]);
+    }
+
+    std::vector<double> slopes(n + 1);
+    if ( m_interpolation == curve_interpolation::monotone_cubic ) {
+
+        //  Fritsch-Carlson: start from the average of adjacent secants,
+        //  with zero slope at local extrema, then limit the slopes in
+        //  each segment so the interpolant is monotone there.
+
+        slopes[0] = secants[0];
+        slopes[n] = secants[n - 1];
+        for ( std::size_t k = 1; k < n; ++k ) {
+            slopes[k] = ( secants[k - 1] * secants[k] > 0 ) ?
+                        (secants[k - 1] + secants[k]) / 2 : 0;
+        }
+        for ( std::size_t k = 0; k < n; ++k ) {
+            if ( secants[k] == 0 ) {
+                slopes[k] = 0;
+                slopes[k + 1] = 0;
+                continue;
+            }
+            const double alpha = slopes[k] / secants[k];
+            const double beta = slopes[k + 1] / secants[k];
+            const double norm = alpha * alpha + beta * beta;
+            if ( norm > 9 ) {
+                const double tau = 3 / std::sqrt(norm);
+                slopes[k] = tau * alpha * secants[k];
+                slopes[k + 1] = tau * beta * secants[k];
+            }
+        }
+    } else {
+        for ( std::size_t k = 0; k < n; ++k ) {
+            slopes[k] = secants[k];
+        }
+        slopes[n] = secants[n - 1];
+    }
+
+    m_starts.resize(n + 1);
+    m_segments.resize(n + 1);
+    for ( std::size_t k = 0; k < n; ++k ) {
+        const double h = t[k + 1] - t[k];
+        Segment& seg = m_segments[k];
+        seg.start = t[k];
+        seg.a = y[k];
+        if ( m_interpolation == curve_interpolation::monotone_cubic ) {
+            seg.b = slopes[k];
+            seg.c = (3 * secants[k] - 2 * slopes[k] - slopes[k + 1]) / h;
+            seg.d = (slopes[k] + slopes[k + 1] - 2 * secants[k]) / (h * h);
+        } else {
+            seg.b = secants[k];
+            seg.c = 0;
+            seg.d = 0;
+        }
+        m_starts[k] = t[k];
+    }
+
+    //  Flat forward extrapolation beyond the last pillar.
+
+    Segment& last = m_segments[n];
+    last.start = t[n];
+    last.a = y[n];
+    last.b = slopes[n];
+    last.c = 0;
+    last.d = 0;
+    m_starts[n] = t[n];
+}
+
+double YieldCurve::discount_factor(const double time_period) const {
+    return std::exp(-log_discount(time_period));
+}
+
+double YieldCurve::zero_rate(const double time_period,
+                             const enum disc_type dt) const {
+    const double log_growth = ( time_period == 0 ) ? m_segments[0].b :
+                              log_discount(time_period) / time_period;
+    return ( dt == disc_type::continuous ) ? log_growth :
+                                             std::expm1(log_growth);
+}
+
+void YieldCurve::discount_factors(const double * times,
+                                  const std::size_t num_times,
+                                  double * discount_factors) const {
+    for ( std::size_t i = 0; i < num_times; ++i ) {
+        discount_factors[i] = std::exp(-log_discount(times[i]));
+    }
+}
+
+double financial::pv_stream(const CashFlowView& cashflows,
+                            const YieldCurve& curve) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    return discount_on_curve(cashflows, curve, 0);
+}
+
+double financial::pv_stream_at(const CashFlowView& cashflows,
+                               const YieldCurve& curve,
+                               const double valuation_time) {
+    const CashFlowView remaining = cashflows.after(valuation_time);
+    PG_FINANCIAL_PROBE(pv_stream, remaining.size());
+    return discount_on_curve(remaining, curve, valuation_time);
+}
+
+double financial::pv_stream(const std::vector<TimedCashFlow>& cashflows,
+                            const YieldCurve& curve) {
+    PG_FINANCIAL_PROBE(pv_stream, cashflows.size());
+    double pv_total = 0;
+    for ( std::vector<TimedCashFlow>::const_iterator itr = cashflows.begin();
+            itr != cashflows.end(); ++itr ) {
+        const TimedCashFlow& cf = *itr;
+        pv_total += cf.amount * curve.discount_factor(cf.time_period);
+    }
+    return pv_total;
+}
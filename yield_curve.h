@@ -0,0 +1,276 @@
+/*!
+ * \file        yield_curve.h
+ * \brief       Yield curve interface.
+ * \details     Yield curve interface, and functions for discounting
+ * cash flows against a term structure of interest rates.
+ * \author      Paul Griffiths
+ * \copyright   Copyright 2013 Paul Griffiths. Distributed under the terms
+ * of the GNU General Public License. <http://www.gnu.org/licenses/>
+ */
+
+#ifndef PG_FINANCIAL_YIELD_CURVE_H
+#define PG_FINANCIAL_YIELD_CURVE_H
+
+#include <cstddef>
+#include <vector>
+#include "common_financial_types.h"
+#include "cashflow_schedule.h"
+
+//! User library namespace
+
+namespace financial {
+
+
+//! Enumeration type for yield curve interpolation methods.
+
+enum class curve_interpolation {
+    log_linear,         /*!< linear in the log of the discount factor */
+    monotone_cubic      /*!< monotone cubic in the log of the discount
+                             factor */
+};
+
+
+//! Yield curve class.
+
+/*!
+ * Holds a term structure of interest rates as discount factors at a set
+ * of pillar times, measured in periods, and interpolates between them.
+ *
+ * Interpolation is done on `-log(DF(t))`, the integral of the
+ * instantaneous forward rate up to time `t`. Log-linear interpolation
+ * gives piecewise flat forward rates. Monotone cubic interpolation uses
+ * the Fritsch-Carlson method to give continuous forward rates without
+ * introducing oscillations between pillars. A pillar at time zero with
+ * a discount factor of one is implied. Beyond the last pillar, the
+ * forward rate at the last pillar is extended flat, and before time
+ * zero the first segment is extended.
+ *
+ * Both methods are stored as one cubic polynomial per segment between
+ * pillars, with the log-linear method having zero higher coefficients,
+ * so a lookup is a branch-free binary search over a contiguous array of
+ * pillar times followed by the evaluation of one polynomial whose
+ * coefficients are stored together.
+ *
+ * Sample usage:
+ * ~~~~{.cpp}
+ * std::vector<double> times = {0.5, 1, 2, 5, 10, 30};
+ * std::vector<double> zeros = {0.031, 0.033, 0.036, 0.04, 0.043, 0.045};
+ * const financial::YieldCurve curve =
+ *     financial::YieldCurve::from_zero_rates(times, zeros,
+ *         financial::curve_interpolation::monotone_cubic);
+ * double pval = financial::pv_stream(sched, curve);
+ * ~~~~
+ */
+
+class YieldCurve {
+    public:
+
+        //! Constructor
+
+        /*!
+         * Creates a curve from discount factors at pillar times.
+         *
+         * \param times the pillar times, in periods, which must be
+         * positive and strictly increasing.
+         * \param discount_factors the discount factor at each pillar,
+         * which must be positive.
+         * \param interpolation the interpolation method to use.
+         * \throws std::domain_error if there are no pillars, the
+         * vectors differ in length, or any pillar is invalid.
+         */
+
+        explicit YieldCurve(const std::vector<double>& times,
+                            const std::vector<double>& discount_factors,
+                            const curve_interpolation interpolation =
+                                curve_interpolation::log_linear);
+
+
+        //! Creates a curve from zero rates at pillar times.
+
+        /*!
+         * \param times the pillar times, in periods, which must be
+         * positive and strictly increasing.
+         * \param zero_rates the periodic zero rate at each pillar.
+         * \param interpolation the interpolation method to use.
+         * \param dt the type of compounding of the zero rates.
+         * \return the curve.
+         * \throws std::domain_error as for the constructor.
+         */
+
+        static YieldCurve from_zero_rates(const std::vector<double>& times,
+                                          const std::vector<double>&
+                                          zero_rates,
+                                          const curve_interpolation
+                                          interpolation =
+                                          curve_interpolation::log_linear,
+                                          const enum disc_type dt =
+                                          disc_type::discrete);
+
+
+        //! Returns the number of pillars.
+
+        std::size_t size() const { return m_pillar_dfs.size(); }
+
+
+        //! Returns the interpolation method.
+
+        curve_interpolation interpolation() const { return m_interpolation; }
+
+
+        //! Returns the time of a pillar.
+
+        double pillar_time(const std::size_t index) const {
+            return m_starts[index + 1];
+        }
+
+
+        //! Returns the discount factor at a pillar.
+
+        double pillar_discount_factor(const std::size_t index) const {
+            return m_pillar_dfs[index];
+        }
+
+
+        //! Returns the discount factor for a time.
+
+        /*!
+         * \param time_period the time, in periods.
+         * \return the interpolated discount factor.
+         */
+
+        double discount_factor(const double time_period) const;
+
+
+        //! Returns the zero rate for a time.
+
+        /*!
+         * \param time_period the time, in periods.
+         * \param dt the type of compounding of the returned rate.
+         * \return the periodic zero rate to `time_period`, or the
+         * instantaneous forward rate at time zero if `time_period` is
+         * zero.
+         */
+
+        double zero_rate(const double time_period,
+                         const enum disc_type dt = disc_type::discrete) const;
+
+
+        //! Returns `-log` of the discount factor for a time.
+
+        /*!
+         * \param time_period the time, in periods.
+         * \return the interpolated value of `-log(DF(time_period))`.
+         */
+
+        double log_discount(const double time_period) const {
+            const Segment& seg = m_segments[find_segment(time_period)];
+            const double h = time_period - seg.start;
+            return seg.a + h * (seg.b + h * (seg.c + h * seg.d));
+        }
+
+
+        //! Returns the discount factors for an array of times.
+
+        /*!
+         * \param times an array of `num_times` times, in periods.
+         * \param num_times the number of times.
+         * \param discount_factors an array of `num_times` doubles to
+         * receive the discount factors.
+         */
+
+        void discount_factors(const double * times,
+                              const std::size_t num_times,
+                              double * discount_factors) const;
+
+
+    private:
+
+        //! Interpolating polynomial for one segment.
+
+        /*!
+         * `-log(DF(t)) = a + b*h + c*h^2 + d*h^3`, where `h = t - start`.
+         */
+
+        struct Segment {
+            double start;       /*!< the start of the segment */
+            double a;           /*!< constant coefficient */
+            double b;           /*!< linear coefficient */
+            double c;           /*!< quadratic coefficient */
+            double d;           /*!< cubic coefficient */
+        };
+
+        //! Builds the segments from the pillars.
+        void build_segments(const std::vector<double>& times,
+                            const std::vector<double>& log_dfs);
+
+        //! Returns the index of the segment containing a time.
+        std::size_t find_segment(const double time_period) const {
+            const double * base = m_starts.data();
+            const double * first = base;
+            std::size_t len = m_starts.size();
+            while ( len > 1 ) {
+                const std::size_t half = len / 2;
+                first = ( first[half] <= time_period ) ? first + half : first;
+                len -= half;
+            }
+            return first - base;
+        }
+
+        curve_interpolation m_interpolation;    /*!< interpolation method */
+        std::vector<double> m_pillar_dfs;       /*!< pillar discount factors */
+        std::vector<double> m_starts;           /*!< segment start times */
+        std::vector<Segment> m_segments;        /*!< segment polynomials */
+};
+
+
+//! Calculates the present value of cash flows against a yield curve.
+
+/*!
+ * Discounts each cash flow at the curve's discount factor for its time,
+ * in a single pass. The curve is evaluated for a block of cash flows at
+ * a time, and each block is discounted with the same SIMD kernels as
+ * the flat rate `pv_stream()` overloads.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param curve the yield curve to discount against.
+ * \return the present value of the cash flows.
+ */
+
+double pv_stream(const CashFlowView& cashflows, const YieldCurve& curve);
+
+
+//! Calculates the value of remaining cash flows against a yield curve.
+
+/*!
+ * As the flat rate `pv_stream_at()`: discounts the cash flows after
+ * `valuation_time` at the curve's discount factors for their times
+ * after `valuation_time`, the curve being taken as that at the time of
+ * valuation. No memory is allocated, and the cash flows must be in
+ * order of time.
+ *
+ * \param cashflows the cash flows, as a schedule or a view.
+ * \param curve the yield curve at `valuation_time`.
+ * \param valuation_time the time, in periods, at which to value the
+ * cash flows.
+ * \return the value at `valuation_time` of the cash flows after it.
+ */
+
+double pv_stream_at(const CashFlowView& cashflows, const YieldCurve& curve,
+                    const double valuation_time);
+
+
+//! Calculates the present value of cash flows against a yield curve.
+
+/*!
+ * \param cashflows a std::vector of TimedCashFlow structs
+ * representing the stream of cash flows.
+ * \param curve the yield curve to discount against.
+ * \return the present value of the cash flows.
+ */
+
+double pv_stream(const std::vector<TimedCashFlow>& cashflows,
+                 const YieldCurve& curve);
+
+}               //  namespace financial
+
+#endif          //  PG_FINANCIAL_YIELD_CURVE_H